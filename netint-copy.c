@@ -0,0 +1,845 @@
+/**
+ * @file netint-copy.c
+ * @brief Host-side plane copy kernels for NETINT T4XX frame uploads
+ *
+ * See netint-copy.h for the layout contract. These routines are called from
+ * the OBS encode thread for every frame, so they avoid any allocation and
+ * touch each destination byte exactly once.
+ *
+ * The SIMD variants are compiled into this file with per-function target
+ * attributes, so the plugin itself still builds for the baseline ISA and only
+ * runs AVX2 code on CPUs that report it.
+ */
+
+#include "netint-copy.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NETINT_COPY_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NETINT_TARGET_SSE2
+#define NETINT_TARGET_AVX2
+#else
+#define NETINT_TARGET_SSE2 __attribute__((target("sse2")))
+#define NETINT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define NETINT_COPY_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* Shared helpers                                                            */
+
+/**
+ * @brief Clamp copy dimensions to the destination plane
+ *
+ * @return false if the destination is unusable and nothing should be written
+ */
+static inline bool netint_copy_clamp(const uint8_t *dst, int dst_stride, int dst_height,
+                                     int *width, int *height)
+{
+    if (!dst || dst_stride <= 0 || dst_height <= 0) {
+        return false;
+    }
+    if (*width > dst_stride) {
+        *width = dst_stride;
+    }
+    if (*width < 0) {
+        *width = 0;
+    }
+    if (*height > dst_height) {
+        *height = dst_height;
+    }
+    if (*height < 0) {
+        *height = 0;
+    }
+    return true;
+}
+
+/* Bottom padding rows are contiguous in the destination - clear them in one go */
+static inline void netint_copy_clear_rows(uint8_t *dst, int dst_stride, int first_row, int dst_height)
+{
+    if (first_row < dst_height) {
+        memset(dst + (size_t)first_row * (size_t)dst_stride, 0,
+               (size_t)(dst_height - first_row) * (size_t)dst_stride);
+    }
+}
+
+/* Right padding of one row, from byte offset 'from' to the end of the stride */
+static inline void netint_copy_zero_tail(uint8_t *row, int from, int dst_stride)
+{
+    if (from < dst_stride) {
+        memset(row + from, 0, (size_t)(dst_stride - from));
+    }
+}
+
+/* 16-bit kernels take widths in samples; clamp in bytes against the stride */
+static inline bool netint_copy_clamp16(const uint8_t *dst, int dst_stride, int dst_height,
+                                       int *width, int *height)
+{
+    int width_bytes = *width * 2;
+    if (!netint_copy_clamp(dst, dst_stride, dst_height, &width_bytes, height)) {
+        return false;
+    }
+    *width = width_bytes / 2;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Portable C                                                                */
+
+static void netint_copy_plane_c(uint8_t *dst, int dst_stride, int dst_height,
+                                const uint8_t *src, int src_stride,
+                                int width_bytes, int height)
+{
+    if (!netint_copy_clamp(dst, dst_stride, dst_height, &width_bytes, &height)) {
+        return;
+    }
+
+    const size_t pad = (size_t)(dst_stride - width_bytes);
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            uint8_t *d = dst + (size_t)y * (size_t)dst_stride;
+            memcpy(d, src + (size_t)y * (size_t)src_stride, (size_t)width_bytes);
+            if (pad) {
+                memset(d + width_bytes, 0, pad);
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+static void netint_deinterleave_uv_c(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                     const uint8_t *src, int src_stride,
+                                     int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    const size_t pad = (size_t)(dst_stride - chroma_width);
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *u = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v = dst_v + (size_t)y * (size_t)dst_stride;
+
+            for (int x = 0; x < chroma_width; x++) {
+                u[x] = s[2 * x];
+                v[x] = s[2 * x + 1];
+            }
+
+            if (pad) {
+                memset(u + chroma_width, 0, pad);
+                memset(v + chroma_width, 0, pad);
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+static void netint_copy_plane_p010_c(uint8_t *dst, int dst_stride, int dst_height,
+                                     const uint8_t *src, int src_stride,
+                                     int width, int height)
+{
+    if (!netint_copy_clamp16(dst, dst_stride, dst_height, &width, &height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *row = dst + (size_t)y * (size_t)dst_stride;
+            uint16_t *d = (uint16_t *)row;
+
+            for (int x = 0; x < width; x++) {
+                d[x] = (uint16_t)(s[x] >> 6);
+            }
+            netint_copy_zero_tail(row, width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+static void netint_deinterleave_uv_p010_c(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                          const uint8_t *src, int src_stride,
+                                          int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp16(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *u_row = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v_row = dst_v + (size_t)y * (size_t)dst_stride;
+            uint16_t *u = (uint16_t *)u_row;
+            uint16_t *v = (uint16_t *)v_row;
+
+            for (int x = 0; x < chroma_width; x++) {
+                u[x] = (uint16_t)(s[2 * x] >> 6);
+                v[x] = (uint16_t)(s[2 * x + 1] >> 6);
+            }
+            netint_copy_zero_tail(u_row, chroma_width * 2, dst_stride);
+            netint_copy_zero_tail(v_row, chroma_width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+static const struct netint_copy_kernels netint_copy_kernels_c = {
+    "c",
+    netint_copy_plane_c,
+    netint_deinterleave_uv_c,
+    netint_copy_plane_p010_c,
+    netint_deinterleave_uv_p010_c,
+};
+
+/* ------------------------------------------------------------------------- */
+/* x86: SSE2 / AVX2                                                          */
+
+#ifdef NETINT_COPY_X86
+
+NETINT_TARGET_SSE2
+static void netint_copy_plane_sse2(uint8_t *dst, int dst_stride, int dst_height,
+                                   const uint8_t *src, int src_stride,
+                                   int width_bytes, int height)
+{
+    if (!netint_copy_clamp(dst, dst_stride, dst_height, &width_bytes, &height)) {
+        return;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *d = dst + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            for (; x + 64 <= width_bytes; x += 64) {
+                __m128i a = _mm_loadu_si128((const __m128i *)(s + x));
+                __m128i b = _mm_loadu_si128((const __m128i *)(s + x + 16));
+                __m128i c = _mm_loadu_si128((const __m128i *)(s + x + 32));
+                __m128i e = _mm_loadu_si128((const __m128i *)(s + x + 48));
+                _mm_storeu_si128((__m128i *)(d + x), a);
+                _mm_storeu_si128((__m128i *)(d + x + 16), b);
+                _mm_storeu_si128((__m128i *)(d + x + 32), c);
+                _mm_storeu_si128((__m128i *)(d + x + 48), e);
+            }
+            for (; x + 16 <= width_bytes; x += 16) {
+                _mm_storeu_si128((__m128i *)(d + x), _mm_loadu_si128((const __m128i *)(s + x)));
+            }
+            if (x < width_bytes) {
+                memcpy(d + x, s + x, (size_t)(width_bytes - x));
+                x = width_bytes;
+            }
+
+            /* Right padding, written while the row is still hot */
+            for (; x + 16 <= dst_stride; x += 16) {
+                _mm_storeu_si128((__m128i *)(d + x), zero);
+            }
+            if (x < dst_stride) {
+                memset(d + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_SSE2
+static void netint_deinterleave_uv_sse2(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo_mask = _mm_set1_epi16(0x00FF);
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *u = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v = dst_v + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            /* 16 UV pairs per iteration: even bytes are U, odd bytes are V */
+            for (; x + 16 <= chroma_width; x += 16) {
+                __m128i a = _mm_loadu_si128((const __m128i *)(s + 2 * x));
+                __m128i b = _mm_loadu_si128((const __m128i *)(s + 2 * x + 16));
+                __m128i ua = _mm_and_si128(a, lo_mask);
+                __m128i ub = _mm_and_si128(b, lo_mask);
+                __m128i va = _mm_srli_epi16(a, 8);
+                __m128i vb = _mm_srli_epi16(b, 8);
+                _mm_storeu_si128((__m128i *)(u + x), _mm_packus_epi16(ua, ub));
+                _mm_storeu_si128((__m128i *)(v + x), _mm_packus_epi16(va, vb));
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = s[2 * x];
+                v[x] = s[2 * x + 1];
+            }
+
+            for (; x + 16 <= dst_stride; x += 16) {
+                _mm_storeu_si128((__m128i *)(u + x), zero);
+                _mm_storeu_si128((__m128i *)(v + x), zero);
+            }
+            if (x < dst_stride) {
+                memset(u + x, 0, (size_t)(dst_stride - x));
+                memset(v + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_AVX2
+static void netint_copy_plane_avx2(uint8_t *dst, int dst_stride, int dst_height,
+                                   const uint8_t *src, int src_stride,
+                                   int width_bytes, int height)
+{
+    if (!netint_copy_clamp(dst, dst_stride, dst_height, &width_bytes, &height)) {
+        return;
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *d = dst + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            for (; x + 128 <= width_bytes; x += 128) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(s + x));
+                __m256i b = _mm256_loadu_si256((const __m256i *)(s + x + 32));
+                __m256i c = _mm256_loadu_si256((const __m256i *)(s + x + 64));
+                __m256i e = _mm256_loadu_si256((const __m256i *)(s + x + 96));
+                _mm256_storeu_si256((__m256i *)(d + x), a);
+                _mm256_storeu_si256((__m256i *)(d + x + 32), b);
+                _mm256_storeu_si256((__m256i *)(d + x + 64), c);
+                _mm256_storeu_si256((__m256i *)(d + x + 96), e);
+            }
+            for (; x + 32 <= width_bytes; x += 32) {
+                _mm256_storeu_si256((__m256i *)(d + x), _mm256_loadu_si256((const __m256i *)(s + x)));
+            }
+            if (x < width_bytes) {
+                memcpy(d + x, s + x, (size_t)(width_bytes - x));
+                x = width_bytes;
+            }
+
+            for (; x + 32 <= dst_stride; x += 32) {
+                _mm256_storeu_si256((__m256i *)(d + x), zero);
+            }
+            if (x < dst_stride) {
+                memset(d + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    _mm256_zeroupper();
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_AVX2
+static void netint_deinterleave_uv_avx2(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo_mask = _mm256_set1_epi16(0x00FF);
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *u = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v = dst_v + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            for (; x + 32 <= chroma_width; x += 32) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(s + 2 * x));
+                __m256i b = _mm256_loadu_si256((const __m256i *)(s + 2 * x + 32));
+                __m256i uu = _mm256_packus_epi16(_mm256_and_si256(a, lo_mask),
+                                                 _mm256_and_si256(b, lo_mask));
+                __m256i vv = _mm256_packus_epi16(_mm256_srli_epi16(a, 8),
+                                                 _mm256_srli_epi16(b, 8));
+                /* packus works per 128-bit lane - restore sample order */
+                uu = _mm256_permute4x64_epi64(uu, 0xD8);
+                vv = _mm256_permute4x64_epi64(vv, 0xD8);
+                _mm256_storeu_si256((__m256i *)(u + x), uu);
+                _mm256_storeu_si256((__m256i *)(v + x), vv);
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = s[2 * x];
+                v[x] = s[2 * x + 1];
+            }
+
+            for (; x + 32 <= dst_stride; x += 32) {
+                _mm256_storeu_si256((__m256i *)(u + x), zero);
+                _mm256_storeu_si256((__m256i *)(v + x), zero);
+            }
+            if (x < dst_stride) {
+                memset(u + x, 0, (size_t)(dst_stride - x));
+                memset(v + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    _mm256_zeroupper();
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_SSE2
+static void netint_copy_plane_p010_sse2(uint8_t *dst, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int width, int height)
+{
+    if (!netint_copy_clamp16(dst, dst_stride, dst_height, &width, &height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *row = dst + (size_t)y * (size_t)dst_stride;
+            uint16_t *d = (uint16_t *)row;
+            int x = 0;
+
+            for (; x + 8 <= width; x += 8) {
+                __m128i a = _mm_loadu_si128((const __m128i *)(s + x));
+                _mm_storeu_si128((__m128i *)(d + x), _mm_srli_epi16(a, 6));
+            }
+            for (; x < width; x++) {
+                d[x] = (uint16_t)(s[x] >> 6);
+            }
+            netint_copy_zero_tail(row, width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_SSE2
+static void netint_deinterleave_uv_p010_sse2(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                             const uint8_t *src, int src_stride,
+                                             int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp16(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *u_row = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v_row = dst_v + (size_t)y * (size_t)dst_stride;
+            uint16_t *u = (uint16_t *)u_row;
+            uint16_t *v = (uint16_t *)v_row;
+            int x = 0;
+
+            /* 8 UV pairs per iteration. Each 32-bit lane holds U (low) and
+             * V (high); after the >>6 both fit a signed 16-bit pack. */
+            for (; x + 8 <= chroma_width; x += 8) {
+                __m128i a = _mm_loadu_si128((const __m128i *)(s + 2 * x));
+                __m128i b = _mm_loadu_si128((const __m128i *)(s + 2 * x + 8));
+                __m128i ua = _mm_srli_epi32(_mm_slli_epi32(a, 16), 22);
+                __m128i ub = _mm_srli_epi32(_mm_slli_epi32(b, 16), 22);
+                __m128i va = _mm_srli_epi32(a, 22);
+                __m128i vb = _mm_srli_epi32(b, 22);
+                _mm_storeu_si128((__m128i *)(u + x), _mm_packs_epi32(ua, ub));
+                _mm_storeu_si128((__m128i *)(v + x), _mm_packs_epi32(va, vb));
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = (uint16_t)(s[2 * x] >> 6);
+                v[x] = (uint16_t)(s[2 * x + 1] >> 6);
+            }
+            netint_copy_zero_tail(u_row, chroma_width * 2, dst_stride);
+            netint_copy_zero_tail(v_row, chroma_width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_AVX2
+static void netint_copy_plane_p010_avx2(uint8_t *dst, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int width, int height)
+{
+    if (!netint_copy_clamp16(dst, dst_stride, dst_height, &width, &height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *row = dst + (size_t)y * (size_t)dst_stride;
+            uint16_t *d = (uint16_t *)row;
+            int x = 0;
+
+            for (; x + 16 <= width; x += 16) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(s + x));
+                _mm256_storeu_si256((__m256i *)(d + x), _mm256_srli_epi16(a, 6));
+            }
+            for (; x < width; x++) {
+                d[x] = (uint16_t)(s[x] >> 6);
+            }
+            netint_copy_zero_tail(row, width * 2, dst_stride);
+        }
+    }
+
+    _mm256_zeroupper();
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+NETINT_TARGET_AVX2
+static void netint_deinterleave_uv_p010_avx2(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                             const uint8_t *src, int src_stride,
+                                             int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp16(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *u_row = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v_row = dst_v + (size_t)y * (size_t)dst_stride;
+            uint16_t *u = (uint16_t *)u_row;
+            uint16_t *v = (uint16_t *)v_row;
+            int x = 0;
+
+            for (; x + 16 <= chroma_width; x += 16) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(s + 2 * x));
+                __m256i b = _mm256_loadu_si256((const __m256i *)(s + 2 * x + 16));
+                __m256i uu = _mm256_packs_epi32(_mm256_srli_epi32(_mm256_slli_epi32(a, 16), 22),
+                                                _mm256_srli_epi32(_mm256_slli_epi32(b, 16), 22));
+                __m256i vv = _mm256_packs_epi32(_mm256_srli_epi32(a, 22),
+                                                _mm256_srli_epi32(b, 22));
+                uu = _mm256_permute4x64_epi64(uu, 0xD8);
+                vv = _mm256_permute4x64_epi64(vv, 0xD8);
+                _mm256_storeu_si256((__m256i *)(u + x), uu);
+                _mm256_storeu_si256((__m256i *)(v + x), vv);
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = (uint16_t)(s[2 * x] >> 6);
+                v[x] = (uint16_t)(s[2 * x + 1] >> 6);
+            }
+            netint_copy_zero_tail(u_row, chroma_width * 2, dst_stride);
+            netint_copy_zero_tail(v_row, chroma_width * 2, dst_stride);
+        }
+    }
+
+    _mm256_zeroupper();
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+static const struct netint_copy_kernels netint_copy_kernels_sse2 = {
+    "sse2",
+    netint_copy_plane_sse2,
+    netint_deinterleave_uv_sse2,
+    netint_copy_plane_p010_sse2,
+    netint_deinterleave_uv_p010_sse2,
+};
+
+static const struct netint_copy_kernels netint_copy_kernels_avx2 = {
+    "avx2",
+    netint_copy_plane_avx2,
+    netint_deinterleave_uv_avx2,
+    netint_copy_plane_p010_avx2,
+    netint_deinterleave_uv_p010_avx2,
+};
+
+static bool netint_cpu_has_sse2(void)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; /* Part of the x86-64 baseline */
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool netint_cpu_has_avx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    /* OSXSAVE + AVX, and the OS must have enabled YMM state saving */
+    if ((regs[2] & (1 << 27)) == 0 || (regs[2] & (1 << 28)) == 0) {
+        return false;
+    }
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    /* __builtin_cpu_supports already accounts for OS YMM support */
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif /* NETINT_COPY_X86 */
+
+/* ------------------------------------------------------------------------- */
+/* ARM: NEON                                                                 */
+
+#ifdef NETINT_COPY_NEON
+
+static void netint_copy_plane_neon(uint8_t *dst, int dst_stride, int dst_height,
+                                   const uint8_t *src, int src_stride,
+                                   int width_bytes, int height)
+{
+    if (!netint_copy_clamp(dst, dst_stride, dst_height, &width_bytes, &height)) {
+        return;
+    }
+
+    const uint8x16_t zero = vdupq_n_u8(0);
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *d = dst + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            for (; x + 64 <= width_bytes; x += 64) {
+                uint8x16_t a = vld1q_u8(s + x);
+                uint8x16_t b = vld1q_u8(s + x + 16);
+                uint8x16_t c = vld1q_u8(s + x + 32);
+                uint8x16_t e = vld1q_u8(s + x + 48);
+                vst1q_u8(d + x, a);
+                vst1q_u8(d + x + 16, b);
+                vst1q_u8(d + x + 32, c);
+                vst1q_u8(d + x + 48, e);
+            }
+            for (; x + 16 <= width_bytes; x += 16) {
+                vst1q_u8(d + x, vld1q_u8(s + x));
+            }
+            if (x < width_bytes) {
+                memcpy(d + x, s + x, (size_t)(width_bytes - x));
+                x = width_bytes;
+            }
+
+            for (; x + 16 <= dst_stride; x += 16) {
+                vst1q_u8(d + x, zero);
+            }
+            if (x < dst_stride) {
+                memset(d + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+static void netint_deinterleave_uv_neon(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    const uint8x16_t zero = vdupq_n_u8(0);
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint8_t *s = src + (size_t)y * (size_t)src_stride;
+            uint8_t *u = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v = dst_v + (size_t)y * (size_t)dst_stride;
+            int x = 0;
+
+            /* vld2q splits even/odd bytes for us */
+            for (; x + 16 <= chroma_width; x += 16) {
+                uint8x16x2_t uv = vld2q_u8(s + 2 * x);
+                vst1q_u8(u + x, uv.val[0]);
+                vst1q_u8(v + x, uv.val[1]);
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = s[2 * x];
+                v[x] = s[2 * x + 1];
+            }
+
+            for (; x + 16 <= dst_stride; x += 16) {
+                vst1q_u8(u + x, zero);
+                vst1q_u8(v + x, zero);
+            }
+            if (x < dst_stride) {
+                memset(u + x, 0, (size_t)(dst_stride - x));
+                memset(v + x, 0, (size_t)(dst_stride - x));
+            }
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+static void netint_copy_plane_p010_neon(uint8_t *dst, int dst_stride, int dst_height,
+                                        const uint8_t *src, int src_stride,
+                                        int width, int height)
+{
+    if (!netint_copy_clamp16(dst, dst_stride, dst_height, &width, &height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *row = dst + (size_t)y * (size_t)dst_stride;
+            uint16_t *d = (uint16_t *)row;
+            int x = 0;
+
+            for (; x + 8 <= width; x += 8) {
+                vst1q_u16(d + x, vshrq_n_u16(vld1q_u16(s + x), 6));
+            }
+            for (; x < width; x++) {
+                d[x] = (uint16_t)(s[x] >> 6);
+            }
+            netint_copy_zero_tail(row, width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst, dst_stride, y, dst_height);
+}
+
+static void netint_deinterleave_uv_p010_neon(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                             const uint8_t *src, int src_stride,
+                                             int chroma_width, int chroma_height)
+{
+    if (!dst_v || !netint_copy_clamp16(dst_u, dst_stride, dst_height, &chroma_width, &chroma_height)) {
+        return;
+    }
+
+    int y = 0;
+    if (src) {
+        for (; y < chroma_height; y++) {
+            const uint16_t *s = (const uint16_t *)(src + (size_t)y * (size_t)src_stride);
+            uint8_t *u_row = dst_u + (size_t)y * (size_t)dst_stride;
+            uint8_t *v_row = dst_v + (size_t)y * (size_t)dst_stride;
+            uint16_t *u = (uint16_t *)u_row;
+            uint16_t *v = (uint16_t *)v_row;
+            int x = 0;
+
+            for (; x + 8 <= chroma_width; x += 8) {
+                uint16x8x2_t uv = vld2q_u16(s + 2 * x);
+                vst1q_u16(u + x, vshrq_n_u16(uv.val[0], 6));
+                vst1q_u16(v + x, vshrq_n_u16(uv.val[1], 6));
+            }
+            for (; x < chroma_width; x++) {
+                u[x] = (uint16_t)(s[2 * x] >> 6);
+                v[x] = (uint16_t)(s[2 * x + 1] >> 6);
+            }
+            netint_copy_zero_tail(u_row, chroma_width * 2, dst_stride);
+            netint_copy_zero_tail(v_row, chroma_width * 2, dst_stride);
+        }
+    }
+
+    netint_copy_clear_rows(dst_u, dst_stride, y, dst_height);
+    netint_copy_clear_rows(dst_v, dst_stride, y, dst_height);
+}
+
+static const struct netint_copy_kernels netint_copy_kernels_neon = {
+    "neon",
+    netint_copy_plane_neon,
+    netint_deinterleave_uv_neon,
+    netint_copy_plane_p010_neon,
+    netint_deinterleave_uv_p010_neon,
+};
+
+#endif /* NETINT_COPY_NEON */
+
+/* ------------------------------------------------------------------------- */
+/* Dispatch                                                                  */
+
+const struct netint_copy_kernels *netint_copy_scalar_kernels(void)
+{
+    return &netint_copy_kernels_c;
+}
+
+const struct netint_copy_kernels *netint_copy_select_kernels(const char *preferred)
+{
+    bool forced = preferred && *preferred && strcmp(preferred, "auto") != 0;
+
+    if (forced && strcmp(preferred, "c") == 0) {
+        return &netint_copy_kernels_c;
+    }
+
+#ifdef NETINT_COPY_X86
+    bool has_avx2 = netint_cpu_has_avx2();
+    bool has_sse2 = netint_cpu_has_sse2();
+
+    if (forced && strcmp(preferred, "sse2") == 0 && has_sse2) {
+        return &netint_copy_kernels_sse2;
+    }
+    if (forced && strcmp(preferred, "avx2") == 0 && has_avx2) {
+        return &netint_copy_kernels_avx2;
+    }
+    if (has_avx2) {
+        return &netint_copy_kernels_avx2;
+    }
+    if (has_sse2) {
+        return &netint_copy_kernels_sse2;
+    }
+#endif
+
+#ifdef NETINT_COPY_NEON
+    /* NEON is mandatory on AArch64 and assumed whenever __ARM_NEON is set */
+    return &netint_copy_kernels_neon;
+#endif
+
+    return &netint_copy_kernels_c;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file netint-copy.h
+ * @brief Host-side plane copy kernels for NETINT T4XX frame uploads
+ *
+ * The T4XX encoder only accepts planar YUV 4:2:0 in its own padded layout
+ * (hw_stride x hw_height per plane, as reported by ni_logan_get_hw_yuv420p_dim).
+ * These kernels write OBS frames straight into that layout so the plugin can
+ * accept the formats OBS already produces (NV12, and P010/I010 for 10-bit)
+ * without asking OBS for an extra colour-format conversion first.
+ *
+ * All kernels write every byte of the destination plane: rows and columns
+ * beyond the source picture are zero-filled in the same pass, so the padded
+ * area never carries stale data from a previous frame.
+ *
+ * Several implementations exist (portable C, SSE2, AVX2, NEON). The best one
+ * for the running CPU is picked once per encoder via netint_copy_select_kernels()
+ * and called through the returned table.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Copy one plane into a padded hardware plane
+ *
+ * @param dst Destination plane (hardware layout)
+ * @param dst_stride Destination stride in bytes (hw_stride)
+ * @param dst_height Destination height in rows (hw_height)
+ * @param src Source plane (OBS layout)
+ * @param src_stride Source stride in bytes (OBS linesize)
+ * @param width_bytes Visible row width in bytes
+ * @param height Visible height in rows
+ */
+typedef void (*netint_copy_plane_fn)(uint8_t *dst, int dst_stride, int dst_height,
+                                     const uint8_t *src, int src_stride,
+                                     int width_bytes, int height);
+
+/**
+ * @brief Split an interleaved UV plane (NV12) into padded U and V planes
+ *
+ * @param dst_u Destination U plane (hardware layout)
+ * @param dst_v Destination V plane (hardware layout)
+ * @param dst_stride Destination stride in bytes for both chroma planes
+ * @param dst_height Destination height in rows for both chroma planes
+ * @param src Source interleaved UV plane
+ * @param src_stride Source stride in bytes
+ * @param chroma_width Visible chroma width in samples (width / 2)
+ * @param chroma_height Visible chroma height in rows (height / 2)
+ */
+typedef void (*netint_deinterleave_uv_fn)(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                          const uint8_t *src, int src_stride,
+                                          int chroma_width, int chroma_height);
+
+/**
+ * @brief Copy one P010 luma plane into a padded 10-bit hardware plane
+ *
+ * P010 keeps 10-bit samples in the top bits of each 16-bit word, the T4XX
+ * expects them LSB-aligned (YUV420P10LE), so every sample is shifted down by 6.
+ *
+ * @param width Visible row width in samples (not bytes)
+ * Other parameters as for netint_copy_plane_fn (strides in bytes).
+ */
+typedef void (*netint_copy_plane_p010_fn)(uint8_t *dst, int dst_stride, int dst_height,
+                                          const uint8_t *src, int src_stride,
+                                          int width, int height);
+
+/**
+ * @brief Split a P010 interleaved UV plane into padded 10-bit U and V planes
+ *
+ * Same contract as netint_deinterleave_uv_fn with 16-bit samples, shifted
+ * down by 6 like netint_copy_plane_p010_fn.
+ */
+typedef void (*netint_deinterleave_uv_p010_fn)(uint8_t *dst_u, uint8_t *dst_v, int dst_stride, int dst_height,
+                                               const uint8_t *src, int src_stride,
+                                               int chroma_width, int chroma_height);
+
+/**
+ * @brief Table of copy kernels for one instruction set
+ */
+struct netint_copy_kernels {
+    const char *name;                          /**< Kernel family name for logging ("c", "sse2", ...) */
+    netint_copy_plane_fn copy_plane;           /**< Padded plane copy (8-bit and I010) */
+    netint_deinterleave_uv_fn deinterleave_uv; /**< NV12 chroma split */
+    netint_copy_plane_p010_fn copy_plane_p010; /**< P010 luma copy with MSB->LSB shift */
+    netint_deinterleave_uv_p010_fn deinterleave_uv_p010; /**< P010 chroma split with MSB->LSB shift */
+};
+
+/**
+ * @brief Pick the fastest kernel table for the running CPU
+ *
+ * @param preferred Optional kernel name ("c", "sse2", "avx2", "neon") to force a
+ *                  specific implementation; NULL, "" or "auto" selects by CPU
+ *                  feature detection. Unsupported names fall back to detection.
+ * @return Kernel table (never NULL, static lifetime)
+ */
+const struct netint_copy_kernels *netint_copy_select_kernels(const char *preferred);
+
+/**
+ * @brief Portable C kernel table (always available)
+ */
+const struct netint_copy_kernels *netint_copy_scalar_kernels(void);
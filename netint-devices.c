@@ -0,0 +1,421 @@
+/**
+ * @file netint-devices.c
+ * @brief Session placement across NETINT T4XX devices
+ *
+ * See netint-devices.h. The registry is a small fixed table guarded by one
+ * mutex; it is only touched when encoders are created or destroyed, never
+ * on the per-frame path. Slots are never reused for another device, so a
+ * lease stays valid even if the device disappears from a later discovery.
+ *
+ * Only the refresh thread talks to the resource manager, and never with
+ * s_device_mutex held, so readers wait at most for a table update.
+ */
+
+#include "netint-devices.h"
+#include "netint-libxcoder.h"
+
+#include <util/base.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NETINT_MAX_DEVICES 16
+#define NETINT_MAX_AFFINITY_KEYS 32
+
+/**
+ * @brief Encode capacity of one T4XX die in pixels per second (4Kp60),
+ *        used to turn this plugin's session pixel rates into a load percentage
+ */
+#define NETINT_DEVICE_PIXEL_RATE (3840ULL * 2160ULL * 60ULL)
+
+/** Hardware loads are refreshed at this interval */
+#define NETINT_DEVICE_REFRESH_MS 1000
+
+/** The device list is re-read every this many load refreshes (hotplug, late init_rsrc) */
+#define NETINT_DEVICE_DISCOVER_EVERY 5
+
+/** Affinity placement leaves a device once its load would exceed this (percent) */
+#define NETINT_DEVICE_AFFINITY_MAX_LOAD 80
+
+struct netint_device {
+    char name[NI_LOGAN_MAX_DEVICE_NAME_LEN];
+    bool present;                 /**< Listed by the last discovery (or chosen by the user) */
+    bool listed;                  /**< Listed by the last discovery */
+    int guid;                     /**< Resource manager GUID, -1 = not resolved */
+    int hw_load;                  /**< Last resource manager load (percent), -1 = unknown */
+    int sessions;                 /**< Sessions this plugin has placed here */
+    uint64_t pixel_rate;          /**< Sum of their pixel rates */
+};
+
+struct netint_affinity {
+    const void *key;
+    int slot;
+    int refs;
+};
+
+static pthread_mutex_t s_device_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct netint_device s_devices[NETINT_MAX_DEVICES];
+static int s_device_count;
+static struct netint_affinity s_affinity[NETINT_MAX_AFFINITY_KEYS];
+static bool s_rsrc_ready;
+
+static pthread_t s_refresh_thread;
+static bool s_refresh_running;
+static pthread_mutex_t s_refresh_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_refresh_cond = PTHREAD_COND_INITIALIZER;
+static bool s_refresh_stop;
+
+/* All helpers below run with s_device_mutex held */
+
+static int netint_device_find(const char *name)
+{
+    for (int i = 0; i < s_device_count; i++) {
+        if (strcmp(s_devices[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int netint_device_add(const char *name)
+{
+    int slot = netint_device_find(name);
+    if (slot >= 0) {
+        s_devices[slot].present = true;
+        return slot;
+    }
+    if (s_device_count >= NETINT_MAX_DEVICES) {
+        return -1;
+    }
+
+    slot = s_device_count++;
+    memset(&s_devices[slot], 0, sizeof(s_devices[slot]));
+    strncpy(s_devices[slot].name, name, NI_LOGAN_MAX_DEVICE_NAME_LEN - 1);
+    s_devices[slot].present = true;
+    s_devices[slot].guid = -1;
+    s_devices[slot].hw_load = -1;
+    return slot;
+}
+
+/* Called without s_device_mutex: the resource manager calls may block */
+static void netint_device_discover(void)
+{
+    if (!p_ni_logan_rsrc_init || !p_ni_logan_rsrc_get_local_device_list) {
+        return;
+    }
+
+    if (!s_rsrc_ready) {
+        int rsrc_ret = p_ni_logan_rsrc_init(0, 1);
+        if (rsrc_ret != 0 && rsrc_ret != 0x7FFFFFFF) {
+            return;
+        }
+        s_rsrc_ready = true;
+    }
+
+    char names[NETINT_MAX_DEVICES][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    int n = p_ni_logan_rsrc_get_local_device_list(names, NETINT_MAX_DEVICES);
+    if (n < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_device_mutex);
+    for (int i = 0; i < s_device_count; i++) {
+        s_devices[i].present = false;
+        s_devices[i].listed = false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (names[i][0]) {
+            int slot = netint_device_add(names[i]);
+            if (slot >= 0) {
+                s_devices[slot].listed = true;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_device_mutex);
+}
+
+/* Called without s_device_mutex */
+static void netint_device_query_loads(void)
+{
+    char names[NETINT_MAX_DEVICES][NI_LOGAN_MAX_DEVICE_NAME_LEN];
+    int guids[NETINT_MAX_DEVICES];
+    int loads[NETINT_MAX_DEVICES];
+    int count;
+
+    if (!p_ni_logan_rsrc_get_device_by_block_name || !p_ni_logan_rsrc_get_device_info) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_device_mutex);
+    count = s_device_count;
+    for (int i = 0; i < count; i++) {
+        memcpy(names[i], s_devices[i].name, NI_LOGAN_MAX_DEVICE_NAME_LEN);
+        guids[i] = s_devices[i].guid;
+    }
+    pthread_mutex_unlock(&s_device_mutex);
+
+    for (int i = 0; i < count; i++) {
+        loads[i] = -1;
+        if (guids[i] < 0) {
+            guids[i] = p_ni_logan_rsrc_get_device_by_block_name(names[i], NI_LOGAN_DEVICE_TYPE_ENCODER);
+            if (guids[i] < 0) {
+                continue;
+            }
+        }
+
+        ni_logan_device_info_t *info = p_ni_logan_rsrc_get_device_info(NI_LOGAN_DEVICE_TYPE_ENCODER, guids[i]);
+        if (info) {
+            loads[i] = info->load;
+            free(info);
+        }
+    }
+
+    pthread_mutex_lock(&s_device_mutex);
+    for (int i = 0; i < count; i++) {
+        s_devices[i].guid = guids[i];
+        s_devices[i].hw_load = loads[i];
+    }
+    pthread_mutex_unlock(&s_device_mutex);
+}
+
+static void *netint_device_refresh_thread(void *data)
+{
+    (void)data;
+    int until_discover = NETINT_DEVICE_DISCOVER_EVERY;
+
+    os_set_thread_name("netint-devices");
+
+    pthread_mutex_lock(&s_refresh_mutex);
+    while (!s_refresh_stop) {
+        struct timespec deadline;
+        timespec_get(&deadline, TIME_UTC);
+        deadline.tv_sec += NETINT_DEVICE_REFRESH_MS / 1000;
+        deadline.tv_nsec += (NETINT_DEVICE_REFRESH_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        if (pthread_cond_timedwait(&s_refresh_cond, &s_refresh_mutex, &deadline) != ETIMEDOUT) {
+            continue;
+        }
+        pthread_mutex_unlock(&s_refresh_mutex);
+
+        if (--until_discover == 0) {
+            netint_device_discover();
+            until_discover = NETINT_DEVICE_DISCOVER_EVERY;
+        }
+        netint_device_query_loads();
+
+        pthread_mutex_lock(&s_refresh_mutex);
+    }
+    pthread_mutex_unlock(&s_refresh_mutex);
+    return NULL;
+}
+
+void netint_devices_init(void)
+{
+    netint_device_discover();
+    netint_device_query_loads();
+
+    pthread_mutex_lock(&s_device_mutex);
+    int count = s_device_count;
+    pthread_mutex_unlock(&s_device_mutex);
+    blog(LOG_INFO, "[obs-netint-t4xx] Device registry: %d device(s) found", count);
+
+    s_refresh_stop = false;
+    if (pthread_create(&s_refresh_thread, NULL, netint_device_refresh_thread, NULL) == 0) {
+        s_refresh_running = true;
+    } else {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to start device refresh thread, device list will not update");
+    }
+}
+
+void netint_devices_shutdown(void)
+{
+    if (!s_refresh_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_refresh_mutex);
+    s_refresh_stop = true;
+    pthread_cond_signal(&s_refresh_cond);
+    pthread_mutex_unlock(&s_refresh_mutex);
+
+    pthread_join(s_refresh_thread, NULL);
+    s_refresh_running = false;
+}
+
+int netint_device_list(char names[][NI_LOGAN_MAX_DEVICE_NAME_LEN], int max_names)
+{
+    int n = 0;
+
+    pthread_mutex_lock(&s_device_mutex);
+    for (int i = 0; i < s_device_count && n < max_names; i++) {
+        if (s_devices[i].listed) {
+            memcpy(names[n++], s_devices[i].name, NI_LOGAN_MAX_DEVICE_NAME_LEN);
+        }
+    }
+    pthread_mutex_unlock(&s_device_mutex);
+    return n;
+}
+
+static int netint_device_own_load(const struct netint_device *dev, uint64_t extra_rate)
+{
+    return (int)((dev->pixel_rate + extra_rate) * 100ULL / NETINT_DEVICE_PIXEL_RATE);
+}
+
+/* Load (percent) the device would have with extra_rate added */
+static int netint_device_score(const struct netint_device *dev, uint64_t extra_rate)
+{
+    int extra = (int)(extra_rate * 100ULL / NETINT_DEVICE_PIXEL_RATE);
+    int own = netint_device_own_load(dev, extra_rate);
+    int hw = dev->hw_load >= 0 ? dev->hw_load + extra : -1;
+    return hw > own ? hw : own;
+}
+
+static struct netint_affinity *netint_affinity_find(const void *key)
+{
+    for (int i = 0; i < NETINT_MAX_AFFINITY_KEYS; i++) {
+        if (s_affinity[i].refs > 0 && s_affinity[i].key == key) {
+            return &s_affinity[i];
+        }
+    }
+    return NULL;
+}
+
+static void netint_affinity_ref(const void *key, int slot)
+{
+    struct netint_affinity *entry = netint_affinity_find(key);
+    if (entry) {
+        if (entry->slot == slot) {
+            entry->refs++;
+        }
+        /* Group already lives elsewhere: this session spilled over and the
+         * group keeps its original device */
+        return;
+    }
+
+    for (int i = 0; i < NETINT_MAX_AFFINITY_KEYS; i++) {
+        if (s_affinity[i].refs == 0) {
+            s_affinity[i].key = key;
+            s_affinity[i].slot = slot;
+            s_affinity[i].refs = 1;
+            return;
+        }
+    }
+}
+
+static void netint_affinity_unref(const void *key, int slot)
+{
+    struct netint_affinity *entry = netint_affinity_find(key);
+    if (entry && entry->slot == slot && --entry->refs == 0) {
+        entry->key = NULL;
+    }
+}
+
+static int netint_device_pick(const struct netint_device_request *request, uint64_t rate)
+{
+    if (request->placement == NETINT_PLACEMENT_AFFINITY && request->affinity_key) {
+        struct netint_affinity *entry = netint_affinity_find(request->affinity_key);
+        if (entry && entry->slot != request->avoid_slot && s_devices[entry->slot].present) {
+            int score = netint_device_score(&s_devices[entry->slot], rate);
+            if (score <= NETINT_DEVICE_AFFINITY_MAX_LOAD) {
+                return entry->slot;
+            }
+            blog(LOG_INFO, "[obs-netint-t4xx] Affinity device '%s' would be at %d%% load, placing elsewhere",
+                 s_devices[entry->slot].name, score);
+        }
+    }
+
+    int best = -1;
+    int best_score = 0;
+    for (int i = 0; i < s_device_count; i++) {
+        if (!s_devices[i].present || i == request->avoid_slot) {
+            continue;
+        }
+        int score = netint_device_score(&s_devices[i], rate);
+        /* Ties go to the device with fewer of our sessions, then discovery order */
+        if (best < 0 || score < best_score ||
+            (score == best_score && s_devices[i].sessions < s_devices[best].sessions)) {
+            best = i;
+            best_score = score;
+        }
+    }
+
+    /* Nowhere else to go: stay on the avoided device */
+    if (best < 0 && request->avoid_slot >= 0 && request->avoid_slot < s_device_count &&
+        s_devices[request->avoid_slot].present) {
+        best = request->avoid_slot;
+    }
+    return best;
+}
+
+bool netint_device_acquire(const struct netint_device_request *request, const char *name,
+                           struct netint_device_lease *lease, char out_name[NI_LOGAN_MAX_DEVICE_NAME_LEN])
+{
+    uint64_t rate = 0;
+    int slot = -1;
+
+    lease->slot = -1;
+    lease->pixel_rate = 0;
+    lease->affinity_key = NULL;
+
+    if (request->fps_den > 0) {
+        rate = (uint64_t)request->width * (uint64_t)request->height * request->fps_num / request->fps_den;
+    }
+
+    pthread_mutex_lock(&s_device_mutex);
+
+    if (name && *name) {
+        slot = netint_device_add(name);
+    } else {
+        slot = netint_device_pick(request, rate);
+    }
+
+    if (slot >= 0) {
+        struct netint_device *dev = &s_devices[slot];
+        if (!(name && *name)) {
+            blog(LOG_INFO, "[obs-netint-t4xx] Placing session on '%s' (load %d%% with this session, %d plugin session(s) before it)",
+                 dev->name, netint_device_score(dev, rate), dev->sessions);
+        }
+
+        dev->sessions++;
+        dev->pixel_rate += rate;
+        lease->slot = slot;
+        lease->pixel_rate = rate;
+        if (request->affinity_key) {
+            lease->affinity_key = request->affinity_key;
+            netint_affinity_ref(request->affinity_key, slot);
+        }
+        strncpy(out_name, dev->name, NI_LOGAN_MAX_DEVICE_NAME_LEN - 1);
+        out_name[NI_LOGAN_MAX_DEVICE_NAME_LEN - 1] = '\0';
+    }
+
+    pthread_mutex_unlock(&s_device_mutex);
+    return slot >= 0;
+}
+
+void netint_device_release(struct netint_device_lease *lease)
+{
+    if (!lease || lease->slot < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_device_mutex);
+    struct netint_device *dev = &s_devices[lease->slot];
+    if (dev->sessions > 0) {
+        dev->sessions--;
+    }
+    dev->pixel_rate = dev->pixel_rate > lease->pixel_rate ? dev->pixel_rate - lease->pixel_rate : 0;
+    if (lease->affinity_key) {
+        netint_affinity_unref(lease->affinity_key, lease->slot);
+    }
+    pthread_mutex_unlock(&s_device_mutex);
+
+    lease->slot = -1;
+    lease->pixel_rate = 0;
+    lease->affinity_key = NULL;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file netint-devices.h
+ * @brief Session placement across NETINT T4XX devices
+ *
+ * A host can carry several encoder dies: a T432 exposes four, and extra T408
+ * cards add one each. Without placement every auto-configured session would
+ * open the first device libxcoder lists. This module keeps a process-wide
+ * table of devices and of the sessions this plugin has placed on each one,
+ * and picks the least loaded device for every new session.
+ *
+ * Load comes from two sources:
+ * - the libxcoder resource manager's per-device load (covers other
+ *   processes), if this libxcoder exports the query
+ * - the pixel rate of this plugin's own sessions on the device, which covers
+ *   sessions that have just opened and don't show up in the hardware load yet
+ *
+ * The higher of the two is used.
+ *
+ * The device list and hardware loads are read once at module load and then
+ * refreshed by a background thread, so creating encoders and building the
+ * properties UI only read the cached table and never wait on the resource
+ * manager.
+ *
+ * With affinity placement, sessions that share an affinity key (the encoder's
+ * video output) go to the same device for as long as it has headroom. That
+ * keeps related renditions of one canvas together on one die.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "netint-libxcoder-shim.h"
+
+/**
+ * @brief "device_placement" setting
+ */
+enum netint_device_placement {
+    NETINT_PLACEMENT_LEAST_LOAD, /**< Least loaded device */
+    NETINT_PLACEMENT_AFFINITY,   /**< Device of sessions with the same key, unless it is busy */
+};
+
+/**
+ * @brief What a new session needs from a device
+ */
+struct netint_device_request {
+    int width;
+    int height;
+    uint32_t fps_num;
+    uint32_t fps_den;
+    enum netint_device_placement placement;
+    const void *affinity_key;    /**< Sessions with the same key prefer one device (NULL = none) */
+    int avoid_slot;              /**< Failover: pick another device than this slot if there is one (-1 = none) */
+};
+
+/**
+ * @brief A session's claim on a device, returned by netint_device_acquire()
+ */
+struct netint_device_lease {
+    int slot;                    /**< Registry slot, -1 = no claim */
+    uint64_t pixel_rate;         /**< Pixels per second accounted to the device */
+    const void *affinity_key;
+};
+
+/**
+ * @brief Discover devices and start the background refresh (obs_module_load)
+ *
+ * Call after the library is loaded; safe to call when it isn't.
+ */
+void netint_devices_init(void);
+
+/**
+ * @brief Stop the background refresh (obs_module_unload, before the library is closed)
+ */
+void netint_devices_shutdown(void);
+
+/**
+ * @brief Copy the names of the devices listed by the last discovery
+ *
+ * @return Number of names written (at most @p max_names)
+ */
+int netint_device_list(char names[][NI_LOGAN_MAX_DEVICE_NAME_LEN], int max_names);
+
+/**
+ * @brief Place a session on a device and account for it
+ *
+ * @param request Session size/rate and placement policy
+ * @param name Device chosen by the user, or NULL/"" to pick one automatically.
+ *             User-chosen devices are accounted too, so automatic placement
+ *             sees them.
+ * @param lease Receives the claim; pass it to netint_device_release() when the
+ *              session closes. Set to "no claim" on failure.
+ * @param out_name Receives the selected device name
+ * @return false if no device is known (the caller keeps libxcoder's default)
+ */
+bool netint_device_acquire(const struct netint_device_request *request, const char *name,
+                           struct netint_device_lease *lease, char out_name[NI_LOGAN_MAX_DEVICE_NAME_LEN]);
+
+/**
+ * @brief Drop a session's claim (safe to call with an empty lease)
+ */
+void netint_device_release(struct netint_device_lease *lease);
@@ -21,8 +21,15 @@
  * 
  * Threading Model:
  * - Main thread: Calls encode() from OBS, sends frames, receives packets from queue
- * - Background thread: Continuously receives encoded packets, queues them
- * - Queue mutex: Protects packet queue from concurrent access
+ * - Background thread: Sends queued frames and collects every ready packet;
+ *   while frames are in flight it polls the card every NETINT_IO_POLL_INTERVAL_MS
+ *   instead of waiting for the next frame
+ * - With NETINT_IO_REACTOR set, sessions share a few IO workers instead
+ *   (netint-reactor.h); each round does the same send/collect work without
+ *   blocking
+ * - Frame jobs and packets move between the two threads through lock-free
+ *   single-producer/single-consumer rings (netint-ring.h); a thread only
+ *   sleeps when the pipeline is full or it has nothing to do
  * 
  * Key Features:
  * - Variable frame rate (VFR) support via reconfig_vfr()
@@ -42,6 +49,16 @@
 #include "netint-encoder.h"
 #include "netint-libxcoder.h"
 #include "netint-debug.h"
+#include "netint-copy.h"
+#include "netint-ring.h"
+#include "netint-devices.h"
+#include "netint-telemetry.h"
+#include "netint-frame-cache.h"
+#include "netint-scale.h"
+#include "netint-session-pool.h"
+#include "netint-reactor.h"
+#include "netint-numa.h"
+#include "netint-log.h"
 
 #include <obs-avc.h>
 #include <obs-hevc.h>
@@ -52,8 +69,10 @@
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <time.h>
 #include "netint-libxcoder-shim.h"
 
 /**
@@ -65,6 +84,36 @@
  * The queue allows asynchronous packet reception: the background thread receives packets
  * and queues them, while the main thread pops them when OBS requests them.
  */
+/**
+ * @brief libxcoder packet buffer lent to OBS without copying its contents
+ */
+struct netint_zc_buf {
+    ni_logan_packet_t hw_pkt;     /**< Buffer as filled by encode_receive (allocated by libxcoder) */
+    size_t headroom;              /**< Bytes reserved in front of hw_pkt.p_data */
+    struct netint_zc_buf *next;   /**< Next buffer in the IO thread's spare list */
+};
+
+/**
+ * @brief Packet buffer size classes
+ *
+ * Buffers of a class all have the class size, so a buffer is never grown
+ * after allocation. Packets larger than the IDR class get an exact-size
+ * buffer that is freed on release.
+ */
+enum netint_pkt_class {
+    NETINT_PKT_CLASS_FRAME,       /**< Up to several average frames (P/B pictures, headers) */
+    NETINT_PKT_CLASS_IDR,         /**< Up to the VBV/GOP bound, reserved for keyframe-sized packets */
+    NETINT_PKT_CLASS_COUNT,
+    NETINT_PKT_CLASS_OVERSIZE = NETINT_PKT_CLASS_COUNT,
+};
+
+struct netint_pkt_slab {
+    size_t buffer_size;           /**< Capacity of every buffer in the class */
+    struct netint_pkt *head;      /**< Free packets of this class (IO thread only) */
+    int count;                    /**< Packets on the free list */
+    int capacity;                 /**< Maximum packets retained on the free list */
+};
+
 struct netint_pkt {
     uint8_t *data;        /**< Encoded packet data (allocated, must be freed) */
     size_t size;          /**< Size of encoded packet in bytes */
@@ -73,30 +122,35 @@ struct netint_pkt {
     int64_t dts;          /**< Decode timestamp (when frame should be decoded) */
     bool keyframe;        /**< true if this is a keyframe (I-frame), false for P/B frames */
     int priority;         /**< Packet priority (higher = more important for streaming) */
-    struct netint_pkt *next; /**< Next packet in queue (linked list) */
+    struct netint_pkt *next; /**< Next packet in the IO thread's free list */
+    enum netint_pkt_class slab_class; /**< Size class data was allocated for */
+    struct netint_zc_buf *zc; /**< Zero-copy storage; if set the packet bytes live here, not in data */
+    uint8_t *zc_data;     /**< First packet byte inside zc */
 };
 
+/** Bytes to hand to OBS, wherever they are stored */
+static inline uint8_t *netint_pkt_bytes(const struct netint_pkt *pkt)
+{
+    return pkt->zc ? pkt->zc_data : pkt->data;
+}
+
+/** Metadata bytes reserved in front of every hardware frame buffer */
+#define NETINT_FRAME_EXTRA_DATA_LEN 64
+
 struct netint_frame_job {
     ni_logan_frame_t hw_frame;        /**< Pre-allocated hardware frame buffer */
+    struct netint_shared_frame *shared; /**< Upload shared with other encoders, sent instead of hw_frame */
     size_t hw_frame_capacity;         /**< Capacity of hardware buffer in bytes */
     int64_t pts;                      /**< Presentation/Decode timestamp */
     bool start_of_stream;             /**< Marks first frame to hardware */
     bool end_of_stream;               /**< Signals EOS to hardware */
     bool from_pool;                   /**< Indicates job originated from reusable pool */
     uint8_t *roi_data;                /**< Optional ROI side data (array of ni_region_of_interest_t) */
-    size_t roi_data_size;             /**< Size of ROI side data in bytes */
-    struct netint_frame_job *next;    /**< Next job in queue */
+    size_t roi_data_size;             /**< Size of ROI side data in bytes, 0 = none for this frame */
+    size_t roi_data_capacity;         /**< Allocated size of roi_data (kept across reuse) */
+    struct netint_frame_job *next;    /**< Next job in the reusable job pool */
 };
 
-/**
- * @brief Maximum packet queue size to prevent unbounded growth
- * 
- * This limit prevents the queue from growing indefinitely if OBS doesn't consume
- * packets fast enough. If the queue reaches this size, we log a warning.
- * In extreme cases, we could drop oldest packets, but for now we just warn.
- */
-#define MAX_PKT_QUEUE_SIZE 10
-
 /**
  * @brief Maximum consecutive errors before encoder is considered failed
  * 
@@ -108,8 +162,9 @@ struct netint_frame_job {
 /**
  * @brief Maximum time (in seconds) without receiving a packet before considering encoder hung
  * 
- * If no packets are received for this duration (and we're not flushing), the encoder
- * may be hung. We log a warning and attempt recovery.
+ * Used by the watchdog until a session has delivered its first packet; after
+ * that the shorter NETINT_WATCHDOG_MIN_MS bound applies. A stream that runs
+ * this long after a recovery gets its recovery attempts back.
  */
 #define ENCODER_HANG_TIMEOUT_SEC 10
 
@@ -117,19 +172,109 @@ struct netint_frame_job {
  * @brief Maximum number of recovery attempts before giving up
  * 
  * After this many recovery attempts, we stop trying to recover and mark encoder as failed.
+ * The first attempt reopens the session on its own device, later ones on another
+ * device if there is one (unless the user picked the device).
  */
 #define MAX_RECOVERY_ATTEMPTS 3
 
 /**
- * @brief Minimum number of reusable frame jobs to keep in the pool
+ * @brief Watchdog stall threshold once packets are flowing
+ *
+ * The larger of NETINT_WATCHDOG_MIN_MS and NETINT_WATCHDOG_FRAMES frame
+ * intervals. NETINT_WATCHDOG_MS overrides it, 0 turns the watchdog off.
+ */
+#define NETINT_WATCHDOG_MIN_MS 500
+#define NETINT_WATCHDOG_FRAMES 8
+
+/**
+ * @brief Pipeline depth limits
+ *
+ * max_inflight is the number of frames allowed inside the card. On top of
+ * that up to NETINT_PIPELINE_QUEUE_SLACK uploaded jobs may wait for the IO
+ * thread. Host jobs are released as soon as the card has taken the frame, so
+ * only those queued jobs (plus the one being uploaded) pin a full-size
+ * hardware frame; the job pool is preallocated for the steady state and
+ * grows on demand up to the pipeline depth.
+ */
+#define NETINT_PIPELINE_MAX_INFLIGHT 16
+#define NETINT_PIPELINE_QUEUE_SLACK 2
+#define NETINT_JOB_POOL_PREALLOC (NETINT_PIPELINE_QUEUE_SLACK + 2)
+
+/**
+ * @brief Auto pipeline depth: packets between re-evaluations, and how many
+ *        consecutive low readings it takes to give one frame of depth back
  */
-#define NETINT_JOB_POOL_MIN_CAPACITY 20
+#define NETINT_PIPELINE_ADAPT_INTERVAL 60
+#define NETINT_PIPELINE_SHRINK_VOTES 4
+
+/**
+ * @brief Send timestamps kept for hardware latency measurement (power of two,
+ *        larger than the deepest possible pipeline)
+ */
+#define NETINT_LATENCY_SLOTS 32
 #define NETINT_MAX_INTRAPERIOD_FRAMES 1024
 
 /**
- * @brief Minimum number of reusable packet buffers to keep in the pool
+ * @brief Packet slab sizing
+ *
+ * The frame class holds NETINT_PKT_FRAME_AVG_MULTIPLE average frames (at
+ * least NETINT_PKT_FRAME_MIN_SIZE). The IDR class holds the larger of what
+ * the VBV buffer and one GOP's bit budget allow, which bounds a keyframe
+ * under rate control. Both are preallocated for the packets that can be
+ * alive at once.
+ */
+#define NETINT_PKT_FRAME_AVG_MULTIPLE 4
+#define NETINT_PKT_FRAME_MIN_SIZE (64 * 1024)
+#define NETINT_PKT_IDR_PREALLOC 2
+
+/**
+ * @brief Zero-copy packet output
+ *
+ * Instead of copying each packet out of enc.output_pkt, the filled buffer is
+ * handed to OBS and a spare one is installed for the next receive. Spares
+ * carry NETINT_ZC_HEADROOM bytes in front of p_data so SPS/PPS and merged
+ * header-only packets can be written in front of the payload. The card
+ * writes a packet of any size into the installed buffer, so spares are
+ * always NI_LOGAN_MAX_TX_SZ; memory is bounded by their number instead: at
+ * most the pipeline depth (and never more than NETINT_ZC_MAX_BUFFERS) are in
+ * circulation, and when none is spare the packet is copied as before. If
+ * libxcoder replaced the installed buffer, its headroom is gone and the
+ * packet is copied too.
+ */
+#define NETINT_ZC_MAX_BUFFERS 8
+#define NETINT_ZC_MIN_BUFFERS 2
+#define NETINT_ZC_HEADROOM 4096
+
+/**
+ * @brief IO thread receive poll interval while frames are in flight
+ *
+ * Bounds how long a finished packet can sit in the card with no new frame
+ * from OBS to wake the IO thread.
+ */
+#define NETINT_IO_POLL_INTERVAL_MS 2
+
+/** Wait forever in netint_dequeue_job() */
+#define NETINT_WAIT_INFINITE (-1L)
+
+/** Longest get_extra_data() waits for headers from the first packet */
+#define NETINT_HEADER_WAIT_MS 5000
+
+/**
+ * @brief Staging surface pairs per texture-input encoder
+ *
+ * Frame N is staged on the GPU while frame N-1 is mapped and copied, so the
+ * map never waits for a copy issued in the same call.
+ */
+#define NETINT_TEX_STAGE_DEPTH 2
+
+/**
+ * @brief One GPU->host staging slot (NV12: R8 + R8G8, P010: R16 + RG16 surfaces)
  */
-#define NETINT_PKT_POOL_MIN_CAPACITY 8
+struct netint_tex_stage {
+    gs_stagesurf_t *y;                /**< Luma staging surface */
+    gs_stagesurf_t *uv;               /**< Interleaved chroma staging surface */
+    int64_t pts;                      /**< Timestamp of the staged frame */
+};
 
 /**
  * @brief Encoder context structure - stores all state for a single encoder instance
@@ -155,6 +300,25 @@ typedef enum {
     NETINT_ENCODER_STATE_RECOVERING   /**< Encoder is attempting recovery */
 } netint_encoder_state_t;
 
+/**
+ * @brief "pipeline_depth" setting
+ */
+enum netint_pipeline_mode {
+    NETINT_PIPELINE_AUTO,         /**< Start balanced, follow measured hardware latency */
+    NETINT_PIPELINE_LOW_LATENCY,  /**< Just enough frames for the GOP's reordering */
+    NETINT_PIPELINE_BALANCED,     /**< Reordering plus two frames of headroom */
+    NETINT_PIPELINE_THROUGHPUT,   /**< Deep pipeline for heavily shared cards */
+};
+
+/**
+ * @brief "overload_policy" setting: what a new frame does when the pipeline is full
+ */
+enum netint_overload_policy {
+    NETINT_OVERLOAD_BLOCK,        /**< Wait for the card (stalls the OBS encode thread) */
+    NETINT_OVERLOAD_DROP_OLDEST,  /**< Discard the oldest queued non-key frame to make room */
+    NETINT_OVERLOAD_SKIP,         /**< Refuse the new frame */
+};
+
 struct netint_roi_entry {
     uint32_t self_size;
     int32_t top;
@@ -170,6 +334,7 @@ struct netint_roi_entry {
 struct netint_roi_fill_ctx {
     struct netint_roi_entry *entries;
     size_t index;
+    size_t capacity;
     uint32_t width;
     uint32_t height;
 };
@@ -183,16 +348,40 @@ static inline uint32_t netint_clamp_u32(uint32_t value, uint32_t min_val, uint32
     return value;
 }
 
-static void netint_roi_count_cb(void *param, struct obs_encoder_roi *roi)
+static inline bool netint_input_format_is_10bit(enum video_format format)
+{
+    return format == VIDEO_FORMAT_P010 || format == VIDEO_FORMAT_I010;
+}
+
+static const char *netint_input_format_name(enum video_format format)
 {
-    UNUSED_PARAMETER(roi);
-    size_t *count = param;
-    (*count)++;
+    switch (format) {
+    case VIDEO_FORMAT_NV12:
+        return "NV12";
+    case VIDEO_FORMAT_P010:
+        return "P010";
+    case VIDEO_FORMAT_I010:
+        return "I010";
+    default:
+        return "I420";
+    }
 }
 
 static void netint_roi_fill_cb(void *param, struct obs_encoder_roi *roi)
 {
     struct netint_roi_fill_ctx *ctx = param;
+
+    /* Single pass: grow the map when a filter adds regions (rare) */
+    if (ctx->index == ctx->capacity) {
+        size_t capacity = ctx->capacity ? ctx->capacity * 2 : 8;
+        struct netint_roi_entry *entries = brealloc(ctx->entries, capacity * sizeof(*entries));
+        if (!entries) {
+            return;
+        }
+        ctx->entries = entries;
+        ctx->capacity = capacity;
+    }
+
     struct netint_roi_entry *entry = &ctx->entries[ctx->index++];
 
     uint32_t max_height = ctx->height ? ctx->height : 1;
@@ -221,34 +410,56 @@ static void netint_roi_fill_cb(void *param, struct obs_encoder_roi *roi)
 struct netint_ctx {
     obs_encoder_t *encoder;           /**< OBS encoder handle (for accessing video info, etc.) */
     ni_logan_enc_context_t enc;       /**< NETINT libxcoder encoder context (hardware state) - EMBEDDED like FFmpeg does */
+    struct netint_device_lease device_lease; /**< This session's claim in the device registry */
+    struct netint_session_config session_config; /**< Session pool key, filled in before the session opens */
+    bool session_config_valid;        /**< false if the settings can't be keyed (the session is never pooled) */
     uint8_t *extra;                   /**< SPS/PPS header data (extradata) for stream initialization */
     size_t extra_size;                /**< Size of extradata in bytes */
     bool got_headers;                 /**< true if headers were obtained (either during init or from first packet) */
+    bool keep_stream_headers;         /**< A watchdog reopen keeps the extradata OBS already has */
+    pthread_mutex_t header_mutex;     /**< Guards got_headers/extra once the IO thread runs */
+    pthread_cond_t header_cond;       /**< Signalled when the IO thread stores headers */
+    bool header_sync_initialized;
+    struct netint_pkt *pkt_prefix;    /**< Non-VCL packet (headers/SEI) waiting to be merged into the next access unit (IO thread) */
+    long pkt_queue_high_water;        /**< Deepest pkt_ring seen beyond reorder_depth (IO thread) */
+    struct netint_telemetry telemetry; /**< Latency/queue histograms and throughput counters */
+    int reorder_depth;                /**< Frames the GOP structure may hold back (0 for I-P-P-P) */
     bool flushing;                    /**< true when encoder is being flushed (no more input frames) */
     
     /* Background worker that manages both send and receive with pipelining */
     pthread_t io_thread;              /**< Background thread that handles encode_send/receive */
-    pthread_mutex_t queue_mutex;      /**< Protects packet queue access ONLY */
-    pthread_mutex_t frame_queue_mutex; /**< Protects pending frame job queue */
-    pthread_cond_t frame_queue_cond;  /**< Signals availability of frame jobs */
-    bool queue_mutex_initialized;
-    bool frame_queue_mutex_initialized;
-    bool frame_queue_cond_initialized;
+    struct netint_ring job_ring;      /**< Frame jobs ready for send (OBS thread -> IO thread) */
+    struct netint_ring pkt_ring;      /**< Encoded packets (IO thread -> OBS thread) */
+    struct netint_ring pkt_free_ring; /**< Delivered packets handed back to the IO thread for reuse */
+    bool rings_initialized;
     volatile bool stop_thread;        /**< Signal to background thread to stop */
     bool thread_created;              /**< true if io_thread was successfully created */
-    struct netint_pkt *pkt_queue_head; /**< Head of packet queue (oldest packet) */
-    struct netint_pkt *pkt_queue_tail; /**< Tail of packet queue (newest packet) */
-    struct netint_pkt *pkt_pool_head;  /**< Pool of reusable packet buffers */
+    struct netint_reactor_client io_client; /**< Shared IO worker registration (NETINT_IO_REACTOR) */
+    bool io_attached;                 /**< IO runs on the reactor instead of io_thread */
+    struct netint_pkt *pkt_backlog;   /**< Packet waiting for room in pkt_ring (reactor mode) */
+    int numa_node;                    /**< NUMA node of the device, -1 = unknown (netint-numa.h) */
+    struct netint_pkt_slab pkt_slabs[NETINT_PKT_CLASS_COUNT]; /**< Reusable packet buffers by size class */
     struct netint_pkt *last_delivered_pkt; /**< Packet most recently delivered to OBS */
-    int pkt_pool_size;                 /**< Current number of packets in pool */
-    int pkt_pool_capacity;             /**< Maximum packets retained in pool */
-
-    struct netint_frame_job *frame_queue_head; /**< Pending frame jobs (host buffers ready for send) */
-    struct netint_frame_job *frame_queue_tail;
-    int pending_jobs;                 /**< Number of queued frame jobs */
-    int inflight_frames;              /**< Count of frames submitted to HW but not yet drained */
-    int max_inflight;                 /**< Maximum frames to keep in-flight before draining */
-    int max_pipeline_depth;           /**< Hard ceiling for (pending_jobs + inflight_frames) */
+    bool zero_copy;                    /**< Hand libxcoder's output buffers to OBS (NETINT_ZERO_COPY=0 disables) */
+    struct netint_frame_group *frame_group; /**< Shared uploads with same-layout encoders (NETINT_SHARED_UPLOAD=0 disables) */
+    uint64_t shared_frames;            /**< Frames taken from another encoder's upload */
+    struct netint_zc_buf *zc_out;      /**< Describes the buffer installed in enc.output_pkt (IO thread) */
+    struct netint_zc_buf *zc_free;     /**< Spare output buffers (IO thread) */
+    int zc_buffers;                    /**< Spare buffers allocated so far */
+
+    volatile long inflight_frames;    /**< Frames submitted to HW but not yet drained (written by IO thread) */
+    int max_inflight;                 /**< Frames allowed in flight in the card (IO thread after create) */
+    volatile long max_pipeline_depth; /**< Hard ceiling for (queued jobs + inflight_frames) */
+    enum netint_pipeline_mode pipeline_mode;
+    enum netint_overload_policy overload_policy;
+    volatile long pending_drops;      /**< Queued jobs the IO thread should discard (drop_oldest) */
+    uint64_t next_overload_signal_ns; /**< Rate limit for netint_t4xx_overload (OBS thread) */
+    uint64_t frame_interval_ns;       /**< Nominal frame duration, for latency -> frames conversion */
+    int64_t send_pts[NETINT_LATENCY_SLOTS];     /**< PTS of recently sent frames (IO thread) */
+    uint64_t send_time_ns[NETINT_LATENCY_SLOTS]; /**< When each of them was sent, 0 = slot free */
+    uint64_t hw_latency_ns;           /**< Smoothed send -> packet latency (IO thread) */
+    int adapt_countdown;              /**< Packets until the next auto depth evaluation */
+    int shrink_votes;                 /**< Consecutive evaluations that wanted a shallower pipeline */
     uint64_t frames_submitted;        /**< Total frames enqueued (for start-of-stream decisions) */
 
     /* Reusable frame job pool */
@@ -256,22 +467,31 @@ struct netint_ctx {
     bool job_pool_mutex_initialized;
     struct netint_frame_job *job_pool_head; /**< Singly-linked list of available jobs */
     int job_pool_size;                /**< Current number of jobs in pool */
-    int job_pool_capacity;            /**< Maximum number of jobs preallocated */
+    int job_pool_capacity;            /**< Maximum number of jobs retained (protected by job_pool_mutex) */
+    struct netint_frame_job control_job; /**< Reserved for EOS and other control frames, never pooled */
+    volatile bool control_job_busy;   /**< control_job is queued or being sent */
 
     /* Precomputed hardware frame layout */
 	int hw_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS];
 	int hw_height[NI_LOGAN_MAX_NUM_DATA_POINTERS];
 	size_t hw_plane_size[NI_LOGAN_MAX_NUM_DATA_POINTERS];
 	size_t hw_frame_size;             /**< Total bytes for one HW-formatted frame */
+    enum video_format input_format;   /**< Raw format requested from OBS (I420/NV12, or I010/P010 for 10-bit) */
+    int bit_depth;                    /**< Sample bit depth sent to hardware (8 or 10) */
+    int bit_depth_factor;             /**< Bytes per sample in hardware planes (1 or 2) */
+    const struct netint_copy_kernels *copy_kernels; /**< Upload kernels picked for this CPU */
+    bool use_libxcoder_copy;          /**< Upload I420 through libxcoder's copy instead of copy_kernels */
 
     char *rc_mode;                     /**< Rate control mode: "CBR" or "VBR" */
     char *profile;                      /**< Encoder profile: H.264="baseline"/"main"/"high", H.265="main"/"main10" */
-    char *gop_preset;                  /**< GOP preset: "simple" (I-P-P-P) or "default" (I-B-B-B-P) */
+    char *gop_preset;                  /**< GOP preset: "simple" (I-P-P-P), "low_latency" or "default" (I-B-B-B-P) */
     bool repeat_headers;               /**< If true, attach SPS/PPS to every keyframe */
     int codec_type;                    /**< Codec type: 0 = H.264, 1 = H.265 (HEVC) */
     uint64_t frame_count;              /**< Total frames processed (for start_of_stream logic) */
     int keyint_frames;                 /**< Keyframe interval in frames */
     int vbv_buffer_ms;                 /**< VBV buffer size in milliseconds (RcInitDelay) */
+    int64_t requested_bitrate;         /**< Last target bitrate (bps) requested through netint_update */
+    volatile long pending_bitrate;     /**< Bitrate (bps) waiting for the IO thread to apply, 0 = none */
     int qp_value;                      /**< Constant QP value used when rate control is disabled */
     int qp_min;                        /**< Minimum QP when rate control enabled */
     int qp_max;                        /**< Maximum QP when rate control enabled */
@@ -279,17 +499,96 @@ struct netint_ctx {
     bool roi_enabled;                  /**< ROI functionality enabled */
     bool roi_cache;                    /**< Reuse last ROI map when not provided */
     bool roi_supported;                /**< Library exposes ROI helper APIs */
+    struct netint_roi_entry *roi_map;  /**< Converted ROI map (OBS thread) */
+    size_t roi_count;                  /**< Entries in roi_map */
+    size_t roi_capacity;               /**< Allocated entries in roi_map */
+    uint32_t roi_increment;            /**< obs_encoder_get_roi_increment() roi_map was built for */
+    bool roi_map_valid;                /**< roi_map reflects roi_increment */
+    bool roi_queued;                   /**< The current map was attached to a job (roi_cache only) */
+    bool roi_encoder_has_map;          /**< Last map sent to the encoder was non-empty (roi_cache only) */
+    volatile bool roi_resend;          /**< A watchdog reopen started a session without a map (any thread) */
+    volatile bool roi_lost;            /**< A job carrying the map failed to send (roi_cache only, any thread) */
 
     /* Error tracking and health monitoring */
     int consecutive_errors;            /**< Count of consecutive errors (reset on success) */
     int total_errors;                  /**< Total error count since encoder creation */
     uint64_t encoder_start_time;       /**< Timestamp (os_gettime_ns) when encoder was created */
+
+    /* Watchdog and in-place recovery (IO thread unless noted) */
+    netint_encoder_state_t encoder_state;
+    volatile bool encoder_failed;      /**< Recovery gave up; encode() reports it to OBS */
+    int recovery_attempts;             /**< Reopens since the stream last ran ENCODER_HANG_TIMEOUT_SEC cleanly */
+    uint64_t watchdog_ns;              /**< Stall threshold, 0 = off */
+    uint64_t last_packet_ns;           /**< When the last packet was queued */
+    uint64_t recovery_start_ns;        /**< When the last stall was detected */
+    uint64_t recovered_ns;             /**< When the stream resumed after it */
+    bool restart_stream;               /**< Next frame starts the reopened session (IDR) */
+    bool device_pinned;                /**< The user picked the device: no failover */
+    struct netint_device_request device_request; /**< Placement used at create, reused for failover */
+    ni_logan_enc_context_t enc_template; /**< enc as configured before the session opened (no device names) */
+    pthread_t recovery_thread;         /**< Runs the reopen while the IO client is parked */
+    bool recovery_thread_started;      /**< recovery_thread has to be joined */
+    volatile bool reopening;           /**< A reopen is running: IO rounds do nothing */
+
+    /* GPU texture input (encode_texture2 variants only) */
+    bool texture_input;                /**< Frames arrive as OBS NV12/P010 textures */
+    struct netint_tex_stage tex_stage[NETINT_TEX_STAGE_DEPTH];
+    int tex_stage_read;                /**< Slot holding the oldest staged frame */
+    int tex_stage_count;               /**< Slots staged but not yet uploaded */
+
+    /* ABR ladder (ladder encoders only) */
+    struct netint_ladder *ladder;      /**< Extra renditions fed from this session's uploads */
     
 #ifdef DEBUG_NETINT_PLUGIN
     uint32_t debug_magic;             /**< Magic number for validation */
 #endif
 };
 
+/** Extra renditions a ladder encoder can carry next to its own */
+#define NETINT_LADDER_MAX_RENDITIONS 3
+#define NETINT_LADDER_DEFAULT_RENDITIONS "1280x720:3000,854x480:1200"
+
+/**
+ * @brief Size and bitrate of one ladder rendition session
+ */
+struct netint_rendition {
+    int width;
+    int height;
+    int64_t bit_rate;                  /**< bps */
+};
+
+/**
+ * @brief One extra rendition: its session plus the worker that scales into it
+ */
+struct netint_ladder_rung {
+    struct netint_ctx *ctx;
+    struct netint_scaler scaler;
+    pthread_t thread;
+    bool thread_created;
+    os_sem_t *start;                   /**< Posted by the OBS thread with a frame to scale */
+    os_sem_t *done;                    /**< Posted by the worker when the frame is scaled */
+    volatile bool stop;
+    int src_stride[3];                 /**< hw_stride of the ladder's own session */
+
+    /* Handed over with start, read back after done */
+    const ni_logan_frame_t *src;
+    struct netint_frame_job *job;
+};
+
+/**
+ * @brief Renditions of a ladder encoder
+ *
+ * The ladder's own session encodes the full-size frame OBS hands it; each rung
+ * is scaled from that session's hardware buffer and encoded by a session of
+ * its own, placed on the least loaded die.
+ */
+struct netint_ladder {
+    struct netint_ctx *main;
+    int count;
+    struct netint_ladder_rung rungs[NETINT_LADDER_MAX_RENDITIONS];
+    struct netint_ladder *next;        /**< Registry of live ladders, for the info proc */
+};
+
 /**
  * @brief Get the display name for H.264 encoder
  * 
@@ -320,31 +619,68 @@ static const char *netint_h265_get_name(void *type_data)
     return "NETINT T4XX H.265";
 }
 
+static const char *netint_h264_tex_get_name(void *type_data)
+{
+    UNUSED_PARAMETER(type_data);
+    return "NETINT T4XX H.264 (Texture)";
+}
+
+static const char *netint_h265_tex_get_name(void *type_data)
+{
+    UNUSED_PARAMETER(type_data);
+    return "NETINT T4XX H.265 (Texture)";
+}
+
+static const char *netint_h264_ladder_get_name(void *type_data)
+{
+    UNUSED_PARAMETER(type_data);
+    return "NETINT T4XX H.264 (ABR Ladder)";
+}
+
+static const char *netint_h265_ladder_get_name(void *type_data)
+{
+    UNUSED_PARAMETER(type_data);
+    return "NETINT T4XX H.265 (ABR Ladder)";
+}
+
 /* Forward declarations */
 static void netint_destroy(void *data);
 static void *netint_io_thread(void *data);
+static enum netint_reactor_next netint_io_service(void *data);
 static bool netint_enqueue_job(struct netint_ctx *ctx, struct netint_frame_job *job, bool count_frame);
-static struct netint_frame_job *netint_dequeue_job(struct netint_ctx *ctx, bool wait_for_job);
+static struct netint_frame_job *netint_dequeue_job(struct netint_ctx *ctx, long timeout_ms);
 static void netint_destroy_job_pool(struct netint_ctx *ctx);
 static bool netint_init_job_pool(struct netint_ctx *ctx);
+static bool netint_init_buffer_pools(void *data);
 static struct netint_frame_job *netint_acquire_job(struct netint_ctx *ctx, bool require_buffer);
 static void netint_release_job(struct netint_ctx *ctx, struct netint_frame_job *job);
 static struct netint_pkt *netint_acquire_packet(struct netint_ctx *ctx, size_t required_size);
 static void netint_release_packet(struct netint_ctx *ctx, struct netint_pkt *pkt);
-static void netint_release_packet_locked(struct netint_ctx *ctx, struct netint_pkt *pkt);
+static void netint_return_packet(struct netint_ctx *ctx, struct netint_pkt *pkt);
 static void netint_destroy_packet_pool(struct netint_ctx *ctx);
+static void netint_zc_destroy(struct netint_ctx *ctx);
+static void netint_zc_release_output(struct netint_ctx *ctx);
 static bool netint_init_packet_pool(struct netint_ctx *ctx);
 static void netint_free_packet(struct netint_pkt *pkt);
 static bool netint_job_allocate_hw_frame(struct netint_ctx *ctx, struct netint_frame_job *job);
 static void netint_job_release_hw_frame(struct netint_frame_job *job);
 static bool netint_queue_frame(struct netint_ctx *ctx, struct encoder_frame *frame);
+static void netint_set_pipeline_depth(struct netint_ctx *ctx, int inflight);
 static bool netint_queue_eos(struct netint_ctx *ctx);
+static bool netint_tex_stage_init(struct netint_ctx *ctx);
+static void netint_tex_stage_free(struct netint_ctx *ctx);
+static bool netint_tex_upload_oldest(struct netint_ctx *ctx);
 static bool netint_hw_send_job(struct netint_ctx *ctx, struct netint_frame_job *job);
 static bool netint_hw_receive_once(struct netint_ctx *ctx);
+static void netint_pkt_queued(struct netint_ctx *ctx, int64_t pts);
 static void netint_hw_drain(struct netint_ctx *ctx, bool drain_all);
+static void netint_watchdog_check(struct netint_ctx *ctx);
+static void netint_watchdog_join(struct netint_ctx *ctx);
 static bool netint_set_encoder_param(struct netint_ctx *ctx, ni_logan_encoder_params_t *params,
                                      ni_logan_session_context_t *session_ctx,
                                      const char *name, const char *value);
+static bool netint_ladder_open(struct netint_ctx *ctx, obs_data_t *settings);
+static void netint_ladder_destroy(struct netint_ladder *ladder);
 
 /**
  * @brief Simple error logging helper
@@ -359,14 +695,15 @@ static void netint_log_error(struct netint_ctx *ctx, const char *operation, int
     
     ctx->consecutive_errors++;
     ctx->total_errors++;
+    os_atomic_inc_long(&ctx->telemetry.errors);
     
-    blog(LOG_ERROR, "[obs-netint-t4xx] %s failed with ret=%d (consecutive: %d, total: %d)",
-          operation, ret_code, ctx->consecutive_errors, ctx->total_errors);
+    netint_log(LOG_ERROR, "[obs-netint-t4xx] %s failed with ret=%d (consecutive: %d, total: %d)",
+                operation, ret_code, ctx->consecutive_errors, ctx->total_errors);
     
     /* If too many consecutive errors, warn user */
     if (ctx->consecutive_errors >= MAX_CONSECUTIVE_ERRORS) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Too many consecutive errors (%d), encoder may need recreation",
-              ctx->consecutive_errors);
+        netint_log(LOG_ERROR, "[obs-netint-t4xx] Too many consecutive errors (%d), encoder may need recreation",
+                    ctx->consecutive_errors);
     }
 }
 
@@ -397,351 +734,134 @@ static bool netint_set_encoder_param(struct netint_ctx *ctx, ni_logan_encoder_pa
     return true;
 }
 
+static inline bool netint_gop_is_low_latency(const char *gop_preset)
+{
+    return gop_preset && strcmp(gop_preset, "low_latency") == 0;
+}
+
 /**
- * @brief Create and initialize a new encoder instance
- * 
- * This function is called by OBS Studio when a user selects this encoder and configures it.
- * It performs the following operations:
- * 1. Ensures libxcoder library is loaded
- * 2. Allocates and initializes encoder context structure
- * 3. Extracts configuration from OBS settings
- * 4. Configures hardware encoder with parameters
- * 5. Opens connection to hardware device
- * 6. Extracts SPS/PPS headers for stream initialization
- * 7. Starts background thread for packet reception
- * 
- * Configuration Parameters (from settings):
- * - bitrate: Target bitrate in kbps (converted to bps for hardware)
- * - keyint: Keyframe interval in seconds (auto-calculated if not set)
- * - device: Optional device name (auto-discovered if not specified)
- * - codec: "h264" or "h265" (auto-detected from encoder codec if not set)
- * - rc_mode: "CBR" (constant bitrate) or "VBR" (variable bitrate)
- * - profile: H.264="baseline"/"main"/"high", H.265="main"/"main10"
- * - repeat_headers: If true, attach SPS/PPS to every keyframe
- * 
- * Device Selection:
- * - If device name is provided in settings, use it
- * - Otherwise, use device discovery API to find first available device
- * - If discovery fails, encoder will use default device selection
- * 
- * Error Handling:
- * - Returns NULL on any failure (library not loaded, init failed, etc.)
- * - All allocated resources are cleaned up via netint_destroy() on failure
- * - Error messages logged to OBS log with [obs-netint-t4xx] prefix
- * 
- * Threading:
- * - Creates background thread for packet reception (reduces latency)
- * - Thread is started before returning (encoder ready to use immediately)
- * 
- * @param settings OBS settings object containing encoder configuration
- * @param encoder OBS encoder handle (used to get video info, codec type, etc.)
- * @return Pointer to encoder context on success, NULL on failure
+ * @brief Configure row-based gradual intra refresh for the low latency GOP
+ *
+ * Spreads the intra rows over one keyframe interval, so a decoder joining
+ * mid-stream is fully refreshed as quickly as it would be by the IDR the
+ * refresh replaces. Rows are CTUs (64 px) for H.265 and macroblocks (16 px)
+ * for H.264.
+ *
+ * @return false if this libxcoder/firmware doesn't take the parameters; the
+ *         caller keeps periodic IDR then
  */
-static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
+static bool netint_set_intra_refresh(struct netint_ctx *ctx, ni_logan_encoder_params_t *params,
+                                     ni_logan_session_context_t *session_ctx)
 {
-    /* Check if library is loaded - if not, try to load it now */
-    /* This handles the case where plugin loaded but library wasn't available at load time */
-    if (!p_ni_logan_encode_init) {
-        if (!netint_loader_init()) {
-#ifdef _WIN32
-            blog(LOG_ERROR, "[obs-netint-t4xx] libxcoder_logan.dll not available. Cannot create encoder.");
-#else
-            blog(LOG_ERROR, "[obs-netint-t4xx] libxcoder_logan.so not available. Cannot create encoder.");
-#endif
-            return NULL;
+    const int block = (ctx->codec_type == 1) ? 64 : 16;
+    const int rows = (ctx->enc.height + block - 1) / block;
+    const int cycle = ctx->keyint_frames > 0 ? ctx->keyint_frames : 1;
+    int rows_per_frame = (rows + cycle - 1) / cycle;
+    char arg_str[16];
+
+    if (rows_per_frame < 1) {
+        rows_per_frame = 1;
+    }
+    snprintf(arg_str, sizeof(arg_str), "%d", rows_per_frame);
+
+    /* Mode 1 = row refresh, intraRefreshArg = rows per frame */
+    if (!netint_set_encoder_param(ctx, params, session_ctx, NI_LOGAN_ENC_PARAM_INTRA_REFRESH_MODE, "1") ||
+        !netint_set_encoder_param(ctx, params, session_ctx, NI_LOGAN_ENC_PARAM_INTRA_REFRESH_ARG, arg_str)) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Intra refresh not supported by this libxcoder; keeping periodic IDR");
+        netint_set_encoder_param(ctx, params, session_ctx, NI_LOGAN_ENC_PARAM_INTRA_REFRESH_MODE, "0");
+        return false;
+    }
+    blog(LOG_INFO, "[obs-netint-t4xx] Intra refresh: %d of %d rows per frame", rows_per_frame, rows);
+    return true;
+}
+
+/**
+ * @brief Keep headers the session produced as the stream's extradata
+ *
+ * During a watchdog reopen OBS already has extradata; headers from the new
+ * session are only compared with it.
+ */
+static void netint_store_headers(struct netint_ctx *ctx, const uint8_t *data, size_t size)
+{
+    if (ctx->header_sync_initialized) {
+        pthread_mutex_lock(&ctx->header_mutex);
+    }
+    if (ctx->keep_stream_headers) {
+        if (ctx->extra_size != size || memcmp(ctx->extra, data, size) != 0) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Watchdog: reopened session has different headers, "
+                              "keeping the stream's extradata");
+        }
+    } else {
+        bfree(ctx->extra);
+        ctx->extra = bmemdup(data, size);
+        ctx->extra_size = size;
+        ctx->got_headers = true;
+        if (ctx->header_sync_initialized) {
+            pthread_cond_broadcast(&ctx->header_cond);
         }
     }
+    if (ctx->header_sync_initialized) {
+        pthread_mutex_unlock(&ctx->header_mutex);
+    }
+}
 
-    /* Allocate encoder context structure - zero-initialized for safety */
-    struct netint_ctx *ctx = bzalloc(sizeof(*ctx));
-    ctx->encoder = encoder;
+/**
+ * @brief Run the open sequence for a configured context
+ *
+ * ni_logan_encode_init, VUI and encoder parameters, params_parse,
+ * encode_open and the header query, all from the fields netint_create_internal()
+ * (or a session pool warm-up) filled in. On failure the caller tears the
+ * context down.
+ */
+static bool netint_open_session(struct netint_ctx *ctx)
+{
+    /* Disable libxcoder verbose logging to avoid crashes in logging callback */
+    /* The logging callback in libxcoder v3.5.1 has issues with some format strings */
+    ctx->enc.ff_log_level = 24; /* AV_LOG_ERROR = 16, AV_LOG_WARNING = 24 */
     
-    /* Initialize error tracking */
-    ctx->consecutive_errors = 0;
-    ctx->total_errors = 0;
-    ctx->encoder_start_time = os_gettime_ns();
-    ctx->frame_count = 0;
-    ctx->frames_submitted = 0;
-    ctx->pending_jobs = 0;
-    ctx->inflight_frames = 0;
-    ctx->pkt_queue_head = NULL;
-    ctx->pkt_queue_tail = NULL;
-    ctx->frame_queue_head = NULL;
-    ctx->frame_queue_tail = NULL;
+    /* Initialize encoder context with all parameters we've set */
+    /* This validates parameters and prepares the encoder structure */
+    blog(LOG_INFO, "[obs-netint-t4xx] Calling ni_logan_encode_init with dev_xcoder='%s' dev_enc_name='%s' dev_enc_idx=%d",
+         ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "(null)",
+         ctx->enc.dev_enc_name ? ctx->enc.dev_enc_name : "(null)",
+         ctx->enc.dev_enc_idx);
+    
+    /* Validate context before API call */
+    NETINT_VALIDATE_ENC_CONTEXT(ctx, "before ni_logan_encode_init");
     
 #ifdef DEBUG_NETINT_PLUGIN
-    /* Initialize debug magic for validation - ALWAYS set this! */
-    ctx->debug_magic = NETINT_ENC_CONTEXT_MAGIC;
-    blog(LOG_INFO, "[DEBUG] Encoder context allocated at %p, size=%zu", ctx, sizeof(*ctx));
-    blog(LOG_INFO, "[DEBUG] Debug magic initialized to 0x%08X", ctx->debug_magic);
+    /* Dump enc context memory before init */
+    netint_debug_dump_memory(&ctx->enc, sizeof(ctx->enc), "enc context BEFORE init");
 #endif
-
-    /* Get video output information to determine frame rate and format */
-    video_t *video = obs_encoder_video(encoder);
-    const struct video_output_info *voi = video_output_get_info(video);
-
-    /* Zero-initialize encoder context structure (EMBEDDED, not allocated) */
-    memset(&ctx->enc, 0, sizeof(ctx->enc));
-
-    /* Set basic encoder parameters */
-    ctx->enc.dev_enc_idx = 1;  /* H/W ID 1 = encoder (H/W ID 0 = decoder) */
-    ctx->enc.keep_alive_timeout = 3;  /* Default timeout in seconds */
-    ctx->enc.set_high_priority = 0;   /* Don't set high priority by default */
     
-    /* IMPORTANT: dev_xcoder MUST be set before calling ni_logan_encode_init! */
-    /* The init function calls strcmp() on dev_xcoder, which crashes if NULL */
-    ctx->enc.dev_xcoder = (char *)bstrdup("");  /* Empty string initially */
+    /* Call with SEH guard to catch crashes */
+    int init_ret = -1;
+    NETINT_SEH_GUARDED_CALL(init_ret = p_ni_logan_encode_init(&ctx->enc), NULL);
     
-    /* Set basic video parameters from OBS encoder */
-    ctx->enc.width = (int)obs_encoder_get_width(encoder);
-    ctx->enc.height = (int)obs_encoder_get_height(encoder);
+    blog(LOG_INFO, "[obs-netint-t4xx] ni_logan_encode_init returned: %d", init_ret);
     
-    /* Get bitrate from settings and convert from kbps to bps (hardware expects bps) */
-    ctx->enc.bit_rate = (int64_t)obs_data_get_int(settings, "bitrate") * 1000;
-
-    ctx->vbv_buffer_ms = (int)obs_data_get_int(settings, "vbv_buffer_ms");
-    if (ctx->vbv_buffer_ms < 30) {
-        ctx->vbv_buffer_ms = 30;
-    } else if (ctx->vbv_buffer_ms > 6000) {
-        ctx->vbv_buffer_ms = 6000;
+    if (init_ret < 0) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize encoder (ret=%d)", init_ret);
+        NETINT_LOG_ENCODER_STATE(ctx, "AFTER failed ni_logan_encode_init");
+        goto fail;
     }
     
-    /* Device selection: try user-specified device first, then auto-discovery */
-    const char *dev_name = obs_data_get_string(settings, "device");
-    if (dev_name && *dev_name) {
-        /* User specified a device name - use it directly */
-        blog(LOG_INFO, "[obs-netint-t4xx] Using device from USER SETTINGS: '%s'", dev_name);
-        bfree(ctx->enc.dev_enc_name);
-        bfree(ctx->enc.dev_xcoder);
-        ctx->enc.dev_enc_name = (char *)bstrdup(dev_name);
-        ctx->enc.dev_xcoder = (char *)bstrdup(dev_name);
-    } else if (p_ni_logan_rsrc_init && p_ni_logan_rsrc_get_local_device_list) {
-        /* No device specified - try to discover available devices */
-        blog(LOG_INFO, "[obs-netint-t4xx] No device in settings, attempting AUTO-DISCOVERY...");
-        /* Initialize resource management system (should_match_rev=0, timeout=1s) */
-        /* Accept both SUCCESS (0) and INIT_ALREADY (0x7FFFFFFF) as success */
-        int rsrc_ret = p_ni_logan_rsrc_init(0, 1);
-        blog(LOG_INFO, "[obs-netint-t4xx] ni_logan_rsrc_init returned: %d (0x%X)", rsrc_ret, rsrc_ret);
-        if (rsrc_ret == 0 || rsrc_ret == 0x7FFFFFFF) {
-            char names[16][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
-            int n = p_ni_logan_rsrc_get_local_device_list(names, 16);
-            blog(LOG_INFO, "[obs-netint-t4xx] Found %d device(s) via auto-discovery", n);
-            if (n > 0) {
-                /* Use the first available device */
-                blog(LOG_INFO, "[obs-netint-t4xx] AUTO-DETECTED device: '%s'", names[0]);
-                bfree(ctx->enc.dev_enc_name);
-                bfree(ctx->enc.dev_xcoder);
-                ctx->enc.dev_enc_name = (char *)bstrdup(names[0]);
-                ctx->enc.dev_xcoder = (char *)bstrdup(names[0]);
-            } else {
-                blog(LOG_WARNING, "[obs-netint-t4xx] Auto-discovery found 0 devices, encoder will use default device");
-            }
-        } else {
-            blog(LOG_WARNING, "[obs-netint-t4xx] Resource init failed (ret=%d), cannot auto-discover devices", rsrc_ret);
-        }
-    } else {
-        blog(LOG_INFO, "[obs-netint-t4xx] Device discovery APIs not available, encoder will use default device");
-    }
+    /* CRITICAL CHECK: Verify that init actually allocated internal structures */
+    blog(LOG_INFO, "[obs-netint-t4xx] Verifying encoder initialization...");
+    blog(LOG_INFO, "[obs-netint-t4xx]   p_session_ctx = %p (should NOT be NULL)", ctx->enc.p_session_ctx);
+    blog(LOG_INFO, "[obs-netint-t4xx]   p_encoder_params = %p (should NOT be NULL)", ctx->enc.p_encoder_params);
+    blog(LOG_INFO, "[obs-netint-t4xx]   input_data_fifo = %p (should NOT be NULL)", ctx->enc.input_data_fifo);
     
-    /* Keyframe interval: get from settings, or auto-calculate based on frame rate */
-    /* Default is 2 seconds worth of frames (ensures regular keyframes for seeking) */
-    int keyint_seconds = (int)obs_data_get_int(settings, "keyint");
-    if (keyint_seconds <= 0) keyint_seconds = 2; /* Default 2 seconds */
-    
-    /* Convert seconds to frames based on framerate */
-    ctx->keyint_frames = (int)(keyint_seconds * (voi->fps_num / (double)voi->fps_den));
-    if (ctx->keyint_frames < 1) {
-        ctx->keyint_frames = (int)(voi->fps_num / (double)voi->fps_den);
-        if (ctx->keyint_frames < 1) {
-            ctx->keyint_frames = 1;
-        }
-    } else if (ctx->keyint_frames > NETINT_MAX_INTRAPERIOD_FRAMES) {
-        blog(LOG_WARNING,
-             "[obs-netint-t4xx] Keyframe interval %.2f sec exceeds hardware intraPeriod limit (%d frames). Clamping.",
-             (double)keyint_seconds, NETINT_MAX_INTRAPERIOD_FRAMES);
-        ctx->keyint_frames = NETINT_MAX_INTRAPERIOD_FRAMES;
-    }
-    blog(LOG_INFO, "[obs-netint-t4xx] Keyframe interval: %d seconds = %d frames @ %.2f fps",
-         keyint_seconds, ctx->keyint_frames, voi->fps_num / (double)voi->fps_den);
-    
-    /* Set timebase for timestamps (matches OBS video output timebase) */
-    /* timebase = fps_den / fps_num (e.g., 1/30 for 30fps, 1001/30000 for 29.97fps) */
-    ctx->enc.timebase_num = (int)voi->fps_den;
-    ctx->enc.timebase_den = (int)voi->fps_num;
-    ctx->enc.ticks_per_frame = 1;
-    ctx->enc.fps_number = (int)voi->fps_num;
-    ctx->enc.fps_denominator = (int)voi->fps_den;
-    blog(LOG_INFO, "[obs-netint-t4xx] Encoder timebase=%d/%d fps=%d/%d",
-         ctx->enc.timebase_num, ctx->enc.timebase_den,
-         ctx->enc.fps_number, ctx->enc.fps_denominator);
-    
-    /* Codec selection: Determined by which encoder registration OBS used */
-    /* OBS will call the appropriate create function based on encoder ID */
-    const char *codec_str = obs_encoder_get_codec(encoder);
-    
-    blog(LOG_INFO, "[obs-netint-t4xx] Codec from OBS encoder registration: '%s'", 
-         codec_str ? codec_str : "(null)");
-    
-    /* Set codec format based on OBS encoder registration */
-    /* Store codec type in context for later use (keyframe detection, packet parsing) */
-    if (codec_str && strcmp(codec_str, "hevc") == 0) {
-        ctx->codec_type = 1; /* H.265 (HEVC) */
-        ctx->enc.codec_format = 1; /* NI_LOGAN_CODEC_FORMAT_H265 */
-        blog(LOG_INFO, "[obs-netint-t4xx] Codec selected: H.265 (HEVC) - codec_type=1, codec_format=1");
-    } else {
-        ctx->codec_type = 0; /* H.264 (AVC) */
-        ctx->enc.codec_format = 0; /* NI_LOGAN_CODEC_FORMAT_H264 */
-        blog(LOG_INFO, "[obs-netint-t4xx] Codec selected: H.264 (AVC) - codec_type=0, codec_format=0");
-    }
-    
-    /* Set pixel format - currently only YUV420P is supported */
-    /* YUV420P = Planar YUV 4:2:0 (separate Y, U, V planes) */
-    ctx->enc.pix_fmt = NI_LOGAN_PIX_FMT_YUV420P;
-
-    memset(ctx->hw_stride, 0, sizeof(ctx->hw_stride));
-    memset(ctx->hw_height, 0, sizeof(ctx->hw_height));
-	memset(ctx->hw_plane_size, 0, sizeof(ctx->hw_plane_size));
-
-    int bit_depth_factor = 1; /* Only 8-bit supported by OBS today */
-    int is_h264 = (ctx->codec_type == 0) ? 1 : 0;
-    p_ni_logan_get_hw_yuv420p_dim(ctx->enc.width, ctx->enc.height, bit_depth_factor, is_h264,
-                                  ctx->hw_stride, ctx->hw_height);
-
-    ctx->hw_frame_size = 0;
-    for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-        if (ctx->hw_stride[i] > 0 && ctx->hw_height[i] > 0) {
-            ctx->hw_plane_size[i] = (size_t)ctx->hw_stride[i] * (size_t)ctx->hw_height[i];
-            ctx->hw_frame_size += ctx->hw_plane_size[i];
-        } else {
-            ctx->hw_plane_size[i] = 0;
-        }
-    }
-
-    ctx->max_inflight = 8; /* Allow up to 8 frames queued in hardware before draining */
-    ctx->max_pipeline_depth = 0; /* Will finalize after job pool init */
-
-    if (!netint_init_packet_pool(ctx)) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize packet pool");
-        goto fail;
-    }
-
-    if (!netint_init_job_pool(ctx)) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize frame job pool");
-        goto fail;
-    }
-
-    ctx->max_pipeline_depth = ctx->job_pool_capacity;
-    if (ctx->max_pipeline_depth < ctx->max_inflight) {
-        ctx->max_pipeline_depth = ctx->max_inflight;
-    }
-    
-    /* Initialize color space parameters (required by library) */
-    ctx->enc.color_primaries = 2;  /* NI_COL_PRI_UNSPECIFIED */
-    ctx->enc.color_trc = 2;        /* NI_COL_TRC_UNSPECIFIED */
-    ctx->enc.color_space = 2;      /* NI_COL_SPC_UNSPECIFIED */
-    ctx->enc.color_range = 0;      /* NI_COL_RANGE_UNSPECIFIED */
-    
-    /* Initialize sample aspect ratio (1:1 = square pixels) */
-    ctx->enc.sar_num = 1;
-    ctx->enc.sar_den = 1;
-    
-    /* Store rate control mode, profile, and GOP preset strings (used later for parameter setting) */
-    ctx->rc_mode = bstrdup(obs_data_get_string(settings, "rc_mode"));
-    ctx->profile = bstrdup(obs_data_get_string(settings, "profile"));
-    ctx->gop_preset = bstrdup(obs_data_get_string(settings, "gop_preset"));
-    
-    /* Repeat headers setting: if true, attach SPS/PPS to every keyframe */
-    /* This is useful for streaming where clients may join mid-stream */
-    ctx->repeat_headers = obs_data_get_bool(settings, "repeat_headers");
-    ctx->qp_value = (int)obs_data_get_int(settings, "qp");
-    if (ctx->qp_value < 0)
-        ctx->qp_value = 0;
-    else if (ctx->qp_value > 51)
-        ctx->qp_value = 51;
-
-    ctx->qp_min = (int)obs_data_get_int(settings, "qp_min");
-    if (ctx->qp_min < 0)
-        ctx->qp_min = 0;
-    else if (ctx->qp_min > 51)
-        ctx->qp_min = 51;
-
-    ctx->qp_max = (int)obs_data_get_int(settings, "qp_max");
-    if (ctx->qp_max < 0)
-        ctx->qp_max = 0;
-    else if (ctx->qp_max > 51)
-        ctx->qp_max = 51;
-
-    if (ctx->qp_min > ctx->qp_max) {
-        int tmp = ctx->qp_min;
-        ctx->qp_min = ctx->qp_max;
-        ctx->qp_max = tmp;
-    }
-
-    ctx->roi_supported = (p_ni_logan_enc_prep_aux_data != NULL);
-    ctx->roi_enabled = obs_data_get_bool(settings, "roi_enable") && ctx->roi_supported;
-    ctx->roi_cache = obs_data_get_bool(settings, "roi_cache") && ctx->roi_enabled;
-    if (obs_data_get_bool(settings, "roi_enable") && !ctx->roi_supported) {
-        blog(LOG_WARNING, "[obs-netint-t4xx] ROI was requested but libxcoder lacks ni_logan_enc_prep_aux_data; disabling ROI");
-    }
-    if (ctx->codec_type == 1) {
-        ctx->lossless = obs_data_get_bool(settings, "lossless");
-        if (ctx->lossless && (!ctx->rc_mode || strcmp(ctx->rc_mode, "DISABLED") != 0)) {
-            blog(LOG_WARNING, "[obs-netint-t4xx] Lossless requested but rate control not disabled; lossless will be ignored");
-        }
-    } else {
-        ctx->lossless = false;
-    }
-    if (ctx->repeat_headers) {
-        ctx->enc.spsPpsAttach = 1;
-    }
-
-    /* Disable libxcoder verbose logging to avoid crashes in logging callback */
-    /* The logging callback in libxcoder v3.5.1 has issues with some format strings */
-    ctx->enc.ff_log_level = 24; /* AV_LOG_ERROR = 16, AV_LOG_WARNING = 24 */
-    
-    /* Initialize encoder context with all parameters we've set */
-    /* This validates parameters and prepares the encoder structure */
-    blog(LOG_INFO, "[obs-netint-t4xx] Calling ni_logan_encode_init with dev_xcoder='%s' dev_enc_name='%s' dev_enc_idx=%d",
-         ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "(null)",
-         ctx->enc.dev_enc_name ? ctx->enc.dev_enc_name : "(null)",
-         ctx->enc.dev_enc_idx);
-    
-    /* Validate context before API call */
-    NETINT_VALIDATE_ENC_CONTEXT(ctx, "before ni_logan_encode_init");
-    
-#ifdef DEBUG_NETINT_PLUGIN
-    /* Dump enc context memory before init */
-    netint_debug_dump_memory(&ctx->enc, sizeof(ctx->enc), "enc context BEFORE init");
-#endif
-    
-    /* Call with SEH guard to catch crashes */
-    int init_ret = -1;
-    NETINT_SEH_GUARDED_CALL(init_ret = p_ni_logan_encode_init(&ctx->enc), NULL);
-    
-    blog(LOG_INFO, "[obs-netint-t4xx] ni_logan_encode_init returned: %d", init_ret);
-    
-    if (init_ret < 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize encoder (ret=%d)", init_ret);
-        NETINT_LOG_ENCODER_STATE(ctx, "AFTER failed ni_logan_encode_init");
-        goto fail;
-    }
-    
-    /* CRITICAL CHECK: Verify that init actually allocated internal structures */
-    blog(LOG_INFO, "[obs-netint-t4xx] Verifying encoder initialization...");
-    blog(LOG_INFO, "[obs-netint-t4xx]   p_session_ctx = %p (should NOT be NULL)", ctx->enc.p_session_ctx);
-    blog(LOG_INFO, "[obs-netint-t4xx]   p_encoder_params = %p (should NOT be NULL)", ctx->enc.p_encoder_params);
-    blog(LOG_INFO, "[obs-netint-t4xx]   input_data_fifo = %p (should NOT be NULL)", ctx->enc.input_data_fifo);
-    
-#ifdef DEBUG_NETINT_PLUGIN
-    /* DEBUG: Show struct memory layout */
-    blog(LOG_DEBUG, "[obs-netint-t4xx] ========================================");
-    blog(LOG_DEBUG, "[obs-netint-t4xx] STRUCT LAYOUT DEBUG:");
-    blog(LOG_DEBUG, "[obs-netint-t4xx]   &ctx->enc = %p (base address)", &ctx->enc);
-    blog(LOG_DEBUG, "[obs-netint-t4xx]   &ctx->enc.input_data_fifo = %p (field offset = %zu bytes)", 
-         &ctx->enc.input_data_fifo, (char*)&ctx->enc.input_data_fifo - (char*)&ctx->enc);
-    blog(LOG_DEBUG, "[obs-netint-t4xx]   sizeof(ni_logan_enc_context_t) in plugin = %zu bytes", sizeof(ctx->enc));
-    blog(LOG_DEBUG, "[obs-netint-t4xx] ========================================");
-#endif
+#ifdef DEBUG_NETINT_PLUGIN
+    /* DEBUG: Show struct memory layout */
+    blog(LOG_DEBUG, "[obs-netint-t4xx] ========================================");
+    blog(LOG_DEBUG, "[obs-netint-t4xx] STRUCT LAYOUT DEBUG:");
+    blog(LOG_DEBUG, "[obs-netint-t4xx]   &ctx->enc = %p (base address)", &ctx->enc);
+    blog(LOG_DEBUG, "[obs-netint-t4xx]   &ctx->enc.input_data_fifo = %p (field offset = %zu bytes)", 
+         &ctx->enc.input_data_fifo, (char*)&ctx->enc.input_data_fifo - (char*)&ctx->enc);
+    blog(LOG_DEBUG, "[obs-netint-t4xx]   sizeof(ni_logan_enc_context_t) in plugin = %zu bytes", sizeof(ctx->enc));
+    blog(LOG_DEBUG, "[obs-netint-t4xx] ========================================");
+#endif
     
     if (!ctx->enc.p_session_ctx || !ctx->enc.p_encoder_params || !ctx->enc.input_data_fifo) {
         blog(LOG_ERROR, "[obs-netint-t4xx] CRITICAL: ni_logan_encode_init returned success but didn't allocate internal structures!");
@@ -812,10 +932,14 @@ static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
         /* Set GOP preset based on user preference */
         const char *gop_value = "5";  /* Default: GOP 5 (I-B-B-B-P, best quality) */
         const char *gop_desc = "default (I-B-B-B-P)";
+        const bool low_latency = netint_gop_is_low_latency(ctx->gop_preset);
         
         if (ctx->gop_preset && strcmp(ctx->gop_preset, "simple") == 0) {
             gop_value = "2";  /* GOP 2 (I-P-P-P, no B-frames, lower latency) */
             gop_desc = "simple (I-P-P-P, no B-frames)";
+        } else if (low_latency) {
+            gop_value = "2";  /* Same I-P-P-P structure, plus lowDelay and intra refresh below */
+            gop_desc = "low latency (I-P-P-P, low delay)";
         }
         
         if (!netint_set_encoder_param(ctx, params, session_ctx, "gopPresetIdx", gop_value)) {
@@ -840,7 +964,25 @@ static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
             blog(LOG_INFO, "[obs-netint-t4xx] ROI cache enabled (encoder will reuse previous ROI map when absent)");
         }
 
-        if (ctx->keyint_frames > 0) {
+        /* Low latency: packets leave as soon as each frame is coded, and the
+         * periodic IDR is replaced by intra refresh where the firmware has it,
+         * so no single frame carries a full intra picture's bitrate spike */
+        bool intra_refresh = false;
+        if (low_latency) {
+            if (!netint_set_encoder_param(ctx, params, session_ctx, NI_LOGAN_ENC_PARAM_LOW_DELAY, "1")) {
+                blog(LOG_WARNING, "[obs-netint-t4xx] lowDelay not supported by this libxcoder; relying on the I-P-P-P GOP alone");
+            }
+            intra_refresh = netint_set_intra_refresh(ctx, params, session_ctx);
+        }
+
+        if (intra_refresh) {
+            if (!netint_set_encoder_param(ctx, params, session_ctx, NI_LOGAN_ENC_PARAM_INTRA_PERIOD, "0")) {
+                blog(LOG_ERROR, "[obs-netint-t4xx] Failed to disable periodic IDR for intra refresh");
+                goto fail;
+            }
+            blog(LOG_INFO, "[obs-netint-t4xx] Periodic IDR disabled: intra refresh cycles every %d frames",
+                 ctx->keyint_frames);
+        } else if (ctx->keyint_frames > 0) {
             char intraperiod_str[32];
             snprintf(intraperiod_str, sizeof(intraperiod_str), "%d", ctx->keyint_frames);
             if (!netint_set_encoder_param(ctx, params, session_ctx, "intraPeriod", intraperiod_str)) {
@@ -1035,17 +1177,17 @@ static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
     blog(LOG_INFO, "[obs-netint-t4xx] After params_parse: extradata=%p, extradata_size=%d", 
          ctx->enc.extradata, ctx->enc.extradata_size);
     
+    bool session_headers = false;
     if (ctx->enc.extradata && ctx->enc.extradata_size > 0) {
         /* Headers were successfully generated - use them */
-        ctx->extra = bmemdup(ctx->enc.extradata, (size_t)ctx->enc.extradata_size);
-        ctx->extra_size = (size_t)ctx->enc.extradata_size;
-        blog(LOG_INFO, "[obs-netint-t4xx] Headers generated during init, size: %zu bytes", ctx->extra_size);
-        ctx->got_headers = true;
+        netint_store_headers(ctx, ctx->enc.extradata, (size_t)ctx->enc.extradata_size);
+        blog(LOG_INFO, "[obs-netint-t4xx] Headers generated during init, size: %zu bytes",
+             (size_t)ctx->enc.extradata_size);
+        session_headers = true;
     } else {
         /* Headers not generated - this is normal for some T4xx hardware/firmware versions */
         /* We'll extract them from the first encoded packet instead */
         blog(LOG_INFO, "[obs-netint-t4xx] Headers not available during init. Will extract from first encoded packet.");
-        ctx->got_headers = false;
     }
     
     /* ===================================================================
@@ -1078,1211 +1220,3783 @@ static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
     blog(LOG_INFO, "[obs-netint-t4xx] ✅ Encoder session opened and configured!");
     blog(LOG_INFO, "[obs-netint-t4xx] Hardware is now ready to accept frames");
 
+    /* Ask the card for VPS/SPS/PPS now, so outputs don't have to wait for
+     * the first encoded packet before they can start */
+    if (!session_headers) {
+        int header_ret = -1;
+        NETINT_SEH_GUARDED_CALL(header_ret = p_ni_logan_encode_header(&ctx->enc), NULL);
+        if (header_ret >= 0 && ctx->enc.extradata && ctx->enc.extradata_size > 0) {
+            netint_store_headers(ctx, ctx->enc.extradata, (size_t)ctx->enc.extradata_size);
+            session_headers = true;
+        } else if (header_ret >= 0 && ctx->enc.p_spsPpsHdr && ctx->enc.spsPpsHdrLen > 0) {
+            netint_store_headers(ctx, ctx->enc.p_spsPpsHdr, (size_t)ctx->enc.spsPpsHdrLen);
+            session_headers = true;
+        }
+
+        if (session_headers) {
+            blog(LOG_INFO, "[obs-netint-t4xx] Headers generated after open, size: %zu bytes", ctx->extra_size);
+        } else {
+            blog(LOG_INFO, "[obs-netint-t4xx] encode_header returned %d without headers, will extract from first packet",
+                 header_ret);
+        }
+    }
+
     /* encode_send() expects started=1 if session already opened */
     ctx->enc.started = 1;
+    return true;
 
-    blog(LOG_INFO, "[obs-netint-t4xx] Encoder initialization complete!");
-    blog(LOG_INFO, "[obs-netint-t4xx] Headers will be extracted from first encoded packet");
+fail:
+    return false;
+}
 
-    /* ===================================================================
-     * Initialize background receive thread
-     * ===================================================================
-     * 
-     * CRITICAL: The background thread is NECESSARY because encode_receive()
-     * blocks internally. Hardware won't process frames until output is drained!
-     */
-    
-    if (pthread_mutex_init(&ctx->queue_mutex, NULL) != 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize packet queue mutex");
-        netint_destroy(ctx);
+/**
+ * @brief NETINT_HIGH_PRIORITY=1: have libxcoder raise its own priority (enc.set_high_priority)
+ */
+static bool netint_high_priority_requested(void)
+{
+    const char *env = getenv("NETINT_HIGH_PRIORITY");
+    return env && strcmp(env, "1") == 0;
+}
+
+/**
+ * @brief Fill the fields netint_open_session() reads from a pool configuration
+ *
+ * Leaves the device fields and lease alone.
+ */
+static void netint_warm_session_configure(struct netint_ctx *ctx, const struct netint_session_config *config)
+{
+    ctx->enc.dev_enc_idx = 1;
+    ctx->enc.keep_alive_timeout = 3;
+    ctx->enc.set_high_priority = netint_high_priority_requested() ? 1 : 0;
+    ctx->enc.width = config->width;
+    ctx->enc.height = config->height;
+    ctx->enc.bit_rate = config->bit_rate;
+    ctx->enc.timebase_num = config->fps_den;
+    ctx->enc.timebase_den = config->fps_num;
+    ctx->enc.ticks_per_frame = 1;
+    ctx->enc.fps_number = config->fps_num;
+    ctx->enc.fps_denominator = config->fps_den;
+    ctx->enc.codec_format = config->codec_type;
+    ctx->enc.pix_fmt = (config->bit_depth > 8) ? NI_LOGAN_PIX_FMT_YUV420P10LE : NI_LOGAN_PIX_FMT_YUV420P;
+    ctx->enc.color_primaries = config->color_primaries;
+    ctx->enc.color_trc = config->color_trc;
+    ctx->enc.color_space = config->color_space;
+    ctx->enc.color_range = config->color_range;
+    ctx->enc.sar_num = 1;
+    ctx->enc.sar_den = 1;
+    ctx->enc.spsPpsAttach = config->repeat_headers ? 1 : 0;
+
+    bfree(ctx->rc_mode);
+    bfree(ctx->profile);
+    bfree(ctx->gop_preset);
+    ctx->codec_type = config->codec_type;
+    ctx->bit_depth = config->bit_depth;
+    ctx->rc_mode = bstrdup(config->rc_mode);
+    ctx->profile = bstrdup(config->profile);
+    ctx->gop_preset = bstrdup(config->gop_preset);
+    ctx->keyint_frames = config->keyint_frames;
+    ctx->vbv_buffer_ms = config->vbv_buffer_ms;
+    ctx->qp_value = config->qp_value;
+    ctx->qp_min = config->qp_min;
+    ctx->qp_max = config->qp_max;
+    ctx->roi_supported = (p_ni_logan_enc_prep_aux_data != NULL);
+    ctx->roi_enabled = config->roi_enabled && ctx->roi_supported;
+    ctx->roi_cache = config->roi_cache && ctx->roi_enabled;
+    ctx->lossless = config->lossless;
+    ctx->repeat_headers = config->repeat_headers;
+    ctx->requested_bitrate = config->bit_rate;
+}
+
+/**
+ * @brief Open a session for a session pool configuration
+ *
+ * The context is a bare shell: just the fields netint_open_session() reads,
+ * a device lease and the headers. It never gets rings, pools or an IO thread;
+ * netint_adopt_warm_session() moves the session into a real encoder.
+ */
+void *netint_warm_session_open(const struct netint_session_config *config)
+{
+    if (!p_ni_logan_encode_init) {
         return NULL;
     }
-    ctx->queue_mutex_initialized = true;
 
-    if (pthread_mutex_init(&ctx->frame_queue_mutex, NULL) != 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize frame queue mutex");
-        pthread_mutex_destroy(&ctx->queue_mutex);
-        ctx->queue_mutex_initialized = false;
-        netint_destroy(ctx);
-        return NULL;
+    struct netint_ctx *ctx = bzalloc(sizeof(*ctx));
+    ctx->device_lease.slot = -1;
+#ifdef DEBUG_NETINT_PLUGIN
+    ctx->debug_magic = NETINT_ENC_CONTEXT_MAGIC;
+#endif
+    netint_warm_session_configure(ctx, config);
+
+    /* Warm sessions occupy the card like any other, so they count as load */
+    struct netint_device_request device_request = {
+        .width = config->width,
+        .height = config->height,
+        .fps_num = (uint32_t)config->fps_num,
+        .fps_den = (uint32_t)config->fps_den,
+        .placement = NETINT_PLACEMENT_LEAST_LOAD,
+        .affinity_key = NULL,
+        .avoid_slot = -1,
+    };
+    char placed_name[NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    if (netint_device_acquire(&device_request, config->device, &ctx->device_lease, placed_name)) {
+        ctx->enc.dev_enc_name = (char *)bstrdup(placed_name);
+        ctx->enc.dev_xcoder = (char *)bstrdup(placed_name);
+    } else {
+        ctx->enc.dev_xcoder = (char *)bstrdup("");
     }
-    ctx->frame_queue_mutex_initialized = true;
 
-    if (pthread_cond_init(&ctx->frame_queue_cond, NULL) != 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize frame queue condition variable");
-        pthread_mutex_destroy(&ctx->frame_queue_mutex);
-        ctx->frame_queue_mutex_initialized = false;
-        pthread_mutex_destroy(&ctx->queue_mutex);
-        ctx->queue_mutex_initialized = false;
-        netint_destroy(ctx);
+    if (!netint_open_session(ctx)) {
+        netint_warm_session_close(ctx);
         return NULL;
     }
-    ctx->frame_queue_cond_initialized = true;
+    return ctx;
+}
 
-    ctx->stop_thread = false;
-    ctx->thread_created = false;
-    ctx->flushing = false;
+/**
+ * @brief Start a fresh stream on a recycled session
+ *
+ * The T4XX ends a stream instance at EOS and libxcoder has no call to start
+ * another on it, so the instance is closed and opened again with the same
+ * device and lease. Runs on the session pool thread, never on the create path.
+ */
+bool netint_warm_session_restart(void *session, const struct netint_session_config *config)
+{
+    struct netint_ctx *ctx = session;
+    char *dev_enc_name = ctx->enc.dev_enc_name;
+    char *dev_xcoder = ctx->enc.dev_xcoder;
 
-    if (pthread_create(&ctx->io_thread, NULL, netint_io_thread, ctx) != 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to create IO thread");
-        pthread_cond_destroy(&ctx->frame_queue_cond);
-        ctx->frame_queue_cond_initialized = false;
-        pthread_mutex_destroy(&ctx->frame_queue_mutex);
-        ctx->frame_queue_mutex_initialized = false;
-        pthread_mutex_destroy(&ctx->queue_mutex);
-        ctx->queue_mutex_initialized = false;
-        netint_destroy(ctx);
-        return NULL;
+    if (ctx->enc.p_session_ctx && p_ni_logan_encode_close) {
+        p_ni_logan_encode_close(&ctx->enc);
     }
 
-    ctx->thread_created = true;
-    blog(LOG_INFO, "[obs-netint-t4xx] Background IO thread started successfully");
-    blog(LOG_INFO, "[obs-netint-t4xx] Encoder creation complete (pipelined design)");
-    return ctx;
-fail:
-    /* Cleanup all allocated resources on any failure */
-    netint_destroy(ctx);
-    return NULL;
+    /* libxcoder freed its own allocations; only the device names are ours */
+    memset(&ctx->enc, 0, sizeof(ctx->enc));
+    ctx->enc.dev_enc_name = dev_enc_name;
+    ctx->enc.dev_xcoder = dev_xcoder;
+    bfree(ctx->extra);
+    ctx->extra = NULL;
+    ctx->extra_size = 0;
+    ctx->got_headers = false;
+
+    netint_warm_session_configure(ctx, config);
+    return netint_open_session(ctx);
 }
 
-/**
- * @brief Destroy encoder instance and free all resources
- * 
- * This function is called by OBS Studio when the encoder is no longer needed
- * (e.g., user changes encoder, stops streaming/recording, OBS shuts down).
- * 
- * Cleanup order is important:
- * 1. Signal background thread to stop
- * 2. Wait for thread to finish (pthread_join)
- * 3. Free all queued packets
- * 4. Destroy queue and mutex
- * 5. Close hardware encoder connection
- * 6. Free all allocated memory
+static void netint_warm_session_free(struct netint_ctx *ctx)
+{
+    bfree(ctx->enc.dev_enc_name);
+    bfree(ctx->enc.dev_xcoder);
+    bfree(ctx->extra);
+    bfree(ctx->rc_mode);
+    bfree(ctx->profile);
+    bfree(ctx->gop_preset);
+    bfree(ctx);
+}
+
+void netint_warm_session_close(void *session)
+{
+    struct netint_ctx *ctx = session;
+
+    if (!ctx) {
+        return;
+    }
+    if (ctx->enc.p_session_ctx && p_ni_logan_encode_close) {
+        p_ni_logan_encode_close(&ctx->enc);
+    }
+    netint_device_release(&ctx->device_lease);
+    netint_warm_session_free(ctx);
+}
+
+/**
+ * @brief Describe @p ctx's session for the session pool
+ *
+ * @param dev_name Device the user picked ("" or NULL = automatic)
+ * @return false if a string setting is too long to key on
+ */
+static bool netint_session_config_from_ctx(const struct netint_ctx *ctx, const char *dev_name,
+                                           struct netint_session_config *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->codec_type = ctx->codec_type;
+    config->width = ctx->enc.width;
+    config->height = ctx->enc.height;
+    config->fps_num = ctx->enc.fps_number;
+    config->fps_den = ctx->enc.fps_denominator;
+    config->bit_depth = ctx->bit_depth;
+    config->bit_rate = ctx->requested_bitrate;
+    config->vbv_buffer_ms = ctx->vbv_buffer_ms;
+    config->keyint_frames = ctx->keyint_frames;
+    config->qp_value = ctx->qp_value;
+    config->qp_min = ctx->qp_min;
+    config->qp_max = ctx->qp_max;
+    config->color_primaries = ctx->enc.color_primaries;
+    config->color_trc = ctx->enc.color_trc;
+    config->color_space = ctx->enc.color_space;
+    config->color_range = ctx->enc.color_range;
+    config->roi_enabled = ctx->roi_enabled;
+    config->roi_cache = ctx->roi_cache;
+    config->lossless = ctx->lossless;
+    config->repeat_headers = ctx->repeat_headers;
+    if ((ctx->rc_mode && strlen(ctx->rc_mode) >= sizeof(config->rc_mode)) ||
+        (ctx->profile && strlen(ctx->profile) >= sizeof(config->profile)) ||
+        (ctx->gop_preset && strlen(ctx->gop_preset) >= sizeof(config->gop_preset)) ||
+        (dev_name && strlen(dev_name) >= sizeof(config->device))) {
+        return false;
+    }
+    if (ctx->rc_mode) {
+        strcpy(config->rc_mode, ctx->rc_mode);
+    }
+    if (ctx->profile) {
+        strcpy(config->profile, ctx->profile);
+    }
+    if (ctx->gop_preset) {
+        strcpy(config->gop_preset, ctx->gop_preset);
+    }
+    if (dev_name) {
+        strcpy(config->device, dev_name);
+    }
+    return true;
+}
+
+/**
+ * @brief Take over a pre-opened or recycled session matching @p ctx
+ *
+ * Called where netint_create_internal() would open its own session, with the
+ * context fully configured and ctx->session_config filled in. The opened
+ * libxcoder context, its headers and its device lease move into @p ctx; the
+ * lease @p ctx acquired itself is dropped. Affinity-placed encoders always
+ * open their own session, since a pooled session's device was picked without
+ * knowing the canvas.
+ *
+ * The target bitrate is not part of the match when it can be changed live:
+ * a session opened for another bitrate gets this one queued for its first
+ * frame, exactly like netint_update() does.
+ *
+ * @param affinity true if the encoder asked for affinity placement
+ */
+static bool netint_adopt_warm_session(struct netint_ctx *ctx, bool affinity)
+{
+    if (affinity || !ctx->session_config_valid) {
+        return false;
+    }
+
+    bool bitrate_mutable = p_ni_logan_enc_prep_aux_data != NULL;
+    struct netint_ctx *warm = netint_session_pool_take(&ctx->session_config, !bitrate_mutable);
+    if (!warm) {
+        return false;
+    }
+
+    netint_device_release(&ctx->device_lease);
+    bfree(ctx->enc.dev_enc_name);
+    bfree(ctx->enc.dev_xcoder);
+
+    /* ni_logan_enc_context_t holds no pointers into itself, so it moves by value */
+    ctx->enc = warm->enc;
+    ctx->device_lease = warm->device_lease;
+    ctx->extra = warm->extra;
+    ctx->extra_size = warm->extra_size;
+    ctx->got_headers = warm->got_headers;
+
+    memset(&warm->enc, 0, sizeof(warm->enc));
+    warm->extra = NULL;
+    int64_t opened_bitrate = warm->requested_bitrate;
+    netint_warm_session_free(warm);
+
+    if (opened_bitrate != ctx->requested_bitrate && !(ctx->rc_mode && strcmp(ctx->rc_mode, "DISABLED") == 0)) {
+        os_atomic_set_long(&ctx->pending_bitrate, (long)ctx->requested_bitrate);
+    }
+
+    blog(LOG_INFO, "[obs-netint-t4xx] Adopted pooled session on '%s' (%dx%d, opened at %lld kbps)",
+         ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "", ctx->enc.width, ctx->enc.height,
+         (long long)(opened_bitrate / 1000));
+    return true;
+}
+
+/**
+ * @brief Hand a drained session back to the session pool instead of closing it
+ *
+ * Only sessions that finished the EOS handshake cleanly and had no errors
+ * pending are recycled. On success the libxcoder context, headers and device
+ * lease belong to the pool and @p ctx no longer refers to them.
+ */
+static bool netint_recycle_session(struct netint_ctx *ctx)
+{
+    if (!ctx->session_config_valid || !ctx->enc.p_session_ctx || !ctx->flushing || !ctx->enc.encoder_eof ||
+        ctx->consecutive_errors > 0 || os_atomic_load_bool(&ctx->encoder_failed)) {
+        return false;
+    }
+
+    struct netint_ctx *shell = bzalloc(sizeof(*shell));
+#ifdef DEBUG_NETINT_PLUGIN
+    shell->debug_magic = NETINT_ENC_CONTEXT_MAGIC;
+#endif
+    shell->enc = ctx->enc;
+    shell->device_lease = ctx->device_lease;
+    shell->extra = ctx->extra;
+    shell->extra_size = ctx->extra_size;
+    shell->got_headers = ctx->got_headers;
+    shell->requested_bitrate = ctx->requested_bitrate;
+
+    if (!netint_session_pool_recycle(&ctx->session_config, shell)) {
+        bfree(shell);
+        return false;
+    }
+
+    memset(&ctx->enc, 0, sizeof(ctx->enc));
+    ctx->device_lease.slot = -1;
+    ctx->device_lease.pixel_rate = 0;
+    ctx->device_lease.affinity_key = NULL;
+    ctx->extra = NULL;
+    ctx->extra_size = 0;
+    blog(LOG_INFO, "[obs-netint-t4xx] Session recycled for the next encoder with these settings");
+    return true;
+}
+
+/**
+ * @brief Create and initialize a new encoder instance
  * 
- * Thread Safety:
- * - This function should be called from the same thread that created the encoder
- * - Background thread is stopped before cleanup, so no concurrent access issues
+ * This function is called by OBS Studio when a user selects this encoder and configures it.
+ * It performs the following operations:
+ * 1. Ensures libxcoder library is loaded
+ * 2. Allocates and initializes encoder context structure
+ * 3. Extracts configuration from OBS settings
+ * 4. Configures hardware encoder with parameters
+ * 5. Opens connection to hardware device
+ * 6. Extracts SPS/PPS headers for stream initialization
+ * 7. Starts background thread for packet reception
  * 
- * @param data Pointer to encoder context (netint_ctx structure)
+ * Configuration Parameters (from settings):
+ * - bitrate: Target bitrate in kbps (converted to bps for hardware)
+ * - keyint: Keyframe interval in seconds (auto-calculated if not set)
+ * - device: Optional device name (auto-discovered if not specified)
+ * - codec: "h264" or "h265" (auto-detected from encoder codec if not set)
+ * - rc_mode: "CBR" (constant bitrate) or "VBR" (variable bitrate)
+ * - profile: H.264="baseline"/"main"/"high", H.265="main"/"main10"
+ * - repeat_headers: If true, attach SPS/PPS to every keyframe
+ * 
+ * Device Selection:
+ * - If device name is provided in settings, use it
+ * - Otherwise, use device discovery API to find first available device
+ * - If discovery fails, encoder will use default device selection
+ * 
+ * Error Handling:
+ * - Returns NULL on any failure (library not loaded, init failed, etc.)
+ * - All allocated resources are cleaned up via netint_destroy() on failure
+ * - Error messages logged to OBS log with [obs-netint-t4xx] prefix
+ * 
+ * Threading:
+ * - Creates background thread for packet reception (reduces latency)
+ * - Thread is started before returning (encoder ready to use immediately)
+ * 
+ * @param settings OBS settings object containing encoder configuration
+ * @param encoder OBS encoder handle (used to get video info, codec type, etc.)
+ * @param texture_input true for the encode_texture2 variants (NV12/P010 GPU textures)
+ * @param rendition Size and bitrate of a ladder rendition, or NULL for the
+ *                  encoder's own session. Rendition sessions are placed
+ *                  automatically and carry no ROI.
+ * @return Pointer to encoder context on success, NULL on failure
+ */
+static void *netint_create_internal(obs_data_t *settings, obs_encoder_t *encoder, bool texture_input,
+                                    const struct netint_rendition *rendition)
+{
+    /* Check if library is loaded - if not, try to load it now */
+    /* This handles the case where plugin loaded but library wasn't available at load time */
+    if (!p_ni_logan_encode_init) {
+        if (!netint_loader_init()) {
+#ifdef _WIN32
+            blog(LOG_ERROR, "[obs-netint-t4xx] libxcoder_logan.dll not available. Cannot create encoder.");
+#else
+            blog(LOG_ERROR, "[obs-netint-t4xx] libxcoder_logan.so not available. Cannot create encoder.");
+#endif
+            return NULL;
+        }
+    }
+
+    /* Allocate encoder context structure - zero-initialized for safety */
+    struct netint_ctx *ctx = bzalloc(sizeof(*ctx));
+    ctx->encoder = encoder;
+    if (rendition) {
+        char rendition_name[NETINT_TELEMETRY_NAME_LEN];
+        snprintf(rendition_name, sizeof(rendition_name), "%s %dx%d", obs_encoder_get_name(encoder),
+                 rendition->width, rendition->height);
+        netint_telemetry_register(&ctx->telemetry, rendition_name);
+    } else {
+        netint_telemetry_register(&ctx->telemetry, obs_encoder_get_name(encoder));
+    }
+    ctx->texture_input = texture_input;
+    ctx->device_lease.slot = -1;
+    ctx->numa_node = -1;
+    
+    /* Initialize error tracking */
+    ctx->consecutive_errors = 0;
+    ctx->total_errors = 0;
+    ctx->encoder_start_time = os_gettime_ns();
+    ctx->frame_count = 0;
+    ctx->frames_submitted = 0;
+    ctx->inflight_frames = 0;
+    
+#ifdef DEBUG_NETINT_PLUGIN
+    /* Initialize debug magic for validation - ALWAYS set this! */
+    ctx->debug_magic = NETINT_ENC_CONTEXT_MAGIC;
+    blog(LOG_INFO, "[DEBUG] Encoder context allocated at %p, size=%zu", ctx, sizeof(*ctx));
+    blog(LOG_INFO, "[DEBUG] Debug magic initialized to 0x%08X", ctx->debug_magic);
+#endif
+
+    /* Get video output information to determine frame rate and format */
+    video_t *video = obs_encoder_video(encoder);
+    const struct video_output_info *voi = video_output_get_info(video);
+
+    /* Zero-initialize encoder context structure (EMBEDDED, not allocated) */
+    memset(&ctx->enc, 0, sizeof(ctx->enc));
+
+    /* Set basic encoder parameters */
+    ctx->enc.dev_enc_idx = 1;  /* H/W ID 1 = encoder (H/W ID 0 = decoder) */
+    ctx->enc.keep_alive_timeout = 3;  /* Default timeout in seconds */
+    ctx->enc.set_high_priority = netint_high_priority_requested() ? 1 : 0; /* Off unless NETINT_HIGH_PRIORITY=1 */
+    
+    /* IMPORTANT: dev_xcoder MUST be set before calling ni_logan_encode_init! */
+    /* The init function calls strcmp() on dev_xcoder, which crashes if NULL */
+    ctx->enc.dev_xcoder = (char *)bstrdup("");  /* Empty string initially */
+    
+    /* Set basic video parameters from OBS encoder */
+    ctx->enc.width = rendition ? rendition->width : (int)obs_encoder_get_width(encoder);
+    ctx->enc.height = rendition ? rendition->height : (int)obs_encoder_get_height(encoder);
+    
+    /* Get bitrate from settings and convert from kbps to bps (hardware expects bps) */
+    ctx->enc.bit_rate = rendition ? rendition->bit_rate : (int64_t)obs_data_get_int(settings, "bitrate") * 1000;
+    ctx->requested_bitrate = ctx->enc.bit_rate;
+
+    ctx->vbv_buffer_ms = (int)obs_data_get_int(settings, "vbv_buffer_ms");
+    if (ctx->vbv_buffer_ms < 30) {
+        ctx->vbv_buffer_ms = 30;
+    } else if (ctx->vbv_buffer_ms > 6000) {
+        ctx->vbv_buffer_ms = 6000;
+    }
+    
+    /* Device selection: user-specified device, otherwise the least loaded one.
+     * Either way the session is accounted in the device registry so later
+     * sessions see it. Ladder renditions always spread by load. */
+    const char *dev_name = rendition ? "" : obs_data_get_string(settings, "device");
+    const char *placement_str = obs_data_get_string(settings, "device_placement");
+    struct netint_device_request device_request = {
+        .width = ctx->enc.width,
+        .height = ctx->enc.height,
+        .fps_num = voi->fps_num,
+        .fps_den = voi->fps_den,
+        .placement = (!rendition && placement_str && strcmp(placement_str, "affinity") == 0)
+                         ? NETINT_PLACEMENT_AFFINITY
+                         : NETINT_PLACEMENT_LEAST_LOAD,
+        .affinity_key = rendition ? NULL : obs_encoder_video(encoder),
+        .avoid_slot = -1,
+    };
+    char placed_name[NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    if (dev_name && *dev_name) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Using device from USER SETTINGS: '%s'", dev_name);
+    }
+    if (netint_device_acquire(&device_request, dev_name, &ctx->device_lease, placed_name)) {
+        bfree(ctx->enc.dev_enc_name);
+        bfree(ctx->enc.dev_xcoder);
+        ctx->enc.dev_enc_name = (char *)bstrdup(placed_name);
+        ctx->enc.dev_xcoder = (char *)bstrdup(placed_name);
+    } else {
+        blog(LOG_WARNING, "[obs-netint-t4xx] No NETINT device discovered, encoder will use default device");
+    }
+    ctx->device_request = device_request;
+    ctx->device_pinned = dev_name && *dev_name;
+    ctx->numa_node = netint_numa_device_node(placed_name);
+    if (ctx->numa_node >= 0) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Device '%s' is on NUMA node %d", placed_name, ctx->numa_node);
+    }
+    
+    /* Keyframe interval: get from settings, or auto-calculate based on frame rate */
+    /* Default is 2 seconds worth of frames (ensures regular keyframes for seeking) */
+    int keyint_seconds = (int)obs_data_get_int(settings, "keyint");
+    if (keyint_seconds <= 0) keyint_seconds = 2; /* Default 2 seconds */
+    
+    /* Convert seconds to frames based on framerate */
+    ctx->keyint_frames = (int)(keyint_seconds * (voi->fps_num / (double)voi->fps_den));
+    if (ctx->keyint_frames < 1) {
+        ctx->keyint_frames = (int)(voi->fps_num / (double)voi->fps_den);
+        if (ctx->keyint_frames < 1) {
+            ctx->keyint_frames = 1;
+        }
+    } else if (ctx->keyint_frames > NETINT_MAX_INTRAPERIOD_FRAMES) {
+        blog(LOG_WARNING,
+             "[obs-netint-t4xx] Keyframe interval %.2f sec exceeds hardware intraPeriod limit (%d frames). Clamping.",
+             (double)keyint_seconds, NETINT_MAX_INTRAPERIOD_FRAMES);
+        ctx->keyint_frames = NETINT_MAX_INTRAPERIOD_FRAMES;
+    }
+    blog(LOG_INFO, "[obs-netint-t4xx] Keyframe interval: %d seconds = %d frames @ %.2f fps",
+         keyint_seconds, ctx->keyint_frames, voi->fps_num / (double)voi->fps_den);
+    
+    /* Set timebase for timestamps (matches OBS video output timebase) */
+    /* timebase = fps_den / fps_num (e.g., 1/30 for 30fps, 1001/30000 for 29.97fps) */
+    ctx->enc.timebase_num = (int)voi->fps_den;
+    ctx->enc.timebase_den = (int)voi->fps_num;
+    ctx->enc.ticks_per_frame = 1;
+    ctx->enc.fps_number = (int)voi->fps_num;
+    ctx->enc.fps_denominator = (int)voi->fps_den;
+    blog(LOG_INFO, "[obs-netint-t4xx] Encoder timebase=%d/%d fps=%d/%d",
+         ctx->enc.timebase_num, ctx->enc.timebase_den,
+         ctx->enc.fps_number, ctx->enc.fps_denominator);
+    
+    /* Codec selection: Determined by which encoder registration OBS used */
+    /* OBS will call the appropriate create function based on encoder ID */
+    const char *codec_str = obs_encoder_get_codec(encoder);
+    
+    blog(LOG_INFO, "[obs-netint-t4xx] Codec from OBS encoder registration: '%s'", 
+         codec_str ? codec_str : "(null)");
+    
+    /* Set codec format based on OBS encoder registration */
+    /* Store codec type in context for later use (keyframe detection, packet parsing) */
+    if (codec_str && strcmp(codec_str, "hevc") == 0) {
+        ctx->codec_type = 1; /* H.265 (HEVC) */
+        ctx->enc.codec_format = 1; /* NI_LOGAN_CODEC_FORMAT_H265 */
+        blog(LOG_INFO, "[obs-netint-t4xx] Codec selected: H.265 (HEVC) - codec_type=1, codec_format=1");
+    } else {
+        ctx->codec_type = 0; /* H.264 (AVC) */
+        ctx->enc.codec_format = 0; /* NI_LOGAN_CODEC_FORMAT_H264 */
+        blog(LOG_INFO, "[obs-netint-t4xx] Codec selected: H.264 (AVC) - codec_type=0, codec_format=0");
+    }
+    
+    /* Input format: take NV12 as-is when that is what OBS renders natively.
+     * The T4XX only ingests planar YUV420, so NV12 chroma is split into the
+     * U/V hardware planes during the upload copy. This costs the same single
+     * pass as the I420 copy but saves OBS its NV12->I420 conversion.
+     *
+     * 10-bit: H.265 takes P010 (MSB-aligned, shifted down during the split)
+     * or I010 as-is and encodes Main10. H.264 on the T4XX is 8-bit only, so
+     * for 10-bit outputs OBS converts to NV12 for it. */
+    bool ten_bit_output = voi->format == VIDEO_FORMAT_P010 || voi->format == VIDEO_FORMAT_I010;
+    if (ten_bit_output && ctx->codec_type == 1) {
+        ctx->input_format = voi->format;
+    } else if (ten_bit_output) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] H.264 encoding is 8-bit only on T4XX - OBS will convert 10-bit output to NV12");
+        ctx->input_format = VIDEO_FORMAT_NV12;
+    } else if (texture_input || voi->format == VIDEO_FORMAT_NV12) {
+        ctx->input_format = VIDEO_FORMAT_NV12;
+    } else {
+        ctx->input_format = VIDEO_FORMAT_I420;
+    }
+    blog(LOG_INFO, "[obs-netint-t4xx] Input format: %s%s (OBS output format=%d)",
+         netint_input_format_name(ctx->input_format), texture_input ? " (GPU texture)" : "",
+         (int)voi->format);
+
+    ctx->bit_depth = netint_input_format_is_10bit(ctx->input_format) ? 10 : 8;
+    ctx->bit_depth_factor = (ctx->bit_depth > 8) ? 2 : 1;
+
+    /* YUV420P / YUV420P10LE = Planar YUV 4:2:0 (separate Y, U, V planes) */
+    ctx->enc.pix_fmt = (ctx->bit_depth > 8) ? NI_LOGAN_PIX_FMT_YUV420P10LE : NI_LOGAN_PIX_FMT_YUV420P;
+
+    memset(ctx->hw_stride, 0, sizeof(ctx->hw_stride));
+    memset(ctx->hw_height, 0, sizeof(ctx->hw_height));
+	memset(ctx->hw_plane_size, 0, sizeof(ctx->hw_plane_size));
+
+    /* Strides come back in bytes, already scaled for 16-bit samples */
+    int is_h264 = (ctx->codec_type == 0) ? 1 : 0;
+    p_ni_logan_get_hw_yuv420p_dim(ctx->enc.width, ctx->enc.height, ctx->bit_depth_factor, is_h264,
+                                  ctx->hw_stride, ctx->hw_height);
+
+    /* Upload kernels: picked once by CPU features. NETINT_COPY_KERNEL can force
+     * "c", "sse2", "avx2", "neon" or "libxcoder" (vendor copy, planar input only). */
+    const char *copy_kernel_env = getenv("NETINT_COPY_KERNEL");
+    ctx->use_libxcoder_copy = copy_kernel_env && strcmp(copy_kernel_env, "libxcoder") == 0 &&
+                              (ctx->input_format == VIDEO_FORMAT_I420 ||
+                               ctx->input_format == VIDEO_FORMAT_I010);
+    ctx->copy_kernels = netint_copy_select_kernels(ctx->use_libxcoder_copy ? NULL : copy_kernel_env);
+    blog(LOG_INFO, "[obs-netint-t4xx] Frame upload kernel: %s",
+         ctx->use_libxcoder_copy ? "libxcoder" : ctx->copy_kernels->name);
+
+    /* NETINT_ZERO_COPY=0 sends every packet through encode_copy_packet_data */
+    const char *zero_copy_env = getenv("NETINT_ZERO_COPY");
+    ctx->zero_copy = !(zero_copy_env && strcmp(zero_copy_env, "0") == 0);
+
+    ctx->hw_frame_size = 0;
+    for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+        if (ctx->hw_stride[i] > 0 && ctx->hw_height[i] > 0) {
+            ctx->hw_plane_size[i] = (size_t)ctx->hw_stride[i] * (size_t)ctx->hw_height[i];
+            ctx->hw_frame_size += ctx->hw_plane_size[i];
+        } else {
+            ctx->hw_plane_size[i] = 0;
+        }
+    }
+
+    /* Encoders fed from the same canvas at the same layout upload each frame
+     * once between them. Texture input reads back its own surfaces. */
+    const char *shared_upload_env = getenv("NETINT_SHARED_UPLOAD");
+    if (!texture_input && !rendition && ctx->hw_frame_size > 0 && !(shared_upload_env && strcmp(shared_upload_env, "0") == 0)) {
+        struct netint_frame_layout layout;
+        memset(&layout, 0, sizeof(layout));
+        layout.format = ctx->input_format;
+        layout.width = ctx->enc.width;
+        layout.height = ctx->enc.height;
+        layout.is_h264 = is_h264;
+        layout.bit_depth_factor = ctx->bit_depth_factor;
+        layout.extra_data_len = NETINT_FRAME_EXTRA_DATA_LEN;
+        memcpy(layout.hw_stride, ctx->hw_stride, sizeof(layout.hw_stride));
+        memcpy(layout.hw_height, ctx->hw_height, sizeof(layout.hw_height));
+        ctx->frame_group = netint_frame_cache_attach(&layout);
+    }
+
+    if (texture_input && !netint_tex_stage_init(ctx)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to create texture staging surfaces");
+        goto fail;
+    }
+
+    /* Initialize color space parameters (required by library) */
+    ctx->enc.color_primaries = 2;  /* NI_COL_PRI_UNSPECIFIED */
+    ctx->enc.color_trc = 2;        /* NI_COL_TRC_UNSPECIFIED */
+    ctx->enc.color_space = 2;      /* NI_COL_SPC_UNSPECIFIED */
+    ctx->enc.color_range = 0;      /* NI_COL_RANGE_UNSPECIFIED */
+
+    /* HDR output: signal BT.2020 with PQ/HLG so players tone-map correctly */
+    if (ctx->bit_depth > 8 &&
+        (voi->colorspace == VIDEO_CS_2100_PQ || voi->colorspace == VIDEO_CS_2100_HLG)) {
+        ctx->enc.color_primaries = 9;  /* BT.2020 */
+        ctx->enc.color_trc = (voi->colorspace == VIDEO_CS_2100_PQ) ? 16 : 18; /* SMPTE ST 2084 / ARIB STD-B67 */
+        ctx->enc.color_space = 9;      /* BT.2020 non-constant luminance */
+        blog(LOG_INFO, "[obs-netint-t4xx] HDR colour metadata: BT.2020 %s",
+             (voi->colorspace == VIDEO_CS_2100_PQ) ? "PQ" : "HLG");
+    }
+    
+    /* Initialize sample aspect ratio (1:1 = square pixels) */
+    ctx->enc.sar_num = 1;
+    ctx->enc.sar_den = 1;
+    
+    /* Store rate control mode, profile, and GOP preset strings (used later for parameter setting) */
+    ctx->rc_mode = bstrdup(obs_data_get_string(settings, "rc_mode"));
+    ctx->profile = bstrdup(obs_data_get_string(settings, "profile"));
+    if (ctx->bit_depth > 8 && (!ctx->profile || strcmp(ctx->profile, "main10") != 0)) {
+        /* 10-bit samples can only be encoded with a 10-bit profile */
+        blog(LOG_INFO, "[obs-netint-t4xx] 10-bit input - using H.265 Main10 instead of profile '%s'",
+             ctx->profile ? ctx->profile : "(null)");
+        bfree(ctx->profile);
+        ctx->profile = bstrdup("main10");
+    }
+    ctx->gop_preset = bstrdup(obs_data_get_string(settings, "gop_preset"));
+    /* I-B-B-B-P holds up to three B frames back; I-P-P-P never reorders */
+    const bool low_latency_gop = netint_gop_is_low_latency(ctx->gop_preset);
+    ctx->reorder_depth = ((ctx->gop_preset && strcmp(ctx->gop_preset, "simple") == 0) || low_latency_gop) ? 0 : 3;
+
+    /* Pipeline depth: the card must be allowed to hold every frame it reorders
+     * plus the one that releases them, otherwise it never emits a packet */
+    const char *pipeline_str = obs_data_get_string(settings, "pipeline_depth");
+    int inflight = ctx->reorder_depth + 3;
+    ctx->pipeline_mode = NETINT_PIPELINE_AUTO;
+    if (pipeline_str && strcmp(pipeline_str, "low_latency") == 0) {
+        ctx->pipeline_mode = NETINT_PIPELINE_LOW_LATENCY;
+        inflight = ctx->reorder_depth + 1;
+    } else if (pipeline_str && strcmp(pipeline_str, "balanced") == 0) {
+        ctx->pipeline_mode = NETINT_PIPELINE_BALANCED;
+    } else if (pipeline_str && strcmp(pipeline_str, "throughput") == 0) {
+        ctx->pipeline_mode = NETINT_PIPELINE_THROUGHPUT;
+        inflight = ctx->reorder_depth + 8;
+    }
+    if (low_latency_gop) {
+        /* Hold the card at one frame coding and at most one waiting behind it,
+         * whatever the depth setting, and never let auto deepen it */
+        ctx->pipeline_mode = NETINT_PIPELINE_LOW_LATENCY;
+        inflight = (inflight <= 1) ? 1 : 2;
+    }
+    /* Overload policy: "block" keeps OBS waiting for the card, the others
+     * lose frames instead so one slow session can't stall the video thread */
+    const char *overload_str = obs_data_get_string(settings, "overload_policy");
+    ctx->overload_policy = NETINT_OVERLOAD_BLOCK;
+    if (overload_str && strcmp(overload_str, "drop_oldest") == 0) {
+        ctx->overload_policy = NETINT_OVERLOAD_DROP_OLDEST;
+    } else if (overload_str && strcmp(overload_str, "skip") == 0) {
+        ctx->overload_policy = NETINT_OVERLOAD_SKIP;
+    }
+    ctx->frame_interval_ns = (voi->fps_num > 0) ? (uint64_t)voi->fps_den * 1000000000ULL / voi->fps_num : 0;
+
+    uint64_t watchdog_ms = ctx->frame_interval_ns * NETINT_WATCHDOG_FRAMES / 1000000ULL;
+    if (watchdog_ms < NETINT_WATCHDOG_MIN_MS) {
+        watchdog_ms = NETINT_WATCHDOG_MIN_MS;
+    }
+    const char *watchdog_env = getenv("NETINT_WATCHDOG_MS");
+    if (watchdog_env && *watchdog_env) {
+        watchdog_ms = strtoull(watchdog_env, NULL, 10);
+    }
+    ctx->watchdog_ns = watchdog_ms * 1000000ULL;
+    ctx->adapt_countdown = NETINT_PIPELINE_ADAPT_INTERVAL;
+    netint_set_pipeline_depth(ctx, inflight);
+    blog(LOG_INFO, "[obs-netint-t4xx] Pipeline depth: %s (%d frames in card, %ld total)",
+         low_latency_gop ? "low latency GOP" : (pipeline_str && *pipeline_str) ? pipeline_str : "auto",
+         ctx->max_inflight, ctx->max_pipeline_depth);
+
+    /* Allocated and first written on the device's node, so the pages land there */
+    if (!netint_numa_run_on_node(ctx->numa_node, netint_init_buffer_pools, ctx)) {
+        goto fail;
+    }
+    
+    /* Repeat headers setting: if true, attach SPS/PPS to every keyframe */
+    /* This is useful for streaming where clients may join mid-stream */
+    ctx->repeat_headers = obs_data_get_bool(settings, "repeat_headers");
+    ctx->qp_value = (int)obs_data_get_int(settings, "qp");
+    if (ctx->qp_value < 0)
+        ctx->qp_value = 0;
+    else if (ctx->qp_value > 51)
+        ctx->qp_value = 51;
+
+    ctx->qp_min = (int)obs_data_get_int(settings, "qp_min");
+    if (ctx->qp_min < 0)
+        ctx->qp_min = 0;
+    else if (ctx->qp_min > 51)
+        ctx->qp_min = 51;
+
+    ctx->qp_max = (int)obs_data_get_int(settings, "qp_max");
+    if (ctx->qp_max < 0)
+        ctx->qp_max = 0;
+    else if (ctx->qp_max > 51)
+        ctx->qp_max = 51;
+
+    if (ctx->qp_min > ctx->qp_max) {
+        int tmp = ctx->qp_min;
+        ctx->qp_min = ctx->qp_max;
+        ctx->qp_max = tmp;
+    }
+
+    ctx->roi_supported = (p_ni_logan_enc_prep_aux_data != NULL);
+    /* OBS ROI coordinates are for the encoder's own size */
+    ctx->roi_enabled = obs_data_get_bool(settings, "roi_enable") && ctx->roi_supported && !rendition;
+    ctx->roi_cache = obs_data_get_bool(settings, "roi_cache") && ctx->roi_enabled;
+    if (obs_data_get_bool(settings, "roi_enable") && !ctx->roi_supported) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] ROI was requested but libxcoder lacks ni_logan_enc_prep_aux_data; disabling ROI");
+    }
+    if (ctx->codec_type == 1) {
+        ctx->lossless = obs_data_get_bool(settings, "lossless");
+        if (ctx->lossless && (!ctx->rc_mode || strcmp(ctx->rc_mode, "DISABLED") != 0)) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Lossless requested but rate control not disabled; lossless will be ignored");
+        }
+    } else {
+        ctx->lossless = false;
+    }
+    if (ctx->repeat_headers) {
+        ctx->enc.spsPpsAttach = 1;
+    }
+
+    /* The watchdog reopens the session from this; device names are filled in then */
+    ctx->enc_template = ctx->enc;
+    ctx->enc_template.dev_enc_name = NULL;
+    ctx->enc_template.dev_xcoder = NULL;
+
+    /* Adopt a pre-opened or recycled session for this configuration if the pool has one */
+    ctx->session_config_valid = netint_session_config_from_ctx(ctx, dev_name, &ctx->session_config);
+    if (!netint_adopt_warm_session(ctx, device_request.placement == NETINT_PLACEMENT_AFFINITY) &&
+        !netint_open_session(ctx)) {
+        goto fail;
+    }
+    /* An adopted session may sit on another device than the one placed above */
+    ctx->numa_node = netint_numa_device_node(ctx->enc.dev_xcoder);
+
+    blog(LOG_INFO, "[obs-netint-t4xx] Encoder initialization complete!");
+
+    /* ===================================================================
+     * Initialize background receive thread
+     * ===================================================================
+     * 
+     * CRITICAL: The background thread is NECESSARY because encode_receive()
+     * blocks internally. Hardware won't process frames until output is drained!
+     */
+    
+    /* The job ring never holds more than max_pipeline_depth jobs (producer
+     * back-pressure). Packets waiting for OBS are bounded by the same depth
+     * plus one, since OBS takes one per encode call. Both are sized for the
+     * deepest pipeline auto mode may grow to. */
+    long max_depth = NETINT_PIPELINE_MAX_INFLIGHT + NETINT_PIPELINE_QUEUE_SLACK;
+    long pkt_ring_capacity = max_depth + 2;
+    long pkt_retained = 0;
+    for (int i = 0; i < NETINT_PKT_CLASS_COUNT; i++) {
+        pkt_retained += ctx->pkt_slabs[i].capacity;
+    }
+    if (pkt_ring_capacity < pkt_retained) {
+        pkt_ring_capacity = pkt_retained;
+    }
+
+    if (!netint_ring_init(&ctx->job_ring, max_depth + 1) ||
+        !netint_ring_init(&ctx->pkt_ring, pkt_ring_capacity) ||
+        !netint_ring_init(&ctx->pkt_free_ring, pkt_ring_capacity)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize frame/packet rings");
+        netint_destroy(ctx);
+        return NULL;
+    }
+    ctx->rings_initialized = true;
+
+    if (pthread_mutex_init(&ctx->header_mutex, NULL) != 0) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize header mutex");
+        netint_destroy(ctx);
+        return NULL;
+    }
+    if (pthread_cond_init(&ctx->header_cond, NULL) != 0) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize header condition");
+        pthread_mutex_destroy(&ctx->header_mutex);
+        netint_destroy(ctx);
+        return NULL;
+    }
+    ctx->header_sync_initialized = true;
+
+    ctx->stop_thread = false;
+    ctx->thread_created = false;
+    ctx->flushing = false;
+
+    if (netint_reactor_enabled() &&
+        netint_reactor_attach(&ctx->io_client, ctx->device_lease.slot, ctx->numa_node, NETINT_IO_POLL_INTERVAL_MS,
+                              netint_io_service, ctx)) {
+        ctx->io_attached = true;
+        blog(LOG_INFO, "[obs-netint-t4xx] IO runs on the shared reactor");
+    } else {
+        if (pthread_create(&ctx->io_thread, NULL, netint_io_thread, ctx) != 0) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Failed to create IO thread");
+            netint_destroy(ctx);
+            return NULL;
+        }
+
+        ctx->thread_created = true;
+        blog(LOG_INFO, "[obs-netint-t4xx] Background IO thread started successfully");
+    }
+    blog(LOG_INFO, "[obs-netint-t4xx] Encoder creation complete (pipelined design)");
+    return ctx;
+fail:
+    /* Cleanup all allocated resources on any failure */
+    netint_destroy(ctx);
+    return NULL;
+}
+
+static void *netint_create(obs_data_t *settings, obs_encoder_t *encoder)
+{
+    return netint_create_internal(settings, encoder, false, NULL);
+}
+
+/**
+ * @brief Create a texture-input encoder, or reroute to the system-memory one
+ *
+ * The texture path needs OBS to render NV12 (or, for H.265, P010) textures at
+ * the encoder's size; otherwise (other output formats, encoder-side scaling)
+ * OBS would have to read back anyway, so the encoder is rerouted to its
+ * CPU-input sibling.
+ */
+static void *netint_create_texture(obs_data_t *settings, obs_encoder_t *encoder, const char *fallback_id)
+{
+    video_t *video = obs_encoder_video(encoder);
+    const struct video_output_info *voi = video_output_get_info(video);
+
+    const char *codec = obs_encoder_get_codec(encoder);
+    bool hevc = codec && strcmp(codec, "hevc") == 0;
+    bool nv12_tex = voi->format == VIDEO_FORMAT_NV12 && obs_nv12_tex_active();
+    bool p010_tex = hevc && voi->format == VIDEO_FORMAT_P010 && obs_p010_tex_active();
+
+    if (!nv12_tex && !p010_tex) {
+        blog(LOG_INFO, "[obs-netint-t4xx] NV12/P010 textures not active, falling back to %s", fallback_id);
+        return obs_encoder_create_rerouted(encoder, fallback_id);
+    }
+    if (obs_encoder_scaling_enabled(encoder)) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Encoder scaling enabled, falling back to %s", fallback_id);
+        return obs_encoder_create_rerouted(encoder, fallback_id);
+    }
+
+    return netint_create_internal(settings, encoder, true, NULL);
+}
+
+static void *netint_h264_tex_create(obs_data_t *settings, obs_encoder_t *encoder)
+{
+    return netint_create_texture(settings, encoder, "obs_netint_t4xx_h264");
+}
+
+static void *netint_h265_tex_create(obs_data_t *settings, obs_encoder_t *encoder)
+{
+    return netint_create_texture(settings, encoder, "obs_netint_t4xx_h265");
+}
+
+/**
+ * @brief Create a ladder encoder: its own full-size session plus one per rendition
+ */
+static void *netint_ladder_create(obs_data_t *settings, obs_encoder_t *encoder)
+{
+    struct netint_ctx *ctx = netint_create_internal(settings, encoder, false, NULL);
+    if (!ctx) {
+        return NULL;
+    }
+
+    if (!netint_ladder_open(ctx, settings)) {
+        netint_destroy(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+/**
+ * @brief Destroy encoder instance and free all resources
+ * 
+ * This function is called by OBS Studio when the encoder is no longer needed
+ * (e.g., user changes encoder, stops streaming/recording, OBS shuts down).
+ * 
+ * Cleanup order is important:
+ * 1. Signal background thread to stop
+ * 2. Wait for thread to finish (pthread_join)
+ * 3. Free all queued packets
+ * 4. Destroy queue and mutex
+ * 5. Close hardware encoder connection
+ * 6. Free all allocated memory
+ * 
+ * Thread Safety:
+ * - This function should be called from the same thread that created the encoder
+ * - Background thread is stopped before cleanup, so no concurrent access issues
+ * 
+ * @param data Pointer to encoder context (netint_ctx structure)
+ */
+static void netint_destroy(void *data)
+{
+    struct netint_ctx *ctx = data;
+    if (!ctx) return;
+
+    /* Stats readers must not see the session once teardown starts */
+    netint_telemetry_unregister(&ctx->telemetry);
+
+    /* Renditions go first: their workers read this session's buffers */
+    if (ctx->ladder) {
+        netint_ladder_destroy(ctx->ladder);
+        ctx->ladder = NULL;
+    }
+    
+    blog(LOG_INFO, "[obs-netint-t4xx] ========================================");
+    blog(LOG_INFO, "[obs-netint-t4xx] netint_destroy called - closing encoder");
+    blog(LOG_INFO, "[obs-netint-t4xx] ========================================");
+    
+    /* Check EOS handshake status */
+    blog(LOG_INFO, "[obs-netint-t4xx] EOS handshake status:");
+    blog(LOG_INFO, "[obs-netint-t4xx]   flushing = %d (should be 1 if stop was requested)", ctx->flushing);
+    blog(LOG_INFO, "[obs-netint-t4xx]   encoder_eof = %d (should be 1 if EOS acknowledged)", ctx->enc.encoder_eof);
+    
+    if (ctx->flushing && ctx->enc.encoder_eof) {
+        blog(LOG_INFO, "[obs-netint-t4xx] ✅ PROPER SHUTDOWN: EOS handshake completed successfully");
+    } else if (ctx->flushing && !ctx->enc.encoder_eof) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] ⚠️  INCOMPLETE SHUTDOWN: EOS sent but not acknowledged by encoder");
+        blog(LOG_WARNING, "[obs-netint-t4xx] This may indicate encoder is still processing or thread stopped early");
+    } else {
+        blog(LOG_WARNING, "[obs-netint-t4xx] ⚠️  ABRUPT SHUTDOWN: No EOS handshake performed");
+        blog(LOG_WARNING, "[obs-netint-t4xx] OBS skipped flush - we'll send EOS frame now in destroy");
+    }
+
+#ifdef DEBUG_NETINT_PLUGIN
+    /* Validate magic before destroy */
+    if (ctx->debug_magic != NETINT_ENC_CONTEXT_MAGIC) {
+        blog(LOG_WARNING, "[DEBUG] Invalid context magic in netint_destroy: 0x%08X", ctx->debug_magic);
+    }
+#endif
+    
+    /* ===================================================================
+     * Send EOS frame if not already done (OBS doesn't call flush for this encoder)
+     * ===================================================================
+     */
+    if (ctx->thread_created || ctx->io_attached) {
+        /* Texture input: frames still sitting in staging surfaces go out before EOS */
+        while (ctx->texture_input && !ctx->flushing && ctx->tex_stage_count > 0) {
+            netint_tex_upload_oldest(ctx);
+        }
+
+        if (!ctx->flushing && ctx->enc.p_session_ctx) {
+            blog(LOG_INFO, "[obs-netint-t4xx] Queueing EOS job during destroy");
+            if (netint_queue_eos(ctx)) {
+                ctx->flushing = true;
+            } else {
+                blog(LOG_ERROR, "[obs-netint-t4xx] Failed to queue EOS job during destroy");
+            }
+        }
+
+        blog(LOG_INFO, "[obs-netint-t4xx] Stopping IO thread...");
+        os_atomic_set_bool(&ctx->stop_thread, true);
+        if (ctx->rings_initialized) {
+            netint_ring_wake(&ctx->job_ring);
+            netint_ring_wake(&ctx->pkt_ring);
+        }
+
+        if (ctx->thread_created) {
+            /* The IO thread waits out a reopen before it exits */
+            pthread_join(ctx->io_thread, NULL);
+            netint_watchdog_join(ctx);
+            blog(LOG_INFO, "[obs-netint-t4xx] IO thread stopped");
+            ctx->thread_created = false;
+        } else {
+            /* No worker touches the session after detach; finish what the
+             * IO thread would have on its way out */
+            netint_reactor_detach(&ctx->io_client);
+            netint_watchdog_join(ctx);
+            ctx->io_attached = false;
+
+            struct netint_frame_job *job = NULL;
+            while ((job = netint_dequeue_job(ctx, 0)) != NULL) {
+                if (netint_hw_send_job(ctx, job) && !job->end_of_stream) {
+                    os_atomic_inc_long(&ctx->inflight_frames);
+                }
+                netint_release_job(ctx, job);
+            }
+            netint_hw_drain(ctx, true);
+            blog(LOG_INFO, "[obs-netint-t4xx] Detached from the IO reactor");
+        }
+    }
+
+    /* Free any remaining frame jobs (should be none) */
+    if (ctx->rings_initialized) {
+        struct netint_frame_job *pending_job = NULL;
+        while ((pending_job = netint_dequeue_job(ctx, 0)) != NULL) {
+            netint_release_job(ctx, pending_job);
+        }
+    }
+
+    netint_destroy_job_pool(ctx);
+    netint_tex_stage_free(ctx);
+
+    /* Every job has dropped its shared frame by now */
+    if (ctx->frame_group) {
+        if (ctx->shared_frames > 0) {
+            blog(LOG_INFO, "[obs-netint-t4xx] %llu frame(s) reused another encoder's upload",
+                 (unsigned long long)ctx->shared_frames);
+        }
+        netint_frame_cache_detach(ctx->frame_group);
+        ctx->frame_group = NULL;
+    }
+    
+    /* Free all queued packets */
+    if (ctx->last_delivered_pkt) {
+        netint_free_packet(ctx->last_delivered_pkt);
+        ctx->last_delivered_pkt = NULL;
+    }
+
+    if (ctx->rings_initialized) {
+        struct netint_pkt *pkt = NULL;
+        while ((pkt = netint_ring_pop(&ctx->pkt_ring)) != NULL) {
+            netint_free_packet(pkt);
+        }
+    }
+
+    if (ctx->pkt_prefix) {
+        netint_free_packet(ctx->pkt_prefix);
+        ctx->pkt_prefix = NULL;
+    }
+    if (ctx->pkt_backlog) {
+        netint_free_packet(ctx->pkt_backlog);
+        ctx->pkt_backlog = NULL;
+    }
+
+    netint_destroy_packet_pool(ctx);
+    netint_zc_destroy(ctx);
+    
+    /* Destroy rings LAST (after thread is stopped!) */
+    ctx->rings_initialized = false;
+    netint_ring_free(&ctx->job_ring);
+    netint_ring_free(&ctx->pkt_ring);
+    netint_ring_free(&ctx->pkt_free_ring);
+
+    if (ctx->header_sync_initialized) {
+        pthread_cond_destroy(&ctx->header_cond);
+        pthread_mutex_destroy(&ctx->header_mutex);
+        ctx->header_sync_initialized = false;
+    }
+    
+    /* Close hardware encoder connection, unless the session pool can reuse it */
+    /* We use encode_open() for initialization, so use encode_close() for cleanup */
+    if (netint_recycle_session(ctx)) {
+        /* The pool owns the libxcoder context and device lease now */
+    } else if (ctx->enc.p_session_ctx) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Closing encoder session...");
+        if (p_ni_logan_encode_close) {
+            int close_ret = p_ni_logan_encode_close(&ctx->enc);
+            blog(LOG_INFO, "[obs-netint-t4xx] ni_logan_encode_close returned: %d", close_ret);
+        }
+    } else {
+        blog(LOG_INFO, "[obs-netint-t4xx] Skipping encode_close (p_session_ctx=%p)", 
+             ctx->enc.p_session_ctx);
+        /* NOTE: Do NOT manually free p_session_ctx or p_encoder_params! */
+        /* These were allocated by libxcoder_logan.dll and must be freed by it */
+        /* Cross-DLL memory management causes heap corruption on Windows */
+    }
+    
+    netint_device_release(&ctx->device_lease);
+
+    /* Free device name strings (allocated by us with bstrdup) */
+    /* These are safe to free - we allocated them before calling library functions */
+    if (ctx->enc.dev_enc_name) {
+        bfree(ctx->enc.dev_enc_name);
+        ctx->enc.dev_enc_name = NULL;
+    }
+    if (ctx->enc.dev_xcoder) {
+        bfree(ctx->enc.dev_xcoder);
+        ctx->enc.dev_xcoder = NULL;
+    }
+    
+    /* Free extradata (SPS/PPS headers) - allocated by us */
+    if (ctx->extra) {
+        bfree(ctx->extra);
+        ctx->extra = NULL;
+        ctx->extra_size = 0;
+    }
+
+    bfree(ctx->roi_map);
+    ctx->roi_map = NULL;
+    
+    /* Free configuration strings - allocated by us */
+    if (ctx->rc_mode) bfree(ctx->rc_mode);
+    if (ctx->profile) bfree(ctx->profile);
+    if (ctx->gop_preset) bfree(ctx->gop_preset);
+    
+    /* enc is EMBEDDED in ctx, so it will be freed when ctx is freed */
+    /* No need to manually free it */
+    
+#ifdef DEBUG_NETINT_PLUGIN
+    /* Clear magic for use-after-free detection */
+    ctx->debug_magic = 0xFEEDFACE;  /* Freed marker */
+    blog(LOG_INFO, "[obs-netint-t4xx] Context %p marked as freed", ctx);
+#endif
+    
+    /* Free context structure itself */
+    bfree(ctx);
+}
+
+/**
+ * @brief Update encoder settings (called when user changes configuration)
+ * 
+ * Only the target bitrate can change on a running T4XX session. The new value
+ * is handed to the IO thread through pending_bitrate and applied on the next
+ * frame it sends (NI_FRAME_AUX_DATA_BITRATE via ni_logan_enc_prep_aux_data),
+ * so the session, job pool and GOP are kept - no EOS, reopen or forced IDR.
+ * 
+ * The VBV buffer (RcInitDelay) and all other parameters are fixed at open;
+ * changes to them are logged and take effect the next time the encoder starts.
+ * 
+ * @param data Encoder context
+ * @param settings New settings
+ * @return true if the update was accepted (or needs no action)
+ */
+static bool netint_update(void *data, obs_data_t *settings)
+{
+    struct netint_ctx *ctx = data;
+
+    int vbv_buffer_ms = (int)obs_data_get_int(settings, "vbv_buffer_ms");
+    if (vbv_buffer_ms < 30) {
+        vbv_buffer_ms = 30;
+    } else if (vbv_buffer_ms > 6000) {
+        vbv_buffer_ms = 6000;
+    }
+    if (vbv_buffer_ms != ctx->vbv_buffer_ms) {
+        /* RcInitDelay is fixed when the session opens */
+        blog(LOG_WARNING, "[obs-netint-t4xx] VBV buffer change (%d -> %d ms) requires restarting the encoder; keeping %d ms",
+             ctx->vbv_buffer_ms, vbv_buffer_ms, ctx->vbv_buffer_ms);
+    }
+
+    if (ctx->rc_mode && strcmp(ctx->rc_mode, "DISABLED") == 0) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Rate control disabled - bitrate update ignored");
+        return true;
+    }
+
+    int64_t bitrate = (int64_t)obs_data_get_int(settings, "bitrate") * 1000;
+    if (bitrate <= 0 || bitrate > INT32_MAX) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Ignoring invalid bitrate update (%lld bps)", (long long)bitrate);
+        return false;
+    }
+    if (bitrate == ctx->requested_bitrate) {
+        return true;
+    }
+
+    if (!p_ni_logan_enc_prep_aux_data) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] ni_logan_enc_prep_aux_data unavailable - cannot change bitrate live");
+        return false;
+    }
+
+    /* Picked up by the IO thread with the next frame it sends. A newer request
+     * simply replaces one that has not been applied yet. */
+    ctx->requested_bitrate = bitrate;
+    os_atomic_set_long(&ctx->pending_bitrate, (long)bitrate);
+    blog(LOG_INFO, "[obs-netint-t4xx] Bitrate update to %lld kbps queued", (long long)(bitrate / 1000));
+    return true;
+}
+
+/**
+ * @brief Specify preferred video format for encoder input
+ * 
+ * This function tells OBS what pixel format we want frames in.
+ * The hardware consumes planar YUV420, which the plugin can build from
+ * either I420 or NV12. NV12 is requested when OBS already renders NV12
+ * (chosen in netint_create), so OBS does not run a conversion pass for us.
+ * 
+ * @param data Encoder context
+ * @param info Video scale info - we set info->format to our preferred format
+ */
+static void netint_get_video_info(void *data, struct video_scale_info *info)
+{
+    struct netint_ctx *ctx = data;
+    info->format = (ctx && ctx->input_format != VIDEO_FORMAT_NONE) ? ctx->input_format : VIDEO_FORMAT_I420;
+}
+
+/**
+ * @brief Preferred video format for the texture variants
+ *
+ * The texture path only maps NV12 and P010 staging surfaces, so anything
+ * else the system-memory variants would accept is asked for as NV12.
+ */
+static void netint_tex_get_video_info(void *data, struct video_scale_info *info)
+{
+    struct netint_ctx *ctx = data;
+    info->format = (ctx && ctx->input_format == VIDEO_FORMAT_P010) ? VIDEO_FORMAT_P010 : VIDEO_FORMAT_NV12;
+}
+
+static void netint_zc_free_buf(struct netint_zc_buf *buf)
+{
+    /* libxcoder allocated the buffer, so libxcoder frees it */
+    if (buf->hw_pkt.p_buffer && p_ni_logan_packet_buffer_free) {
+        p_ni_logan_packet_buffer_free(&buf->hw_pkt);
+    }
+    bfree(buf);
+}
+
+static void netint_free_packet(struct netint_pkt *pkt)
+{
+    if (!pkt) {
+        return;
+    }
+
+    if (pkt->zc) {
+        netint_zc_free_buf(pkt->zc);
+        pkt->zc = NULL;
+        pkt->zc_data = NULL;
+    }
+
+    if (pkt->data) {
+        bfree(pkt->data);
+        pkt->data = NULL;
+    }
+
+    pkt->capacity = 0;
+    pkt->size = 0;
+    bfree(pkt);
+}
+
+static struct netint_pkt *netint_alloc_packet(size_t buffer_size, enum netint_pkt_class slab_class)
+{
+    struct netint_pkt *pkt = bzalloc(sizeof(*pkt));
+    if (!pkt) {
+        return NULL;
+    }
+
+    pkt->data = bmalloc(buffer_size);
+    if (!pkt->data) {
+        bfree(pkt);
+        return NULL;
+    }
+
+    pkt->capacity = buffer_size;
+    pkt->slab_class = slab_class;
+    return pkt;
+}
+
+/**
+ * @brief Size the packet slabs from the rate control settings and preallocate them
+ *
+ * Needs enc.bit_rate, vbv_buffer_ms, keyint_frames, frame_interval_ns and
+ * reorder_depth.
+ */
+static bool netint_init_packet_pool(struct netint_ctx *ctx)
+{
+    if (!ctx) {
+        return false;
+    }
+
+    uint64_t byte_rate = ctx->enc.bit_rate > 0 ? (uint64_t)ctx->enc.bit_rate / 8 : 0;
+    uint64_t avg_frame = ctx->frame_interval_ns ? byte_rate * ctx->frame_interval_ns / 1000000000ULL : 0;
+    uint64_t vbv_bytes = byte_rate * (uint64_t)ctx->vbv_buffer_ms / 1000;
+    uint64_t gop_bytes = avg_frame * (uint64_t)(ctx->keyint_frames > 0 ? ctx->keyint_frames : 1);
+
+    uint64_t frame_size = avg_frame * NETINT_PKT_FRAME_AVG_MULTIPLE;
+    if (frame_size < NETINT_PKT_FRAME_MIN_SIZE) {
+        frame_size = NETINT_PKT_FRAME_MIN_SIZE;
+    }
+    uint64_t idr_size = vbv_bytes > gop_bytes ? vbv_bytes : gop_bytes;
+    if (idr_size < frame_size * NETINT_PKT_FRAME_AVG_MULTIPLE) {
+        /* Also covers rate control modes without a target bitrate */
+        idr_size = frame_size * NETINT_PKT_FRAME_AVG_MULTIPLE;
+    }
+    if (idr_size > NI_LOGAN_MAX_TX_SZ) {
+        idr_size = NI_LOGAN_MAX_TX_SZ;
+    }
+    if (frame_size > idr_size) {
+        frame_size = idr_size;
+    }
+
+    /* One packet being filled, one held by OBS, the rest queued behind the
+     * reorder depth; keep twice that so a burst doesn't hit the heap */
+    int frame_count = ctx->reorder_depth + 3;
+
+    memset(ctx->pkt_slabs, 0, sizeof(ctx->pkt_slabs));
+    ctx->pkt_slabs[NETINT_PKT_CLASS_FRAME].buffer_size = (size_t)frame_size;
+    ctx->pkt_slabs[NETINT_PKT_CLASS_FRAME].capacity = frame_count * 2;
+    ctx->pkt_slabs[NETINT_PKT_CLASS_IDR].buffer_size = (size_t)idr_size;
+    ctx->pkt_slabs[NETINT_PKT_CLASS_IDR].capacity = NETINT_PKT_IDR_PREALLOC * 2;
+    ctx->last_delivered_pkt = NULL;
+
+    for (int i = 0; i < NETINT_PKT_CLASS_COUNT; i++) {
+        struct netint_pkt_slab *slab = &ctx->pkt_slabs[i];
+        int prealloc = (i == NETINT_PKT_CLASS_IDR) ? NETINT_PKT_IDR_PREALLOC : frame_count;
+        while (slab->count < prealloc) {
+            struct netint_pkt *pkt = netint_alloc_packet(slab->buffer_size, (enum netint_pkt_class)i);
+            if (!pkt) {
+                blog(LOG_ERROR, "[obs-netint-t4xx] Failed to preallocate %zu-byte packet buffer", slab->buffer_size);
+                return false;
+            }
+            netint_numa_touch(pkt->data, slab->buffer_size);
+            pkt->next = slab->head;
+            slab->head = pkt;
+            slab->count++;
+        }
+    }
+
+    blog(LOG_INFO, "[obs-netint-t4xx] Packet slabs: %d x %zu bytes (frame), %d x %zu bytes (IDR)",
+         ctx->pkt_slabs[NETINT_PKT_CLASS_FRAME].count, ctx->pkt_slabs[NETINT_PKT_CLASS_FRAME].buffer_size,
+         ctx->pkt_slabs[NETINT_PKT_CLASS_IDR].count, ctx->pkt_slabs[NETINT_PKT_CLASS_IDR].buffer_size);
+    return true;
+}
+
+static void netint_destroy_packet_pool(struct netint_ctx *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    for (int i = 0; i < NETINT_PKT_CLASS_COUNT; i++) {
+        struct netint_pkt *head = ctx->pkt_slabs[i].head;
+        ctx->pkt_slabs[i].head = NULL;
+        ctx->pkt_slabs[i].count = 0;
+        ctx->pkt_slabs[i].capacity = 0;
+
+        while (head) {
+            struct netint_pkt *next = head->next;
+            netint_free_packet(head);
+            head = next;
+        }
+    }
+
+    if (ctx->rings_initialized) {
+        struct netint_pkt *pkt = NULL;
+        while ((pkt = netint_ring_pop(&ctx->pkt_free_ring)) != NULL) {
+            netint_free_packet(pkt);
+        }
+    }
+}
+
+static bool netint_job_allocate_hw_frame(struct netint_ctx *ctx, struct netint_frame_job *job)
+{
+	if (!ctx || !job) {
+		return false;
+	}
+
+	memset(&job->hw_frame, 0, sizeof(job->hw_frame));
+	job->hw_frame.extra_data_len = NETINT_FRAME_EXTRA_DATA_LEN;
+
+	int alloc_ret = p_ni_logan_encoder_frame_buffer_alloc(&job->hw_frame, ctx->enc.width,
+							      ctx->enc.height, ctx->hw_stride,
+							      (ctx->codec_type == 0) ? 1 : 0,
+							      job->hw_frame.extra_data_len, ctx->bit_depth_factor);
+	if (alloc_ret != NI_LOGAN_RETCODE_SUCCESS) {
+		blog(LOG_ERROR,
+		     "[obs-netint-t4xx] Failed to allocate persistent frame buffer for job (ret=%d)",
+		     alloc_ret);
+		netint_log_error(ctx, "ni_logan_encoder_frame_buffer_alloc", alloc_ret);
+		memset(&job->hw_frame, 0, sizeof(job->hw_frame));
+		job->hw_frame_capacity = 0;
+		return false;
+	}
+
+	job->hw_frame_capacity = ctx->hw_frame_size;
+	netint_numa_touch(job->hw_frame.p_buffer, job->hw_frame.buffer_size);
+
+	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+		if (ctx->hw_plane_size[i] > 0) {
+			job->hw_frame.data_len[i] = (uint32_t)ctx->hw_plane_size[i];
+		} else {
+			job->hw_frame.data_len[i] = 0;
+		}
+	}
+
+	job->hw_frame.video_width = ctx->enc.width;
+	job->hw_frame.video_height = ctx->enc.height;
+	job->hw_frame.video_orig_width = ctx->enc.width;
+	job->hw_frame.video_orig_height = ctx->enc.height;
+	job->hw_frame.color_primaries = (uint8_t)ctx->enc.color_primaries;
+	job->hw_frame.color_trc = (uint8_t)ctx->enc.color_trc;
+	job->hw_frame.color_space = (uint8_t)ctx->enc.color_space;
+	job->hw_frame.video_full_range_flag = ctx->enc.color_range;
+	job->hw_frame.sar_width = (uint16_t)ctx->enc.sar_num;
+	job->hw_frame.sar_height = (uint16_t)ctx->enc.sar_den;
+	job->hw_frame.vui_num_units_in_tick = (uint32_t)ctx->enc.timebase_num;
+	job->hw_frame.vui_time_scale = (uint32_t)ctx->enc.timebase_den;
+	job->hw_frame.bit_depth = (uint16_t)ctx->bit_depth;
+
+	return true;
+}
+
+static void netint_job_release_hw_frame(struct netint_frame_job *job)
+{
+	if (!job) {
+		return;
+	}
+
+	if (job->hw_frame.p_buffer && p_ni_logan_frame_buffer_free) {
+		p_ni_logan_frame_buffer_free(&job->hw_frame);
+	}
+
+	memset(&job->hw_frame, 0, sizeof(job->hw_frame));
+	job->hw_frame_capacity = 0;
+}
+
+/**
+ * @brief true if @p buf can go back into circulation
+ *
+ * Only our own full-size buffers with headroom; the one encode_open
+ * allocated (or libxcoder put in its place) has none.
+ */
+static bool netint_zc_buf_fits(const struct netint_zc_buf *buf)
+{
+    return buf->headroom > 0 && buf->hw_pkt.buffer_size >= NI_LOGAN_MAX_TX_SZ;
+}
+
+/**
+ * @brief Free a spare that was taken out of circulation (IO thread only)
+ */
+static void netint_zc_retire(struct netint_ctx *ctx, struct netint_zc_buf *buf)
+{
+    /* Only buffers with headroom were allocated (and counted) by us */
+    if (buf->headroom > 0 && ctx->zc_buffers > 0) {
+        ctx->zc_buffers--;
+    }
+    netint_zc_free_buf(buf);
+}
+
+/**
+ * @brief Put a zero-copy buffer back on the spare list (IO thread only)
+ */
+static void netint_zc_detach(struct netint_ctx *ctx, struct netint_pkt *pkt)
+{
+    if (!pkt->zc) {
+        return;
+    }
+
+    if (netint_zc_buf_fits(pkt->zc)) {
+        pkt->zc->next = ctx->zc_free;
+        ctx->zc_free = pkt->zc;
+    } else {
+        netint_zc_retire(ctx, pkt->zc);
+    }
+    pkt->zc = NULL;
+    pkt->zc_data = NULL;
+}
+
+/**
+ * @brief Get a spare output buffer, allocating one while under the cap (IO thread only)
+ */
+static struct netint_zc_buf *netint_zc_get_spare(struct netint_ctx *ctx)
+{
+    struct netint_zc_buf *buf;
+    while ((buf = ctx->zc_free) != NULL) {
+        ctx->zc_free = buf->next;
+        buf->next = NULL;
+        if (netint_zc_buf_fits(buf)) {
+            return buf;
+        }
+        netint_zc_retire(ctx, buf);
+    }
+
+    /* One installed, one with OBS, the rest queued: the pipeline depth bounds it */
+    long cap = os_atomic_load_long(&ctx->max_pipeline_depth);
+    if (cap < NETINT_ZC_MIN_BUFFERS) {
+        cap = NETINT_ZC_MIN_BUFFERS;
+    } else if (cap > NETINT_ZC_MAX_BUFFERS) {
+        cap = NETINT_ZC_MAX_BUFFERS;
+    }
+    if (ctx->zc_buffers >= cap) {
+        return NULL;
+    }
+
+    buf = bzalloc(sizeof(*buf));
+    if (!buf) {
+        return NULL;
+    }
+
+    int alloc_ret = p_ni_logan_packet_buffer_alloc(&buf->hw_pkt, NI_LOGAN_MAX_TX_SZ + NETINT_ZC_HEADROOM);
+    if (alloc_ret != NI_LOGAN_RETCODE_SUCCESS || !buf->hw_pkt.p_buffer) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [IO THREAD] Packet buffer allocation failed (ret=%d), copying packets instead",
+             alloc_ret);
+        bfree(buf);
+        ctx->zero_copy = false;
+        return NULL;
+    }
+
+    /* Headroom is one page, so p_data keeps the buffer's DMA alignment */
+    buf->hw_pkt.p_data = (uint8_t *)buf->hw_pkt.p_buffer + NETINT_ZC_HEADROOM;
+    buf->hw_pkt.buffer_size -= NETINT_ZC_HEADROOM;
+    buf->headroom = NETINT_ZC_HEADROOM;
+    ctx->zc_buffers++;
+    return buf;
+}
+
+/**
+ * @brief Take the packet libxcoder just received without copying it (IO thread)
+ *
+ * The filled output buffer becomes the packet's storage and a spare buffer is
+ * installed in enc.output_pkt for the next receive. The pending header-only
+ * packet and the SPS/PPS header are written into the space in front of the
+ * payload: the firmware metadata (already parsed by encode_receive) plus the
+ * buffer's headroom, which is only trusted while output_pkt still holds the
+ * buffer zc_out describes.
+ *
+ * @return Packet, or NULL if this one has to go through the copy path
+ */
+static struct netint_pkt *netint_receive_zero_copy(struct netint_ctx *ctx, int header_size)
+{
+    ni_logan_packet_t *ni_pkt = &ctx->enc.output_pkt.data.packet;
+    const size_t meta_size = NI_LOGAN_FW_ENC_BITSTREAM_META_DATA_SIZE;
+    size_t prefix_size = ctx->pkt_prefix ? ctx->pkt_prefix->size : 0;
+    size_t front = prefix_size + (size_t)header_size;
+
+    /* libxcoder reallocated the output buffer: the new one is its own and
+     * has no headroom in front of p_data */
+    struct netint_zc_buf *out = ctx->zc_out;
+    if (out && (ni_pkt->p_buffer != out->hw_pkt.p_buffer || ni_pkt->buffer_size != out->hw_pkt.buffer_size)) {
+        netint_log(LOG_WARNING, "[obs-netint-t4xx] [IO THREAD] Output buffer was replaced by libxcoder, copying");
+        if (out->headroom > 0 && ctx->zc_buffers > 0) {
+            ctx->zc_buffers--;
+        }
+        out->hw_pkt = *ni_pkt;
+        out->headroom = 0;
+        return NULL;
+    }
+
+    /* The first packet and custom SEI need encode_copy_packet_data */
+    if (!ctx->zero_copy || !ctx->enc.firstPktArrived || ni_pkt->p_all_custom_sei ||
+        ni_pkt->len_of_sei_after_vcl > 0 || ni_pkt->data_len <= meta_size) {
+        return NULL;
+    }
+
+    if (!ctx->zc_out) {
+        /* The buffer encode_open allocated has no headroom */
+        ctx->zc_out = bzalloc(sizeof(*ctx->zc_out));
+        if (!ctx->zc_out) {
+            return NULL;
+        }
+        ctx->zc_out->hw_pkt = *ni_pkt;
+    }
+    if (front > ctx->zc_out->headroom + meta_size) {
+        return NULL;
+    }
+
+    struct netint_zc_buf *spare = netint_zc_get_spare(ctx);
+    if (!spare) {
+        return NULL;
+    }
+
+    struct netint_pkt *pkt = netint_acquire_packet(ctx, 0);
+    if (!pkt) {
+        spare->next = ctx->zc_free;
+        ctx->zc_free = spare;
+        return NULL;
+    }
+
+    struct netint_zc_buf *full = ctx->zc_out;
+    full->hw_pkt = *ni_pkt;
+    ni_pkt->p_buffer = spare->hw_pkt.p_buffer;
+    ni_pkt->p_data = spare->hw_pkt.p_data;
+    ni_pkt->buffer_size = spare->hw_pkt.buffer_size;
+    ctx->zc_out = spare;
+
+    uint8_t *payload = (uint8_t *)full->hw_pkt.p_data + meta_size;
+    uint8_t *start = payload - front;
+    if (prefix_size > 0) {
+        memcpy(start, netint_pkt_bytes(ctx->pkt_prefix), prefix_size);
+    }
+    if (header_size > 0) {
+        memcpy(start + prefix_size, ctx->enc.p_spsPpsHdr, (size_t)header_size);
+    }
+
+    pkt->zc = full;
+    pkt->zc_data = start;
+    pkt->size = front + (full->hw_pkt.data_len - meta_size);
+    return pkt;
+}
+
+/**
+ * @brief Free all zero-copy buffers (after the IO thread and packet pool are gone)
+ *
+ * The buffer installed in output_pkt may be one of ours rather than the one
+ * encode_open allocated, so it is freed here and the slot left empty for
+ * encode_close.
+ */
+static void netint_zc_destroy(struct netint_ctx *ctx)
+{
+    while (ctx->zc_free) {
+        struct netint_zc_buf *next = ctx->zc_free->next;
+        netint_zc_free_buf(ctx->zc_free);
+        ctx->zc_free = next;
+    }
+
+    netint_zc_release_output(ctx);
+}
+
+/**
+ * @brief Free the buffer installed in enc.output_pkt, leaving the slot empty
+ *        for encode_close (IO thread, or after it is gone)
+ */
+static void netint_zc_release_output(struct netint_ctx *ctx)
+{
+    if (ctx->zc_out) {
+        ni_logan_packet_t *ni_pkt = &ctx->enc.output_pkt.data.packet;
+        if (ni_pkt->p_buffer && p_ni_logan_packet_buffer_free) {
+            p_ni_logan_packet_buffer_free(ni_pkt);
+        }
+        ni_pkt->p_buffer = NULL;
+        ni_pkt->p_data = NULL;
+        ni_pkt->buffer_size = 0;
+        if (ctx->zc_out->headroom > 0 && ctx->zc_buffers > 0) {
+            ctx->zc_buffers--;
+        }
+        bfree(ctx->zc_out);
+        ctx->zc_out = NULL;
+    }
+}
+
+static struct netint_pkt *netint_acquire_packet(struct netint_ctx *ctx, size_t required_size)
+{
+    if (!ctx) {
+        return NULL;
+    }
+
+    struct netint_pkt *pkt = NULL;
+
+    /* IO thread: sort buffers OBS has finished with back into their slabs */
+    if (ctx->rings_initialized) {
+        while ((pkt = netint_ring_pop(&ctx->pkt_free_ring)) != NULL) {
+            netint_release_packet(ctx, pkt);
+        }
+    }
+
+    enum netint_pkt_class slab_class = NETINT_PKT_CLASS_OVERSIZE;
+    for (int i = 0; i < NETINT_PKT_CLASS_COUNT; i++) {
+        if (required_size <= ctx->pkt_slabs[i].buffer_size) {
+            slab_class = (enum netint_pkt_class)i;
+            break;
+        }
+    }
+
+    if (slab_class == NETINT_PKT_CLASS_OVERSIZE) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [IO THREAD] %zu-byte packet exceeds the IDR slab (%zu bytes)",
+             required_size, ctx->pkt_slabs[NETINT_PKT_CLASS_IDR].buffer_size);
+        pkt = netint_alloc_packet(required_size ? required_size : 1, NETINT_PKT_CLASS_OVERSIZE);
+    } else {
+        struct netint_pkt_slab *slab = &ctx->pkt_slabs[slab_class];
+        pkt = slab->head;
+        if (pkt) {
+            slab->head = pkt->next;
+            slab->count--;
+        } else {
+            /* Slab exhausted: grow it; the buffer is retained on release */
+            pkt = netint_alloc_packet(slab->buffer_size, slab_class);
+        }
+    }
+
+    if (!pkt) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate %zu-byte packet buffer", required_size);
+        return NULL;
+    }
+
+    pkt->size = 0;
+    pkt->next = NULL;
+    return pkt;
+}
+
+static void netint_reset_packet(struct netint_pkt *pkt)
+{
+    pkt->size = 0;
+    pkt->pts = 0;
+    pkt->dts = 0;
+    pkt->keyframe = false;
+    pkt->priority = 0;
+    pkt->next = NULL;
+}
+
+/**
+ * @brief Return a packet buffer to the OBS-side free ring (OBS thread only)
+ *
+ * The IO thread picks it up again in netint_acquire_packet().
+ */
+static void netint_return_packet(struct netint_ctx *ctx, struct netint_pkt *pkt)
+{
+    if (!ctx || !pkt)
+        return;
+
+    netint_reset_packet(pkt);
+    if (!ctx->rings_initialized || !netint_ring_push(&ctx->pkt_free_ring, pkt)) {
+        netint_free_packet(pkt);
+    }
+}
+
+/**
+ * @brief Return a packet buffer to the IO thread's own free list (IO thread only)
+ */
+static void netint_release_packet(struct netint_ctx *ctx, struct netint_pkt *pkt)
+{
+    if (!ctx || !pkt)
+        return;
+
+    netint_reset_packet(pkt);
+    netint_zc_detach(ctx, pkt);
+
+    if (pkt->slab_class == NETINT_PKT_CLASS_OVERSIZE ||
+        ctx->pkt_slabs[pkt->slab_class].count >= ctx->pkt_slabs[pkt->slab_class].capacity) {
+        netint_free_packet(pkt);
+        return;
+    }
+
+    struct netint_pkt_slab *slab = &ctx->pkt_slabs[pkt->slab_class];
+    pkt->next = slab->head;
+    slab->head = pkt;
+    slab->count++;
+}
+
+static void netint_destroy_job_pool(struct netint_ctx *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    struct netint_frame_job *head = NULL;
+
+    if (ctx->job_pool_mutex_initialized) {
+        pthread_mutex_lock(&ctx->job_pool_mutex);
+        head = ctx->job_pool_head;
+        ctx->job_pool_head = NULL;
+        ctx->job_pool_size = 0;
+        pthread_mutex_unlock(&ctx->job_pool_mutex);
+
+        pthread_mutex_destroy(&ctx->job_pool_mutex);
+        ctx->job_pool_mutex_initialized = false;
+    } else {
+        head = ctx->job_pool_head;
+        ctx->job_pool_head = NULL;
+        ctx->job_pool_size = 0;
+    }
+
+	while (head) {
+		struct netint_frame_job *next = head->next;
+        if (head->roi_data) {
+            bfree(head->roi_data);
+            head->roi_data = NULL;
+            head->roi_data_size = 0;
+            head->roi_data_capacity = 0;
+        }
+		netint_job_release_hw_frame(head);
+		bfree(head);
+		head = next;
+	}
+
+    netint_job_release_hw_frame(&ctx->control_job);
+    ctx->job_pool_capacity = 0;
+}
+
+static bool netint_init_job_pool(struct netint_ctx *ctx)
+{
+    if (!ctx) {
+        return false;
+    }
+
+    /* One job per pipeline slot, plus the one OBS is filling while blocked */
+    ctx->job_pool_capacity = (int)ctx->max_pipeline_depth + 1;
+    int prealloc = ctx->job_pool_capacity < NETINT_JOB_POOL_PREALLOC ? ctx->job_pool_capacity
+                                                                      : NETINT_JOB_POOL_PREALLOC;
+
+    if (pthread_mutex_init(&ctx->job_pool_mutex, NULL) != 0) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize job pool mutex");
+        ctx->job_pool_mutex_initialized = false;
+        return false;
+    }
+
+    ctx->job_pool_mutex_initialized = true;
+    ctx->job_pool_head = NULL;
+    ctx->job_pool_size = 0;
+
+    for (int i = 0; i < prealloc; i++) {
+        struct netint_frame_job *job = bzalloc(sizeof(*job));
+        if (!job) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate frame job for pool");
+            netint_destroy_job_pool(ctx);
+            return false;
+        }
+
+        job->from_pool = true;
+		if (!netint_job_allocate_hw_frame(ctx, job)) {
+			bfree(job);
+			netint_destroy_job_pool(ctx);
+			return false;
+        }
+
+        job->next = ctx->job_pool_head;
+        ctx->job_pool_head = job;
+        ctx->job_pool_size++;
+    }
+
+    /* Control frames get their own buffer so flush and shutdown never
+     * allocate or take a job away from the frames still in the pipeline */
+    if (!netint_job_allocate_hw_frame(ctx, &ctx->control_job)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate control frame");
+        netint_destroy_job_pool(ctx);
+        return false;
+    }
+
+    blog(LOG_INFO, "[obs-netint-t4xx] Initialized frame job pool (preallocated=%d, capacity=%d, frame_size=%zu)",
+         ctx->job_pool_size, ctx->job_pool_capacity, ctx->hw_frame_size);
+    return true;
+}
+
+/* netint_numa_run_on_node() callback */
+static bool netint_init_buffer_pools(void *data)
+{
+    struct netint_ctx *ctx = data;
+
+    if (!netint_init_packet_pool(ctx)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize packet pool");
+        return false;
+    }
+
+    if (!netint_init_job_pool(ctx)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize frame job pool");
+        return false;
+    }
+    return true;
+}
+
+static struct netint_frame_job *netint_acquire_job(struct netint_ctx *ctx, bool require_buffer)
+{
+    struct netint_frame_job *job = NULL;
+
+    if (ctx->job_pool_mutex_initialized) {
+        pthread_mutex_lock(&ctx->job_pool_mutex);
+        if (ctx->job_pool_head) {
+            job = ctx->job_pool_head;
+            ctx->job_pool_head = job->next;
+            ctx->job_pool_size--;
+        }
+        pthread_mutex_unlock(&ctx->job_pool_mutex);
+    }
+
+	if (job) {
+		job->next = NULL;
+		job->from_pool = true;
+        job->roi_data_size = 0;
+
+		if (require_buffer && ctx->hw_frame_size > 0 &&
+		    job->hw_frame_capacity < ctx->hw_frame_size) {
+			netint_job_release_hw_frame(job);
+			if (!netint_job_allocate_hw_frame(ctx, job)) {
+				netint_release_job(ctx, job);
+				return NULL;
+			}
+		}
+
+		return job;
+	}
+
+	job = bzalloc(sizeof(*job));
+	if (!job) {
+		blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate frame job (pool empty)");
+		return NULL;
+	}
+
+	/* Pool grows on demand: the job is kept on release while under capacity */
+	job->from_pool = ctx->job_pool_mutex_initialized;
+	if (!netint_job_allocate_hw_frame(ctx, job)) {
+		bfree(job);
+		return NULL;
+	}
+
+	return job;
+}
+
+static void netint_release_job(struct netint_ctx *ctx, struct netint_frame_job *job)
+{
+    if (!job) {
+        return;
+    }
+
+    if (job == &ctx->control_job) {
+        job->pts = 0;
+        job->start_of_stream = false;
+        job->end_of_stream = false;
+        os_atomic_set_bool(&ctx->control_job_busy, false);
+        return;
+    }
+
+    /* Pooled jobs keep their ROI buffer for the next frame */
+    job->roi_data_size = 0;
+
+    netint_frame_cache_release(job->shared);
+    job->shared = NULL;
+
+    if (job->from_pool && ctx->job_pool_mutex_initialized) {
+        job->pts = 0;
+        job->start_of_stream = false;
+        job->end_of_stream = false;
+		job->hw_frame_capacity = ctx->hw_frame_size;
+        job->next = NULL;
+
+        pthread_mutex_lock(&ctx->job_pool_mutex);
+        if (ctx->job_pool_size < ctx->job_pool_capacity) {
+            job->next = ctx->job_pool_head;
+            ctx->job_pool_head = job;
+            ctx->job_pool_size++;
+            pthread_mutex_unlock(&ctx->job_pool_mutex);
+            return;
+        }
+        pthread_mutex_unlock(&ctx->job_pool_mutex);
+        /* Pool full - fall through to free */
+    }
+
+	netint_job_release_hw_frame(job);
+    bfree(job->roi_data);
+    bfree(job);
+}
+
+/**
+ * @brief Resize the pipeline to @p inflight frames in the card
+ *
+ * Called from create and, in auto mode, from the IO thread. The job pool
+ * retains at most one job per pipeline slot; jobs beyond that are freed here
+ * when shrinking, and new ones are allocated lazily when growing.
+ */
+static void netint_set_pipeline_depth(struct netint_ctx *ctx, int inflight)
+{
+    struct netint_frame_job *excess = NULL;
+
+    if (inflight < ctx->reorder_depth + 1) {
+        inflight = ctx->reorder_depth + 1;
+    }
+    if (inflight > NETINT_PIPELINE_MAX_INFLIGHT) {
+        inflight = NETINT_PIPELINE_MAX_INFLIGHT;
+    }
+
+    ctx->max_inflight = inflight;
+    os_atomic_store_long(&ctx->max_pipeline_depth, inflight + NETINT_PIPELINE_QUEUE_SLACK);
+
+    if (ctx->job_pool_mutex_initialized) {
+        pthread_mutex_lock(&ctx->job_pool_mutex);
+        ctx->job_pool_capacity = inflight + NETINT_PIPELINE_QUEUE_SLACK + 1;
+        while (ctx->job_pool_size > ctx->job_pool_capacity && ctx->job_pool_head) {
+            struct netint_frame_job *job = ctx->job_pool_head;
+            ctx->job_pool_head = job->next;
+            ctx->job_pool_size--;
+            job->next = excess;
+            excess = job;
+        }
+        pthread_mutex_unlock(&ctx->job_pool_mutex);
+    }
+
+    while (excess) {
+        struct netint_frame_job *next = excess->next;
+        netint_job_release_hw_frame(excess);
+        bfree(excess);
+        excess = next;
+    }
+
+    /* A deeper pipeline may release a producer waiting for space */
+    if (ctx->rings_initialized) {
+        netint_ring_wake(&ctx->job_ring);
+    }
+}
+
+/**
+ * @brief Remember when a frame went to the card (IO thread)
  */
-static void netint_destroy(void *data)
+static void netint_latency_mark_sent(struct netint_ctx *ctx, int64_t pts)
 {
-    struct netint_ctx *ctx = data;
-    if (!ctx) return;
-    
-    blog(LOG_INFO, "[obs-netint-t4xx] ========================================");
-    blog(LOG_INFO, "[obs-netint-t4xx] netint_destroy called - closing encoder");
-    blog(LOG_INFO, "[obs-netint-t4xx] ========================================");
-    
-    /* Check EOS handshake status */
-    blog(LOG_INFO, "[obs-netint-t4xx] EOS handshake status:");
-    blog(LOG_INFO, "[obs-netint-t4xx]   flushing = %d (should be 1 if stop was requested)", ctx->flushing);
-    blog(LOG_INFO, "[obs-netint-t4xx]   encoder_eof = %d (should be 1 if EOS acknowledged)", ctx->enc.encoder_eof);
-    
-    if (ctx->flushing && ctx->enc.encoder_eof) {
-        blog(LOG_INFO, "[obs-netint-t4xx] ✅ PROPER SHUTDOWN: EOS handshake completed successfully");
-    } else if (ctx->flushing && !ctx->enc.encoder_eof) {
-        blog(LOG_WARNING, "[obs-netint-t4xx] ⚠️  INCOMPLETE SHUTDOWN: EOS sent but not acknowledged by encoder");
-        blog(LOG_WARNING, "[obs-netint-t4xx] This may indicate encoder is still processing or thread stopped early");
-    } else {
-        blog(LOG_WARNING, "[obs-netint-t4xx] ⚠️  ABRUPT SHUTDOWN: No EOS handshake performed");
-        blog(LOG_WARNING, "[obs-netint-t4xx] OBS skipped flush - we'll send EOS frame now in destroy");
+    int slot = (int)(ctx->frame_count & (NETINT_LATENCY_SLOTS - 1));
+    ctx->send_pts[slot] = pts;
+    ctx->send_time_ns[slot] = os_gettime_ns();
+}
+
+/**
+ * @brief Record the latency of the frame behind @p pts and, in auto mode,
+ *        fold it into the pipeline depth
+ *
+ * By Little's law the card holds latency / frame interval frames on
+ * average; the pipeline is kept one frame deeper than that. It grows as soon
+ * as a measurement asks for it and shrinks one frame at a time only after
+ * NETINT_PIPELINE_SHRINK_VOTES consecutive evaluations agree, so a single
+ * fast stretch doesn't starve the card.
+ */
+static void netint_latency_mark_received(struct netint_ctx *ctx, int64_t pts)
+{
+    uint64_t sent_ns = 0;
+
+    for (int i = 0; i < NETINT_LATENCY_SLOTS; i++) {
+        if (ctx->send_time_ns[i] && ctx->send_pts[i] == pts) {
+            sent_ns = ctx->send_time_ns[i];
+            ctx->send_time_ns[i] = 0;
+            break;
+        }
+    }
+    if (!sent_ns) {
+        return;
     }
 
-#ifdef DEBUG_NETINT_PLUGIN
-    /* Validate magic before destroy */
-    if (ctx->debug_magic != NETINT_ENC_CONTEXT_MAGIC) {
-        blog(LOG_WARNING, "[DEBUG] Invalid context magic in netint_destroy: 0x%08X", ctx->debug_magic);
+    uint64_t sample = os_gettime_ns() - sent_ns;
+    netint_hist_record(&ctx->telemetry.hist[NETINT_METRIC_HW_LATENCY_US], sample / 1000);
+    if (ctx->pipeline_mode != NETINT_PIPELINE_AUTO || !ctx->frame_interval_ns) {
+        return;
     }
-#endif
-    
-    /* ===================================================================
-     * Send EOS frame if not already done (OBS doesn't call flush for this encoder)
-     * ===================================================================
-     */
-    if (ctx->thread_created) {
-        if (!ctx->flushing && ctx->enc.p_session_ctx) {
-            blog(LOG_INFO, "[obs-netint-t4xx] Queueing EOS job during destroy");
-            if (netint_queue_eos(ctx)) {
-                ctx->flushing = true;
-            } else {
-                blog(LOG_ERROR, "[obs-netint-t4xx] Failed to queue EOS job during destroy");
-            }
-        }
 
-        blog(LOG_INFO, "[obs-netint-t4xx] Stopping IO thread...");
-        if (ctx->frame_queue_mutex_initialized) {
-            pthread_mutex_lock(&ctx->frame_queue_mutex);
-            ctx->stop_thread = true;
-            if (ctx->frame_queue_cond_initialized) {
-                pthread_cond_broadcast(&ctx->frame_queue_cond);
-            }
-            pthread_mutex_unlock(&ctx->frame_queue_mutex);
-        } else {
-            ctx->stop_thread = true;
-            if (ctx->frame_queue_cond_initialized) {
-                pthread_cond_broadcast(&ctx->frame_queue_cond);
-            }
+    ctx->hw_latency_ns = ctx->hw_latency_ns ? (ctx->hw_latency_ns * 7 + sample) / 8 : sample;
+
+    if (--ctx->adapt_countdown > 0) {
+        return;
+    }
+    ctx->adapt_countdown = NETINT_PIPELINE_ADAPT_INTERVAL;
+
+    int wanted = (int)((ctx->hw_latency_ns + ctx->frame_interval_ns - 1) / ctx->frame_interval_ns) + 1;
+    if (wanted < ctx->reorder_depth + 1) {
+        wanted = ctx->reorder_depth + 1;
+    }
+    if (wanted > NETINT_PIPELINE_MAX_INFLIGHT) {
+        wanted = NETINT_PIPELINE_MAX_INFLIGHT;
+    }
+
+    int target = ctx->max_inflight;
+    if (wanted > ctx->max_inflight) {
+        target = wanted;
+        ctx->shrink_votes = 0;
+    } else if (wanted < ctx->max_inflight) {
+        if (++ctx->shrink_votes >= NETINT_PIPELINE_SHRINK_VOTES) {
+            target = ctx->max_inflight - 1;
+            ctx->shrink_votes = 0;
         }
+    } else {
+        ctx->shrink_votes = 0;
+    }
 
-        pthread_join(ctx->io_thread, NULL);
-        blog(LOG_INFO, "[obs-netint-t4xx] IO thread stopped");
-        ctx->thread_created = false;
+    if (target != ctx->max_inflight) {
+        blog(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Auto pipeline depth %d -> %d frames (hw latency %.1f ms)",
+             ctx->max_inflight, target, (double)ctx->hw_latency_ns / 1000000.0);
+        netint_set_pipeline_depth(ctx, target);
     }
+}
 
-    /* Free any remaining frame jobs (should be none) */
-    if (ctx->frame_queue_mutex_initialized) {
-        struct netint_frame_job *pending_job = NULL;
-        while ((pending_job = netint_dequeue_job(ctx, false)) != NULL) {
-            netint_release_job(ctx, pending_job);
+/* netint_ring_wait() conditions; stop_thread always ends the wait */
+static bool netint_job_ring_has_space(void *param)
+{
+    struct netint_ctx *ctx = param;
+    /* Jobs marked for dropping still sit in the ring but no longer count */
+    return os_atomic_load_bool(&ctx->stop_thread) ||
+           netint_ring_count(&ctx->job_ring) - os_atomic_load_long(&ctx->pending_drops) +
+                   os_atomic_load_long(&ctx->inflight_frames) <
+               os_atomic_load_long(&ctx->max_pipeline_depth);
+}
+
+static bool netint_job_ring_has_jobs(void *param)
+{
+    struct netint_ctx *ctx = param;
+    return os_atomic_load_bool(&ctx->stop_thread) || netint_ring_count(&ctx->job_ring) > 0;
+}
+
+static bool netint_pkt_ring_has_space(void *param)
+{
+    struct netint_ctx *ctx = param;
+    return os_atomic_load_bool(&ctx->stop_thread) ||
+           netint_ring_count(&ctx->pkt_ring) < ctx->pkt_ring.capacity;
+}
+
+/**
+ * @brief Hand a frame job to the IO thread (OBS thread only)
+ *
+ * Blocks only while queued jobs plus frames in the card have reached
+ * max_pipeline_depth; the IO thread wakes us when a packet comes back.
+ */
+static bool netint_enqueue_job(struct netint_ctx *ctx, struct netint_frame_job *job, bool count_frame)
+{
+    if (!ctx->rings_initialized) {
+        return false;
+    }
+
+    uint64_t wait_us = 0;
+    if (os_atomic_load_long(&ctx->max_pipeline_depth) > 0 && !netint_job_ring_has_space(ctx)) {
+        uint64_t start_ns = os_gettime_ns();
+        os_atomic_inc_long(&ctx->telemetry.stalls);
+        netint_ring_wait(&ctx->job_ring, netint_job_ring_has_space, ctx, NETINT_WAIT_INFINITE);
+        wait_us = (os_gettime_ns() - start_ns) / 1000;
+    }
+    netint_hist_record(&ctx->telemetry.hist[NETINT_METRIC_QUEUE_WAIT_US], wait_us);
+
+    if (os_atomic_load_bool(&ctx->stop_thread)) {
+        return false;
+    }
+
+    job->start_of_stream = count_frame && ctx->frames_submitted == 0;
+    job->next = NULL;
+
+    if (!netint_ring_push(&ctx->job_ring, job)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Frame job ring full (%ld jobs)", ctx->job_ring.capacity);
+        return false;
+    }
+
+    if (count_frame) {
+        ctx->frames_submitted++;
+        os_atomic_inc_long(&ctx->telemetry.frames_in);
+    }
+
+    /* The ring push wakes a dedicated IO thread; a reactor worker is kicked */
+    if (ctx->io_attached) {
+        netint_reactor_kick(&ctx->io_client);
+    }
+    return true;
+}
+
+/**
+ * @brief Tell listeners that frames are being lost to overload (OBS thread)
+ *
+ * OBS has no way for an encoder to report dropped input frames, so the
+ * global signal netint_t4xx_overload carries the running totals, at most
+ * once a second per session.
+ */
+static void netint_signal_overload(struct netint_ctx *ctx)
+{
+    uint64_t now_ns = os_gettime_ns();
+    if (now_ns < ctx->next_overload_signal_ns) {
+        return;
+    }
+    ctx->next_overload_signal_ns = now_ns + 1000000000ULL;
+
+    long dropped = os_atomic_load_long(&ctx->telemetry.frames_dropped);
+    long skipped = os_atomic_load_long(&ctx->telemetry.frames_skipped);
+    blog(LOG_WARNING, "[obs-netint-t4xx] Encoder overloaded: %ld frame(s) dropped, %ld skipped so far",
+         dropped, skipped);
+
+    signal_handler_t *sh = obs_get_signal_handler();
+    if (sh) {
+        uint8_t stack[128];
+        struct calldata cd;
+        calldata_init_fixed(&cd, stack, sizeof(stack));
+        calldata_set_ptr(&cd, "encoder", ctx->encoder);
+        calldata_set_int(&cd, "dropped", dropped);
+        calldata_set_int(&cd, "skipped", skipped);
+        signal_handler_signal(sh, "netint_t4xx_overload", &cd);
+    }
+}
+
+/**
+ * @brief Apply the overload policy before a new frame is prepared (OBS thread)
+ *
+ * With the block policy this does nothing and netint_enqueue_job() waits as
+ * before. drop_oldest asks the IO thread to discard one queued job; if every
+ * frame is already in the card there is nothing to drop and the new frame is
+ * skipped. Checked before the upload so a skipped frame costs no copy.
+ *
+ * @return false if the new frame must be skipped
+ */
+static bool netint_pipeline_admit(struct netint_ctx *ctx)
+{
+    if (ctx->overload_policy == NETINT_OVERLOAD_BLOCK || !ctx->rings_initialized ||
+        netint_job_ring_has_space(ctx)) {
+        return true;
+    }
+
+    if (ctx->overload_policy == NETINT_OVERLOAD_DROP_OLDEST) {
+        long queued = netint_ring_count(&ctx->job_ring);
+        if (queued - os_atomic_load_long(&ctx->pending_drops) > 0 && queued < ctx->job_ring.capacity) {
+            os_atomic_inc_long(&ctx->pending_drops);
+            netint_signal_overload(ctx);
+            return true;
         }
     }
 
-    netint_destroy_job_pool(ctx);
-    
-    /* Free all queued packets */
-    if (ctx->last_delivered_pkt) {
-        netint_free_packet(ctx->last_delivered_pkt);
-        ctx->last_delivered_pkt = NULL;
+    os_atomic_inc_long(&ctx->telemetry.frames_skipped);
+    netint_signal_overload(ctx);
+    return false;
+}
+
+/**
+ * @brief Discard @p job instead of sending it if a drop is pending (IO thread)
+ *
+ * Key frames, EOS and a job carrying the ROI map the encoder will cache are
+ * never dropped; the request then falls to the next queued frame. Requests
+ * still pending once the ring is empty had nothing left to drop and are
+ * cleared, so they neither drop a later frame that arrives without overload
+ * nor keep netint_job_ring_has_space() counting jobs that aren't there.
+ */
+static bool netint_drop_pending_job(struct netint_ctx *ctx, struct netint_frame_job *job)
+{
+    if (os_atomic_load_long(&ctx->pending_drops) <= 0) {
+        return false;
     }
 
-    struct netint_pkt *pkt = ctx->pkt_queue_head;
-    while (pkt) {
-        struct netint_pkt *next = pkt->next;
-        netint_free_packet(pkt);
-        pkt = next;
+    bool drop = !job->end_of_stream && !job->start_of_stream && !job->hw_frame.force_key_frame &&
+                !(ctx->roi_cache && job->roi_data_size > 0);
+    if (drop) {
+        os_atomic_dec_long(&ctx->pending_drops);
+        os_atomic_inc_long(&ctx->telemetry.frames_dropped);
     }
-    ctx->pkt_queue_head = NULL;
-    ctx->pkt_queue_tail = NULL;
 
-    netint_destroy_packet_pool(ctx);
-    
-    /* Destroy mutexes LAST (after thread is stopped!) */
-    if (ctx->frame_queue_cond_initialized) {
-        pthread_cond_destroy(&ctx->frame_queue_cond);
-        ctx->frame_queue_cond_initialized = false;
+    if (netint_ring_count(&ctx->job_ring) == 0) {
+        os_atomic_set_long(&ctx->pending_drops, 0);
     }
+    return drop;
+}
 
-    if (ctx->frame_queue_mutex_initialized) {
-        pthread_mutex_destroy(&ctx->frame_queue_mutex);
-        ctx->frame_queue_mutex_initialized = false;
+/**
+ * @brief Pop the next frame job for the IO thread
+ *
+ * @param timeout_ms 0 = don't wait, NETINT_WAIT_INFINITE = wait until a job
+ *                   arrives or the thread is stopped, otherwise wait at most
+ *                   this long (the IO thread uses this to keep polling the
+ *                   card for packets while frames are in flight)
+ * @return Job, or NULL on timeout/stop
+ */
+static struct netint_frame_job *netint_dequeue_job(struct netint_ctx *ctx, long timeout_ms)
+{
+    if (!ctx->rings_initialized) {
+        return NULL;
     }
 
-    if (ctx->queue_mutex_initialized) {
-        pthread_mutex_destroy(&ctx->queue_mutex);
-        ctx->queue_mutex_initialized = false;
+    if (timeout_ms != 0) {
+        netint_ring_wait(&ctx->job_ring, netint_job_ring_has_jobs, ctx, timeout_ms);
     }
-    
-    /* Close hardware encoder connection */
-    /* We use encode_open() for initialization, so use encode_close() for cleanup */
-    if (ctx->enc.p_session_ctx) {
-        blog(LOG_INFO, "[obs-netint-t4xx] Closing encoder session...");
-        if (p_ni_logan_encode_close) {
-            int close_ret = p_ni_logan_encode_close(&ctx->enc);
-            blog(LOG_INFO, "[obs-netint-t4xx] ni_logan_encode_close returned: %d", close_ret);
+
+    return netint_ring_pop(&ctx->job_ring);
+}
+
+/**
+ * @brief Upload a planar (I420 or I010) frame into a job's hardware buffer
+ *
+ * Each plane is repacked from the OBS linesize into the hw_stride/hw_height
+ * layout by the selected copy kernel, padding included, in a single pass.
+ * I010 already stores LSB-aligned 16-bit samples, so it is the same byte copy
+ * with twice the row width.
+ * libxcoder's scalar copy is kept as the fallback (NETINT_COPY_KERNEL=libxcoder).
+ */
+static bool netint_copy_planar_frame(struct netint_ctx *ctx, struct netint_frame_job *job,
+                                   const struct encoder_frame *frame,
+                                   uint8_t *dest_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    uint8_t *src_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
+        frame->data[0],
+        frame->data[1],
+        frame->data[2],
+        NULL};
+
+    int src_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
+        frame->linesize[0],
+        frame->linesize[1],
+        frame->linesize[2],
+        0};
+
+    int src_height[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
+        ctx->enc.height,
+        ctx->enc.height / 2,
+        ctx->enc.height / 2,
+        0};
+
+    /* Visible row widths in bytes */
+    int src_width[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
+        ctx->enc.width * ctx->bit_depth_factor,
+        (ctx->enc.width / 2) * ctx->bit_depth_factor,
+        (ctx->enc.width / 2) * ctx->bit_depth_factor,
+        0};
+
+    if (ctx->frames_submitted == 0) {
+        for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+            if (ctx->hw_plane_size[i] == 0)
+                continue;
+            blog(LOG_INFO,
+                 "[obs-netint-t4xx] Plane %d: src=%p dst=%p size=%zu src_stride=%d hw_stride=%d hw_height=%d job_capacity=%zu",
+                 i, (void *)src_planes[i], (void *)dest_planes[i],
+                 ctx->hw_plane_size[i], src_stride[i], ctx->hw_stride[i],
+                 ctx->hw_height[i], job->hw_frame_capacity);
         }
-    } else {
-        blog(LOG_INFO, "[obs-netint-t4xx] Skipping encode_close (p_session_ctx=%p)", 
-             ctx->enc.p_session_ctx);
-        /* NOTE: Do NOT manually free p_session_ctx or p_encoder_params! */
-        /* These were allocated by libxcoder_logan.dll and must be freed by it */
-        /* Cross-DLL memory management causes heap corruption on Windows */
     }
-    
-    /* Free device name strings (allocated by us with bstrdup) */
-    /* These are safe to free - we allocated them before calling library functions */
-    if (ctx->enc.dev_enc_name) {
-        bfree(ctx->enc.dev_enc_name);
-        ctx->enc.dev_enc_name = NULL;
+
+    if (ctx->use_libxcoder_copy) {
+        p_ni_logan_copy_hw_yuv420p(dest_planes,
+                                   src_planes,
+                                   ctx->enc.width,
+                                   ctx->enc.height,
+                                   ctx->bit_depth_factor,
+                                   ctx->hw_stride,
+                                   ctx->hw_height,
+                                   src_stride,
+                                   src_height);
+        return true;
     }
-    if (ctx->enc.dev_xcoder) {
-        bfree(ctx->enc.dev_xcoder);
-        ctx->enc.dev_xcoder = NULL;
+
+    /* The source planes are only src_height rows tall, while hw_height may be
+     * aligned up (H.264 pads to 16 rows) - never copy hw_plane_size bytes from
+     * OBS, always repack row by row and zero the padding. */
+    for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+        if (ctx->hw_plane_size[i] == 0)
+            continue;
+        if (!dest_planes[i]) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Hardware plane %d missing", i);
+            return false;
+        }
+        ctx->copy_kernels->copy_plane(dest_planes[i], ctx->hw_stride[i], ctx->hw_height[i],
+                                      src_planes[i], src_stride[i],
+                                      src_width[i], src_height[i]);
     }
-    
-    /* Free extradata (SPS/PPS headers) - allocated by us */
-    if (ctx->extra) {
-        bfree(ctx->extra);
-        ctx->extra = NULL;
-        ctx->extra_size = 0;
+    return true;
+}
+
+/**
+ * @brief Upload an NV12 frame into a job's hardware buffer
+ *
+ * Y is copied as-is and the interleaved UV plane is split straight into the
+ * U and V hardware planes - one pass, no intermediate I420 frame.
+ */
+static bool netint_copy_nv12_frame(struct netint_ctx *ctx, struct netint_frame_job *job,
+                                   const struct encoder_frame *frame,
+                                   uint8_t *dest_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    UNUSED_PARAMETER(job);
+
+    if (!frame->data[0] || !frame->data[1] || !dest_planes[0] || !dest_planes[1] || !dest_planes[2]) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] NV12 frame or hardware planes missing");
+        return false;
     }
-    
-    /* Free configuration strings - allocated by us */
-    if (ctx->rc_mode) bfree(ctx->rc_mode);
-    if (ctx->profile) bfree(ctx->profile);
-    if (ctx->gop_preset) bfree(ctx->gop_preset);
-    
-    /* enc is EMBEDDED in ctx, so it will be freed when ctx is freed */
-    /* No need to manually free it */
-    
-#ifdef DEBUG_NETINT_PLUGIN
-    /* Clear magic for use-after-free detection */
-    ctx->debug_magic = 0xFEEDFACE;  /* Freed marker */
-    blog(LOG_INFO, "[obs-netint-t4xx] Context %p marked as freed", ctx);
-#endif
-    
-    /* Free context structure itself */
-    bfree(ctx);
+
+    ctx->copy_kernels->copy_plane(dest_planes[0], ctx->hw_stride[0], ctx->hw_height[0],
+                                  frame->data[0], (int)frame->linesize[0],
+                                  ctx->enc.width, ctx->enc.height);
+    ctx->copy_kernels->deinterleave_uv(dest_planes[1], dest_planes[2], ctx->hw_stride[1], ctx->hw_height[1],
+                                       frame->data[1], (int)frame->linesize[1],
+                                       ctx->enc.width / 2, ctx->enc.height / 2);
+    return true;
+}
+
+/**
+ * @brief Upload a P010 frame into a job's 10-bit hardware buffer
+ *
+ * Like NV12, with 16-bit samples moved from the top to the bottom 10 bits
+ * while splitting, as the T4XX expects YUV420P10LE.
+ */
+static bool netint_copy_p010_frame(struct netint_ctx *ctx, struct netint_frame_job *job,
+                                   const struct encoder_frame *frame,
+                                   uint8_t *dest_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    UNUSED_PARAMETER(job);
+
+    if (!frame->data[0] || !frame->data[1] || !dest_planes[0] || !dest_planes[1] || !dest_planes[2]) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] P010 frame or hardware planes missing");
+        return false;
+    }
+
+    ctx->copy_kernels->copy_plane_p010(dest_planes[0], ctx->hw_stride[0], ctx->hw_height[0],
+                                       frame->data[0], (int)frame->linesize[0],
+                                       ctx->enc.width, ctx->enc.height);
+    ctx->copy_kernels->deinterleave_uv_p010(dest_planes[1], dest_planes[2], ctx->hw_stride[1], ctx->hw_height[1],
+                                            frame->data[1], (int)frame->linesize[1],
+                                            ctx->enc.width / 2, ctx->enc.height / 2);
+    return true;
+}
+
+/**
+ * @brief Acquire a frame job with a hardware buffer large enough for one frame
+ *
+ * Does not block on the pipeline depth; only netint_submit_frame_job() does,
+ * so callers may hold other locks (e.g. the graphics context) while filling
+ * the returned job.
+ */
+static struct netint_frame_job *netint_prepare_frame_job(struct netint_ctx *ctx, int64_t pts)
+{
+    struct netint_frame_job *job = netint_acquire_job(ctx, true);
+    if (!job) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to acquire frame job");
+        return NULL;
+    }
+
+	if (ctx->hw_frame_size > 0 &&
+	    (!job->hw_frame.p_buffer || job->hw_frame_capacity < ctx->hw_frame_size)) {
+		netint_job_release_hw_frame(job);
+		if (!netint_job_allocate_hw_frame(ctx, job)) {
+			blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate hardware buffer for frame job");
+			netint_release_job(ctx, job);
+			return NULL;
+		}
+	}
+
+    job->pts = pts;
+    job->end_of_stream = false;
+    job->start_of_stream = false;
+
+    if (ctx->hw_frame_size > 0 && !job->hw_frame.p_data[0]) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Frame job missing hardware buffer (%zu bytes expected)",
+             ctx->hw_frame_size);
+        netint_release_job(ctx, job);
+        return NULL;
+    }
+    return job;
+}
+
+/**
+ * @brief Copy a system-memory frame into a hardware buffer for a prepared job
+ *
+ * @p dst is the job's own hw_frame or a shared frame of the same layout.
+ * On failure the job is left untouched; the caller still owns it.
+ */
+static bool netint_upload_frame(struct netint_ctx *ctx, struct netint_frame_job *job, ni_logan_frame_t *dst,
+                                const struct encoder_frame *frame)
+{
+    bool ok = true;
+
+    if (ctx->hw_frame_size > 0) {
+        uint8_t *dest_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {0};
+        for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+            if (ctx->hw_plane_size[i] > 0) {
+				dest_planes[i] = (uint8_t *)dst->p_data[i];
+            }
+        }
+
+        uint64_t start_ns = os_gettime_ns();
+        switch (ctx->input_format) {
+        case VIDEO_FORMAT_NV12:
+            ok = netint_copy_nv12_frame(ctx, job, frame, dest_planes);
+            break;
+        case VIDEO_FORMAT_P010:
+            ok = netint_copy_p010_frame(ctx, job, frame, dest_planes);
+            break;
+        default:
+            ok = netint_copy_planar_frame(ctx, job, frame, dest_planes);
+            break;
+        }
+        netint_hist_record(&ctx->telemetry.hist[NETINT_METRIC_COPY_US], (os_gettime_ns() - start_ns) / 1000);
+    }
+    return ok;
 }
 
 /**
- * @brief Update encoder settings (called when user changes configuration)
- * 
- * Currently, this function returns false because the NETINT encoder doesn't support
- * dynamic parameter changes after initialization. Returning false signals to OBS
- * that it should destroy and recreate the encoder instance with new settings.
- * 
- * This is a limitation of the hardware encoder - parameters must be set at initialization.
- * To change settings, the encoder must be destroyed and recreated with new parameters.
- * 
- * Returning false is the correct approach: it tells OBS that the encoder cannot
- * be updated in place, and OBS will handle the recreation automatically.
- * 
- * Future enhancement: Could implement parameter change support if libxcoder API supports it.
- * 
- * @param data Encoder context (unused - encoder doesn't support updates)
- * @param settings New settings (unused - encoder doesn't support updates)
- * @return false (indicates encoder cannot be updated, OBS will recreate it)
+ * @brief Rebuild the converted ROI map if OBS changed the regions (OBS thread)
  */
-static bool netint_update(void *data, obs_data_t *settings)
+static void netint_roi_refresh(struct netint_ctx *ctx)
 {
-    UNUSED_PARAMETER(data);
-    UNUSED_PARAMETER(settings);
-    /* Return false to indicate encoder doesn't support dynamic updates */
-    /* OBS will destroy and recreate the encoder with new settings */
-    blog(LOG_INFO, "[obs-netint-t4xx] Encoder settings changed - encoder will be recreated");
-    return false;
+    uint32_t increment = obs_encoder_get_roi_increment(ctx->encoder);
+    if (ctx->roi_map_valid && increment == ctx->roi_increment) {
+        return;
+    }
+
+    struct netint_roi_fill_ctx fill_ctx = {
+        .entries = ctx->roi_map,
+        .index = 0,
+        .capacity = ctx->roi_capacity,
+        .width = (uint32_t)ctx->enc.width,
+        .height = (uint32_t)ctx->enc.height,
+    };
+    if (obs_encoder_has_roi(ctx->encoder)) {
+        obs_encoder_enum_roi(ctx->encoder, netint_roi_fill_cb, &fill_ctx);
+    }
+
+    ctx->roi_map = fill_ctx.entries;
+    ctx->roi_capacity = fill_ctx.capacity;
+    ctx->roi_count = fill_ctx.index;
+    ctx->roi_increment = increment;
+    ctx->roi_map_valid = true;
+    ctx->roi_queued = false;
 }
 
 /**
- * @brief Specify preferred video format for encoder input
- * 
- * This function tells OBS what pixel format we want frames in.
- * NETINT encoder requires I420 (planar YUV420) format, not NV12.
- * 
- * @param data Encoder context (unused)
- * @param info Video scale info - we set info->format to our preferred format
+ * @brief Attach the ROI map to a frame job if this frame needs one (OBS thread)
+ *
+ * The map is only converted when OBS's ROI increment changes. Without
+ * roi_cache the encoder needs the map on every frame, so it is copied into
+ * the job's own buffer each time. With roi_cache the encoder keeps the last
+ * map, so only the first frame after a change carries it; when the regions
+ * are removed, a neutral full-frame region replaces the cached map.
  */
-static void netint_get_video_info(void *data, struct video_scale_info *info)
+static void netint_roi_attach(struct netint_ctx *ctx, struct netint_frame_job *job)
 {
-    UNUSED_PARAMETER(data);
-    info->format = VIDEO_FORMAT_I420;
-}
+    struct netint_roi_entry neutral;
+
+    netint_roi_refresh(ctx);
+
+    /* A reopened session starts without a map, as a fresh one does. After a
+     * failed send the encoder may still hold the map before the lost one, so
+     * a cleared map still goes out as a neutral region. */
+    bool reopened = os_atomic_set_bool(&ctx->roi_resend, false);
+    bool lost = os_atomic_set_bool(&ctx->roi_lost, false);
+    if (reopened || lost) {
+        ctx->roi_queued = false;
+        ctx->roi_encoder_has_map = !reopened;
+    }
 
-static void netint_free_packet(struct netint_pkt *pkt)
-{
-    if (!pkt) {
+    const struct netint_roi_entry *map = ctx->roi_map;
+    size_t count = ctx->roi_count;
+    if (ctx->roi_cache) {
+        if (ctx->roi_queued) {
+            return;
+        }
+        if (count == 0 && ctx->roi_encoder_has_map) {
+            memset(&neutral, 0, sizeof(neutral));
+            neutral.self_size = (uint32_t)sizeof(neutral);
+            neutral.bottom = ctx->enc.height;
+            neutral.right = ctx->enc.width;
+            neutral.qoffset.den = 1000;
+            map = &neutral;
+            count = 1;
+        }
+    }
+
+    if (count == 0) {
+        ctx->roi_queued = true;
         return;
     }
 
-    if (pkt->data) {
-        bfree(pkt->data);
-        pkt->data = NULL;
+    size_t roi_bytes = count * sizeof(struct netint_roi_entry);
+    if (job->roi_data_capacity < roi_bytes) {
+        uint8_t *buffer = brealloc(job->roi_data, roi_bytes);
+        if (!buffer) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Failed to allocate ROI side data (%zu bytes)", roi_bytes);
+            return;
+        }
+        job->roi_data = buffer;
+        job->roi_data_capacity = roi_bytes;
     }
 
-    pkt->capacity = 0;
-    pkt->size = 0;
-    bfree(pkt);
+    memcpy(job->roi_data, map, roi_bytes);
+    job->roi_data_size = roi_bytes;
+    ctx->roi_queued = true;
+    ctx->roi_encoder_has_map = (ctx->roi_count > 0);
 }
 
-static bool netint_init_packet_pool(struct netint_ctx *ctx)
+/**
+ * @brief Finalize a filled frame job (flags, ROI) and hand it to the IO thread
+ *
+ * Blocks while the pipeline is full. Takes ownership of the job.
+ */
+static bool netint_submit_frame_job(struct netint_ctx *ctx, struct netint_frame_job *job)
 {
-    if (!ctx) {
+	job->hw_frame.pts = job->pts;
+	job->hw_frame.dts = job->pts;
+	job->hw_frame.start_of_stream = job->start_of_stream ? 1 : 0;
+	job->hw_frame.end_of_stream = 0;
+	job->hw_frame.force_key_frame = job->start_of_stream ? 1 : 0;
+	job->hw_frame.ni_logan_pict_type = job->start_of_stream ? LOGAN_PIC_TYPE_IDR : 0;
+
+    if (ctx->roi_enabled && ctx->roi_supported && p_ni_logan_enc_prep_aux_data) {
+        netint_roi_attach(ctx, job);
+    }
+
+    if (!netint_enqueue_job(ctx, job, true)) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to enqueue frame job (encoder shutting down?)");
+        netint_release_job(ctx, job);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Attach the group's shared upload of @p frame to a job (OBS thread)
+ *
+ * The first encoder of the group to see the frame copies it, the others only
+ * take a reference.
+ *
+ * @return false if the frame is not shared; the job's own buffer must be used
+ */
+static bool netint_share_frame(struct netint_ctx *ctx, struct netint_frame_job *job,
+                               const struct encoder_frame *frame)
+{
+    bool fresh = false;
+
+    /* OBS reuses a frame's planes after a few intervals; half of one is safe */
+    struct netint_shared_frame *shared =
+        netint_frame_cache_get(ctx->frame_group, frame, ctx->frame_interval_ns / 2, &fresh);
+    if (!shared) {
         return false;
     }
 
-    ctx->pkt_pool_head = NULL;
-    ctx->pkt_pool_size = 0;
-    ctx->pkt_pool_capacity = MAX_PKT_QUEUE_SIZE * 2;
-    if (ctx->pkt_pool_capacity < NETINT_PKT_POOL_MIN_CAPACITY) {
-        ctx->pkt_pool_capacity = NETINT_PKT_POOL_MIN_CAPACITY;
+    if (fresh) {
+        if (!netint_upload_frame(ctx, job, &shared->hw_frame, frame)) {
+            netint_frame_cache_release(shared);
+            return false;
+        }
+        netint_frame_cache_publish(shared, frame);
+    } else {
+        ctx->shared_frames++;
     }
-    ctx->last_delivered_pkt = NULL;
+
+    job->shared = shared;
     return true;
 }
 
-static void netint_destroy_packet_pool(struct netint_ctx *ctx)
+static bool netint_queue_frame(struct netint_ctx *ctx, struct encoder_frame *frame)
 {
-    if (!ctx) {
-        return;
+    if (!netint_pipeline_admit(ctx)) {
+        return true;
     }
 
-    struct netint_pkt *head = NULL;
-    head = ctx->pkt_pool_head;
-    ctx->pkt_pool_head = NULL;
-    ctx->pkt_pool_size = 0;
+    struct netint_frame_job *job = netint_prepare_frame_job(ctx, frame->pts);
+    if (!job) {
+        return false;
+    }
 
-    while (head) {
-        struct netint_pkt *next = head->next;
-        netint_free_packet(head);
-        head = next;
+    if (!netint_share_frame(ctx, job, frame) && !netint_upload_frame(ctx, job, &job->hw_frame, frame)) {
+        netint_release_job(ctx, job);
+        return false;
     }
 
-	ctx->pkt_pool_capacity = 0;
+    return netint_submit_frame_job(ctx, job);
 }
 
-static bool netint_job_allocate_hw_frame(struct netint_ctx *ctx, struct netint_frame_job *job)
+static bool netint_queue_eos(struct netint_ctx *ctx)
 {
-	if (!ctx || !job) {
-		return false;
+    struct netint_frame_job *job = &ctx->control_job;
+    if (os_atomic_set_bool(&ctx->control_job_busy, true)) {
+        /* An EOS is already on its way */
+        return true;
+    }
+
+    job->pts = 0;
+    job->end_of_stream = true;
+    job->start_of_stream = false;
+	job->hw_frame.pts = 0;
+	job->hw_frame.dts = 0;
+	job->hw_frame.start_of_stream = 0;
+	job->hw_frame.end_of_stream = 1;
+	job->hw_frame.force_key_frame = 0;
+	job->hw_frame.ni_logan_pict_type = 0;
+
+    if (!netint_enqueue_job(ctx, job, false)) {
+        netint_log(LOG_WARNING, "[obs-netint-t4xx] Failed to enqueue EOS job (encoder shutting down)");
+        netint_release_job(ctx, job);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief The job's ROI map never reached the card: attach it again (IO thread)
+ *
+ * With roi_cache only one job carries each map, so losing it would leave the
+ * encoder on the old map until the regions change again.
+ */
+static void netint_roi_unsent(struct netint_ctx *ctx, const struct netint_frame_job *job)
+{
+	if (ctx->roi_cache && job->roi_data_size > 0) {
+		os_atomic_set_bool(&ctx->roi_lost, true);
 	}
+}
 
-	memset(&job->hw_frame, 0, sizeof(job->hw_frame));
-	job->hw_frame.extra_data_len = 64;
+static bool netint_hw_send_job(struct netint_ctx *ctx, struct netint_frame_job *job)
+{
+	bool success = false;
 
-	int alloc_ret = p_ni_logan_encoder_frame_buffer_alloc(&job->hw_frame, ctx->enc.width,
-							      ctx->enc.height, ctx->hw_stride,
-							      (ctx->codec_type == 0) ? 1 : 0,
-							      job->hw_frame.extra_data_len, 1);
-	if (alloc_ret != NI_LOGAN_RETCODE_SUCCESS) {
-		blog(LOG_ERROR,
-		     "[obs-netint-t4xx] Failed to allocate persistent frame buffer for job (ret=%d)",
-		     alloc_ret);
-		netint_log_error(ctx, "ni_logan_encoder_frame_buffer_alloc", alloc_ret);
-		memset(&job->hw_frame, 0, sizeof(job->hw_frame));
-		job->hw_frame_capacity = 0;
+	/* The watchdog gave up on this session and closed it */
+	if (os_atomic_load_bool(&ctx->encoder_failed)) {
 		return false;
 	}
 
-	job->hw_frame_capacity = ctx->hw_frame_size;
-
-	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-		if (ctx->hw_plane_size[i] > 0) {
-			job->hw_frame.data_len[i] = (uint32_t)ctx->hw_plane_size[i];
-		} else {
-			job->hw_frame.data_len[i] = 0;
-		}
+	int get_ret = p_ni_logan_encode_get_frame(&ctx->enc);
+	if (get_ret < 0) {
+		netint_log(LOG_ERROR, "[obs-netint-t4xx] ni_logan_encode_get_frame failed (ret=%d)", get_ret);
+		netint_log_error(ctx, "ni_logan_encode_get_frame", get_ret);
+		netint_roi_unsent(ctx, job);
+		return false;
 	}
 
-	job->hw_frame.video_width = ctx->enc.width;
-	job->hw_frame.video_height = ctx->enc.height;
-	job->hw_frame.video_orig_width = ctx->enc.width;
-	job->hw_frame.video_orig_height = ctx->enc.height;
-	job->hw_frame.color_primaries = (uint8_t)ctx->enc.color_primaries;
-	job->hw_frame.color_trc = (uint8_t)ctx->enc.color_trc;
-	job->hw_frame.color_space = (uint8_t)ctx->enc.color_space;
-	job->hw_frame.video_full_range_flag = ctx->enc.color_range;
-	job->hw_frame.sar_width = (uint16_t)ctx->enc.sar_num;
-	job->hw_frame.sar_height = (uint16_t)ctx->enc.sar_den;
-	job->hw_frame.vui_num_units_in_tick = (uint32_t)ctx->enc.timebase_num;
-	job->hw_frame.vui_time_scale = (uint32_t)ctx->enc.timebase_den;
-	job->hw_frame.bit_depth = 8;
+	ni_logan_session_data_io_t *input_fme = ctx->enc.p_input_fme;
+	if (!input_fme) {
+		netint_log(LOG_ERROR, "[obs-netint-t4xx] p_input_fme is NULL after encode_get_frame");
+		netint_roi_unsent(ctx, job);
+		return false;
+	}
 
-	return true;
-}
+	ni_logan_frame_t *ni_frame = &input_fme->data.frame;
 
-static void netint_job_release_hw_frame(struct netint_frame_job *job)
-{
-	if (!job) {
-		return;
+	/* A shared buffer also carries the aux data prepared below, so other
+	 * encoders wait until this send has consumed it */
+	if (job->shared) {
+		pthread_mutex_lock(&job->shared->send_mutex);
 	}
 
-	if (job->hw_frame.p_buffer && p_ni_logan_frame_buffer_free) {
-		p_ni_logan_frame_buffer_free(&job->hw_frame);
+	/* EOS uses the context's control job, which has a buffer of its own */
+	if (job->shared) {
+		*ni_frame = job->shared->hw_frame;
+	} else if (job->hw_frame.p_buffer) {
+		*ni_frame = job->hw_frame;
+	} else if (!job->end_of_stream && ctx->hw_frame_size > 0) {
+		netint_log(LOG_ERROR, "[obs-netint-t4xx] Job missing pre-allocated hardware buffer");
+		netint_roi_unsent(ctx, job);
+		return false;
+	} else {
+		memset(ni_frame, 0, sizeof(*ni_frame));
 	}
 
-	memset(&job->hw_frame, 0, sizeof(job->hw_frame));
-	job->hw_frame_capacity = 0;
-}
-
-static struct netint_pkt *netint_acquire_packet(struct netint_ctx *ctx, size_t required_size)
-{
-    if (!ctx) {
-        return NULL;
-    }
+	ni_frame->video_width = ctx->enc.width;
+	ni_frame->video_height = ctx->enc.height;
+	ni_frame->video_orig_width = ctx->enc.width;
+	ni_frame->video_orig_height = ctx->enc.height;
+	ni_frame->pts = job->end_of_stream ? 0 : job->pts;
+	ni_frame->dts = ni_frame->pts;
+	/* The first frame into a session the watchdog reopened starts its stream */
+	bool start_of_stream = job->start_of_stream || (ctx->restart_stream && !job->end_of_stream);
+	ni_frame->start_of_stream = start_of_stream ? 1 : 0;
+	ni_frame->end_of_stream = job->end_of_stream ? 1 : 0;
+	ni_frame->force_key_frame = start_of_stream ? 1 : 0;
+	ni_frame->ni_logan_pict_type = start_of_stream ? LOGAN_PIC_TYPE_IDR : 0;
+	ni_frame->bit_depth = (uint16_t)ctx->bit_depth;
+	ni_frame->color_primaries = (uint8_t)ctx->enc.color_primaries;
+	ni_frame->color_trc = (uint8_t)ctx->enc.color_trc;
+	ni_frame->color_space = (uint8_t)ctx->enc.color_space;
+	ni_frame->video_full_range_flag = ctx->enc.color_range;
+	ni_frame->extra_data_len = job->end_of_stream ? 0 : job->hw_frame.extra_data_len;
 
-    struct netint_pkt *pkt = NULL;
+	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+		if (ctx->hw_plane_size[i] > 0) {
+			ni_frame->data_len[i] = (uint32_t)ctx->hw_plane_size[i];
+		} else {
+			ni_frame->data_len[i] = 0;
+		}
+	}
 
-    if (ctx->queue_mutex_initialized) {
-        pthread_mutex_lock(&ctx->queue_mutex);
-        if (ctx->pkt_pool_head) {
-            pkt = ctx->pkt_pool_head;
-            ctx->pkt_pool_head = pkt->next;
-            if (ctx->pkt_pool_size > 0) {
-                ctx->pkt_pool_size--;
-            }
+    /* Live bitrate change requested by netint_update: consumed here so it is
+     * applied exactly at a frame boundary, riding on this frame's aux data.
+     * EOS frames leave it pending. */
+    long new_bitrate = job->end_of_stream ? 0 : os_atomic_set_long(&ctx->pending_bitrate, 0);
+    /* Frames without a map skip aux prep entirely (the encoder keeps its
+     * cached map with roi_cache, and there's nothing to send otherwise) */
+    bool send_roi = ctx->roi_enabled && ctx->roi_supported && job->roi_data_size > 0;
+
+    if ((send_roi || new_bitrate > 0) && p_ni_logan_enc_prep_aux_data) {
+        ni_logan_frame_t aux_frame;
+        memset(&aux_frame, 0, sizeof(aux_frame));
+        ni_aux_data_t roi_aux;
+        ni_aux_data_t bitrate_aux;
+        int32_t bitrate_value = (int32_t)new_bitrate;
+        if (send_roi && job->roi_data && job->roi_data_size > 0) {
+            roi_aux.type = NI_FRAME_AUX_DATA_REGIONS_OF_INTEREST;
+            roi_aux.data = job->roi_data;
+            roi_aux.size = (int)job->roi_data_size;
+            aux_frame.aux_data[aux_frame.nb_aux_data++] = &roi_aux;
         }
-        pthread_mutex_unlock(&ctx->queue_mutex);
-    } else if (ctx->pkt_pool_head) {
-        pkt = ctx->pkt_pool_head;
-        ctx->pkt_pool_head = pkt->next;
-        if (ctx->pkt_pool_size > 0) {
-            ctx->pkt_pool_size--;
+        if (new_bitrate > 0) {
+            /* libxcoder turns this into an RC target-rate change param */
+            bitrate_aux.type = NI_FRAME_AUX_DATA_BITRATE;
+            bitrate_aux.data = (uint8_t *)&bitrate_value;
+            bitrate_aux.size = (int)sizeof(bitrate_value);
+            aux_frame.aux_data[aux_frame.nb_aux_data++] = &bitrate_aux;
         }
-    }
+        aux_frame.video_width = ctx->enc.width;
+        aux_frame.video_height = ctx->enc.height;
+        p_ni_logan_enc_prep_aux_data((ni_logan_session_context_t *)ctx->enc.p_session_ctx,
+                                     ni_frame,
+                                     &aux_frame,
+                                     ctx->enc.codec_format,
+                                     0, NULL, NULL, NULL, NULL, NULL);
 
-    if (!pkt) {
-        pkt = bzalloc(sizeof(*pkt));
-        if (!pkt) {
-            return NULL;
+        if (new_bitrate > 0) {
+            netint_log(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Bitrate changed %lld -> %ld kbps at frame %llu",
+                       (long long)(ctx->enc.bit_rate / 1000), new_bitrate / 1000,
+                       (unsigned long long)ctx->frame_count);
+            ctx->enc.bit_rate = new_bitrate;
         }
     }
 
-    if (required_size == 0) {
-        required_size = 1;
-    }
+	int send_ret = p_ni_logan_encode_send(&ctx->enc);
+	if (send_ret < 0) {
+		netint_log(LOG_ERROR, "[obs-netint-t4xx] ni_logan_encode_send failed (ret=%d)", send_ret);
+		netint_log_error(ctx, "ni_logan_encode_send", send_ret);
+		goto detach;
+	}
 
-    if (pkt->capacity < required_size) {
-        uint8_t *new_buffer = pkt->data ? (uint8_t *)brealloc(pkt->data, required_size)
-                                        : (uint8_t *)bmalloc(required_size);
-        if (!new_buffer) {
-            blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate %zu-byte packet buffer", required_size);
-            netint_free_packet(pkt);
-            return NULL;
-        }
+	if (!ctx->enc.started) {
+		ctx->enc.started = 1;
+		netint_log(LOG_INFO, "[obs-netint-t4xx] Encoder marked as started (ni_logan_encode_send success)");
+	}
 
-        pkt->data = new_buffer;
-        pkt->capacity = required_size;
-    }
+	if (!job->end_of_stream) {
+		netint_latency_mark_sent(ctx, job->pts);
+		ctx->frame_count++;
+		ctx->restart_stream = false;
+	}
 
-    pkt->size = 0;
-    pkt->next = NULL;
-    return pkt;
+	ctx->consecutive_errors = 0;
+	success = true;
+
+detach:
+	/* The buffer belongs to the job (or the frame cache), never to libxcoder */
+	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+		ni_frame->p_data[i] = NULL;
+		ni_frame->data_len[i] = 0;
+	}
+	ni_frame->p_buffer = NULL;
+	ni_frame->buffer_size = 0;
+	ni_frame->extra_data_len = 0;
+
+	if (job->shared) {
+		pthread_mutex_unlock(&job->shared->send_mutex);
+	}
+
+	if (!success) {
+		netint_roi_unsent(ctx, job);
+	}
+	return success;
 }
 
-static void netint_release_packet(struct netint_ctx *ctx, struct netint_pkt *pkt)
+/**
+ * @brief Check whether an Annex-B packet carries picture data (a VCL NAL unit)
+ *
+ * Packets without one (parameter sets, SEI) are not an access unit on their
+ * own and must not be delivered to OBS as a separate packet.
+ */
+static bool netint_packet_has_vcl(int codec_type, const uint8_t *data, size_t size)
 {
-    if (!ctx || !pkt)
-        return;
+    const uint8_t *end = data + size;
+    const uint8_t *nal = obs_avc_find_startcode(data, end);
+
+    while (nal < end) {
+        while (nal < end && *nal == 0) {
+            nal++;
+        }
+        if (nal >= end || ++nal >= end) {
+            break;
+        }
 
-    if (ctx->queue_mutex_initialized) {
-        pthread_mutex_lock(&ctx->queue_mutex);
-        netint_release_packet_locked(ctx, pkt);
-        pthread_mutex_unlock(&ctx->queue_mutex);
-    } else {
-        netint_free_packet(pkt);
+        if (codec_type == 1) {
+            int type = (nal[0] >> 1) & 0x3F;
+            if (type < 32) {
+                return true; /* HEVC VCL: 0..31 */
+            }
+        } else {
+            int type = nal[0] & 0x1F;
+            if (type >= 1 && type <= 5) {
+                return true; /* AVC VCL: non-IDR/partitions/IDR slices */
+            }
+        }
+
+        nal = obs_avc_find_startcode(nal, end);
     }
+    return false;
 }
 
-static void netint_release_packet_locked(struct netint_ctx *ctx, struct netint_pkt *pkt)
+/**
+ * @brief Keyframe flag and OBS priority of a received packet
+ *
+ * The firmware reports the picture type in the packet metadata, so the
+ * bitstream is not scanned. I pictures are the card's random access points;
+ * B pictures get LOW rather than DISPOSABLE since hierarchical GOPs use some
+ * of them as references. Only an unknown type falls back to parsing NALs.
+ */
+static void netint_classify_packet(struct netint_ctx *ctx, const ni_logan_packet_t *ni_pkt,
+                                   const struct netint_pkt *pkt, bool *keyframe, int *priority)
 {
-    if (!ctx || !pkt)
+    switch (ni_pkt->frame_type) {
+    case NI_LOGAN_FRAME_TYPE_I:
+        *keyframe = true;
+        *priority = OBS_NAL_PRIORITY_HIGHEST;
         return;
+    case NI_LOGAN_FRAME_TYPE_P:
+        *keyframe = false;
+        *priority = OBS_NAL_PRIORITY_HIGH;
+        return;
+    case NI_LOGAN_FRAME_TYPE_B:
+        *keyframe = false;
+        *priority = OBS_NAL_PRIORITY_LOW;
+        return;
+    default:
+        break;
+    }
 
-    pkt->size = 0;
-    pkt->pts = 0;
-    pkt->dts = 0;
-    pkt->keyframe = false;
-    pkt->priority = 0;
-    pkt->next = NULL;
-
-    if (ctx->pkt_pool_size < ctx->pkt_pool_capacity) {
-        pkt->next = ctx->pkt_pool_head;
-        ctx->pkt_pool_head = pkt;
-        ctx->pkt_pool_size++;
+    struct encoder_packet parsed = {
+        .data = netint_pkt_bytes(pkt),
+        .size = pkt->size,
+        .type = OBS_ENCODER_VIDEO,
+    };
+    if (ctx->codec_type == 1) {
+        *keyframe = obs_hevc_keyframe(parsed.data, parsed.size);
+        *priority = obs_parse_hevc_packet_priority(&parsed);
     } else {
-        netint_free_packet(pkt);
+        *keyframe = obs_avc_keyframe(parsed.data, parsed.size);
+        *priority = obs_parse_avc_packet_priority(&parsed);
     }
 }
 
-static void netint_destroy_job_pool(struct netint_ctx *ctx)
+static bool netint_hw_receive_once(struct netint_ctx *ctx)
 {
-    if (!ctx) {
-        return;
+    struct netint_pkt *pkt = NULL;
+    int64_t pkt_pts = 0;
+    int64_t pkt_dts = 0;
+    bool pkt_keyframe = false;
+    int pkt_priority = 0;
+    bool got_packet = false;
+
+    if (os_atomic_load_bool(&ctx->encoder_failed)) {
+        return false;
+    }
+    /* A parked packet goes into pkt_ring first; receiving now would need a
+     * second parking slot */
+    if (ctx->pkt_backlog) {
+        return false;
     }
 
-    struct netint_frame_job *head = NULL;
+    int recv_size = p_ni_logan_encode_receive(&ctx->enc);
 
-    if (ctx->job_pool_mutex_initialized) {
-        pthread_mutex_lock(&ctx->job_pool_mutex);
-        head = ctx->job_pool_head;
-        ctx->job_pool_head = NULL;
-        ctx->job_pool_size = 0;
-        pthread_mutex_unlock(&ctx->job_pool_mutex);
+    if (recv_size > 0) {
+        ni_logan_packet_t *ni_pkt = &ctx->enc.output_pkt.data.packet;
+        int header_size = 0;
+        if (ctx->enc.spsPpsAttach && ctx->enc.p_spsPpsHdr && ctx->enc.spsPpsHdrLen > 0) {
+            header_size = ctx->enc.spsPpsHdrLen;
+        }
 
-        pthread_mutex_destroy(&ctx->job_pool_mutex);
-        ctx->job_pool_mutex_initialized = false;
-    } else {
-        head = ctx->job_pool_head;
-        ctx->job_pool_head = NULL;
-        ctx->job_pool_size = 0;
-    }
+        /* A header-only packet received earlier is prepended to this one */
+        int prefix_size = ctx->pkt_prefix ? (int)ctx->pkt_prefix->size : 0;
+        int packet_size = recv_size + header_size + prefix_size;
 
-	while (head) {
-		struct netint_frame_job *next = head->next;
-        if (head->roi_data) {
-            bfree(head->roi_data);
-            head->roi_data = NULL;
-            head->roi_data_size = 0;
+        pkt = netint_receive_zero_copy(ctx, header_size);
+        if (!pkt) {
+            pkt = netint_acquire_packet(ctx, (size_t)packet_size);
+            if (!pkt) {
+                netint_log(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] Failed to acquire reusable packet buffer (%d bytes)",
+                           packet_size);
+                netint_log_error(ctx, "packet_buffer_alloc", -ENOMEM);
+            } else {
+                if (prefix_size > 0) {
+                    memcpy(pkt->data, netint_pkt_bytes(ctx->pkt_prefix), (size_t)prefix_size);
+                }
+                int first_packet_flag = ctx->enc.firstPktArrived ? 0 : 1;
+                int copy_ret = p_ni_logan_encode_copy_packet_data(&ctx->enc, pkt->data + prefix_size, first_packet_flag,
+                                                                  ctx->enc.spsPpsAttach);
+                if (copy_ret < 0) {
+                    netint_log(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] encode_copy_packet_data failed (ret=%d)", copy_ret);
+                    netint_log_error(ctx, "ni_logan_encode_copy_packet_data", copy_ret);
+                    netint_release_packet(ctx, pkt);
+                    pkt = NULL;
+                } else if (packet_size > pkt->capacity) {
+                    netint_log(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] Packet size (%d) exceeds buffer capacity (%zu)",
+                               packet_size, pkt->capacity);
+                    netint_release_packet(ctx, pkt);
+                    pkt = NULL;
+                } else {
+                    pkt->size = (size_t)packet_size;
+                }
+            }
         }
-		netint_job_release_hw_frame(head);
-		bfree(head);
-		head = next;
-	}
 
-    ctx->job_pool_capacity = 0;
-}
+        if (pkt) {
+            if (!ctx->got_headers && ctx->enc.p_spsPpsHdr && ctx->enc.spsPpsHdrLen > 0) {
+                netint_store_headers(ctx, ctx->enc.p_spsPpsHdr, (size_t)ctx->enc.spsPpsHdrLen);
+                netint_log(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Stored SPS/PPS extradata (%zu bytes)", ctx->extra_size);
+            }
 
-static bool netint_init_job_pool(struct netint_ctx *ctx)
-{
-    if (!ctx) {
-        return false;
-    }
+            pkt_pts = ni_pkt->pts;
+            pkt_dts = ni_pkt->dts;
+            if (pkt_pts == 0 && ctx->enc.latest_dts != 0) {
+                pkt_pts = ctx->enc.latest_dts;
+                pkt_dts = pkt_pts;
+            }
 
-    ctx->job_pool_capacity = ctx->max_inflight * 2;
-    if (ctx->job_pool_capacity < NETINT_JOB_POOL_MIN_CAPACITY) {
-        ctx->job_pool_capacity = NETINT_JOB_POOL_MIN_CAPACITY;
+            netint_classify_packet(ctx, ni_pkt, pkt, &pkt_keyframe, &pkt_priority);
+
+            ctx->enc.encoder_eof = ni_pkt->end_of_stream;
+            ctx->enc.firstPktArrived = 1;
+            got_packet = true;
+        }
+    } else if (recv_size < 0) {
+        if (ctx->enc.encoder_eof) {
+            return false;
+        }
     }
 
-    if (pthread_mutex_init(&ctx->job_pool_mutex, NULL) != 0) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to initialize job pool mutex");
-        ctx->job_pool_mutex_initialized = false;
+    if (!got_packet || !pkt) {
+        if (pkt) {
+            netint_release_packet(ctx, pkt);
+        }
         return false;
     }
 
-    ctx->job_pool_mutex_initialized = true;
-    ctx->job_pool_head = NULL;
-    ctx->job_pool_size = 0;
+    pkt->pts = pkt_pts;
+    pkt->dts = pkt_dts;
+    pkt->keyframe = pkt_keyframe;
+    pkt->priority = pkt_priority;
 
-    for (int i = 0; i < ctx->job_pool_capacity; i++) {
-        struct netint_frame_job *job = bzalloc(sizeof(*job));
-        if (!job) {
-            blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate frame job for pool");
-            netint_destroy_job_pool(ctx);
+    /* The prefix (if any) is now part of pkt */
+    if (ctx->pkt_prefix) {
+        netint_release_packet(ctx, ctx->pkt_prefix);
+        ctx->pkt_prefix = NULL;
+    }
+
+    /* No picture data: hold it back and deliver it with the next access unit,
+     * so every queued packet is exactly one frame. It does not complete an
+     * in-flight frame either. */
+    if (!ctx->enc.encoder_eof && !netint_packet_has_vcl(ctx->codec_type, netint_pkt_bytes(pkt), pkt->size)) {
+        ctx->pkt_prefix = pkt;
+        return true;
+    }
+
+    /* The ring is sized past the pipeline depth, so it only fills up if OBS
+     * stops calling encode; wait for room rather than drop a frame. A reactor
+     * round must not block: it parks the packet and retries next round. */
+    while (!netint_ring_push(&ctx->pkt_ring, pkt)) {
+        if (os_atomic_load_bool(&ctx->stop_thread)) {
+            netint_release_packet(ctx, pkt);
             return false;
         }
-
-        job->from_pool = true;
-		if (!netint_job_allocate_hw_frame(ctx, job)) {
-			bfree(job);
-			netint_destroy_job_pool(ctx);
-			return false;
+        if (ctx->io_attached) {
+            ctx->pkt_backlog = pkt;
+            return false;
         }
-
-        job->next = ctx->job_pool_head;
-        ctx->job_pool_head = job;
-        ctx->job_pool_size++;
+        netint_ring_wait(&ctx->pkt_ring, netint_pkt_ring_has_space, ctx, NETINT_IO_POLL_INTERVAL_MS);
     }
 
-    blog(LOG_INFO, "[obs-netint-t4xx] Initialized frame job pool (capacity=%d, frame_size=%zu)",
-         ctx->job_pool_capacity, ctx->hw_frame_size);
+    netint_pkt_queued(ctx, pkt_pts);
     return true;
 }
 
-static struct netint_frame_job *netint_acquire_job(struct netint_ctx *ctx, bool require_buffer)
+/**
+ * @brief Bookkeeping once a packet is in pkt_ring (IO thread)
+ *
+ * @param pts PTS of the packet; OBS may already own the packet itself
+ */
+static void netint_pkt_queued(struct netint_ctx *ctx, int64_t pts)
 {
-    struct netint_frame_job *job = NULL;
-
-    if (ctx->job_pool_mutex_initialized) {
-        pthread_mutex_lock(&ctx->job_pool_mutex);
-        if (ctx->job_pool_head) {
-            job = ctx->job_pool_head;
-            ctx->job_pool_head = job->next;
-            ctx->job_pool_size--;
-        }
-        pthread_mutex_unlock(&ctx->job_pool_mutex);
+    long queue_depth = netint_ring_count(&ctx->pkt_ring);
+    netint_hist_record(&ctx->telemetry.hist[NETINT_METRIC_PKT_QUEUE_DEPTH], (uint64_t)queue_depth);
+    if (queue_depth > ctx->reorder_depth + 1 && queue_depth > ctx->pkt_queue_high_water) {
+        ctx->pkt_queue_high_water = queue_depth;
+        netint_log(LOG_WARNING, "[obs-netint-t4xx] [IO THREAD] Packet queue depth %ld exceeds reorder depth %d",
+                   queue_depth, ctx->reorder_depth);
     }
 
-	if (job) {
-		job->next = NULL;
-		job->from_pool = true;
-        job->roi_data = NULL;
-        job->roi_data_size = 0;
+    netint_latency_mark_received(ctx, pts);
 
-		if (require_buffer && ctx->hw_frame_size > 0 &&
-		    job->hw_frame_capacity < ctx->hw_frame_size) {
-			netint_job_release_hw_frame(job);
-			if (!netint_job_allocate_hw_frame(ctx, job)) {
-				netint_release_job(ctx, job);
-				return NULL;
-			}
-		}
+    /* Only this thread modifies inflight_frames; the wake releases a
+     * producer blocked on a full pipeline */
+    if (os_atomic_load_long(&ctx->inflight_frames) > 0) {
+        os_atomic_dec_long(&ctx->inflight_frames);
+        netint_ring_wake(&ctx->job_ring);
+    }
 
-		return job;
-	}
+    ctx->consecutive_errors = 0;
 
-	job = bzalloc(sizeof(*job));
-	if (!job) {
-		blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate frame job (pool empty)");
-		return NULL;
-	}
+    uint64_t now_ns = os_gettime_ns();
+    ctx->last_packet_ns = now_ns;
+    if (ctx->encoder_state == NETINT_ENCODER_STATE_RECOVERING) {
+        ctx->encoder_state = NETINT_ENCODER_STATE_NORMAL;
+        ctx->recovered_ns = now_ns;
+        netint_log(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Watchdog: stream resumed %.1f ms after the stall was detected",
+                   (double)(now_ns - ctx->recovery_start_ns) / 1000000.0);
+    } else if (ctx->recovery_attempts > 0 && now_ns - ctx->recovered_ns > ENCODER_HANG_TIMEOUT_SEC * 1000000000ULL) {
+        ctx->recovery_attempts = 0;
+    }
+    netint_telemetry_tick(&ctx->telemetry, now_ns);
+}
 
-	job->from_pool = false;
-	if (!netint_job_allocate_hw_frame(ctx, job)) {
-		bfree(job);
-		return NULL;
-	}
+static void netint_hw_drain(struct netint_ctx *ctx, bool drain_all)
+{
+    int drained = 0;
+    while (netint_hw_receive_once(ctx)) {
+        drained++;
+        if (!drain_all && drained >= 1) {
+            break;
+        }
+    }
+}
 
-	return job;
+/**
+ * @brief Give up on the session: encode() reports the failure to OBS (IO or watchdog thread)
+ */
+static void netint_watchdog_fail(struct netint_ctx *ctx, const char *why)
+{
+    ctx->encoder_state = NETINT_ENCODER_STATE_FAILED;
+    /* Nothing more will come out; this also ends a flush */
+    ctx->enc.encoder_eof = 1;
+    os_atomic_set_bool(&ctx->encoder_failed, true);
+    blog(LOG_ERROR, "[obs-netint-t4xx] Watchdog: giving up (%s), the output has to be restarted", why);
 }
 
-static void netint_release_job(struct netint_ctx *ctx, struct netint_frame_job *job)
+/**
+ * @brief Move the session's device claim elsewhere for failover (watchdog thread)
+ *
+ * Stays put if the user picked the device or no other device is present.
+ * The IO work follows the device: the reactor client moves to the new
+ * device's queue, a dedicated IO thread rebinds to its NUMA node.
+ */
+static void netint_watchdog_switch_device(struct netint_ctx *ctx)
 {
-    if (!job) {
+    if (ctx->device_pinned || ctx->device_lease.slot < 0) {
         return;
     }
 
-    if (job->roi_data) {
-        bfree(job->roi_data);
-        job->roi_data = NULL;
-        job->roi_data_size = 0;
+    struct netint_device_request request = ctx->device_request;
+    struct netint_device_lease lease;
+    char placed_name[NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    request.avoid_slot = ctx->device_lease.slot;
+    if (!netint_device_acquire(&request, NULL, &lease, placed_name)) {
+        return;
     }
-
-    if (job->from_pool && ctx->job_pool_mutex_initialized) {
-        job->pts = 0;
-        job->start_of_stream = false;
-        job->end_of_stream = false;
-		job->hw_frame_capacity = ctx->hw_frame_size;
-        job->next = NULL;
-
-        pthread_mutex_lock(&ctx->job_pool_mutex);
-        if (ctx->job_pool_size < ctx->job_pool_capacity) {
-            job->next = ctx->job_pool_head;
-            ctx->job_pool_head = job;
-            ctx->job_pool_size++;
-            pthread_mutex_unlock(&ctx->job_pool_mutex);
-            return;
-        }
-        pthread_mutex_unlock(&ctx->job_pool_mutex);
-        /* Pool full - fall through to free */
+    if (lease.slot == ctx->device_lease.slot) {
+        netint_device_release(&lease);
+        return;
     }
 
-	netint_job_release_hw_frame(job);
-    bfree(job);
+    blog(LOG_WARNING, "[obs-netint-t4xx] Watchdog: moving session from '%s' to '%s'",
+         ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "", placed_name);
+    netint_device_release(&ctx->device_lease);
+    ctx->device_lease = lease;
+    bfree(ctx->enc.dev_enc_name);
+    bfree(ctx->enc.dev_xcoder);
+    ctx->enc.dev_enc_name = (char *)bstrdup(placed_name);
+    ctx->enc.dev_xcoder = (char *)bstrdup(placed_name);
+
+    ctx->numa_node = netint_numa_device_node(placed_name);
+    if (ctx->io_attached) {
+        netint_reactor_move(&ctx->io_client, ctx->device_lease.slot, ctx->numa_node);
+    }
 }
 
-static bool netint_enqueue_job(struct netint_ctx *ctx, struct netint_frame_job *job, bool count_frame)
+/**
+ * @brief Close the session and open a fresh one with the same settings (watchdog thread)
+ *
+ * OBS keeps the extradata it already has: the same settings give the same
+ * parameter sets, and the new session repeats them in its first packet.
+ * header_mutex is only taken for the moment headers are stored, so
+ * get_extra_data() never waits on the open.
+ *
+ * @return true if a session is open again
+ */
+static bool netint_watchdog_reopen(struct netint_ctx *ctx, bool other_device)
 {
-    if (!ctx->frame_queue_mutex_initialized) {
-        return false;
+    char *dev_enc_name = ctx->enc.dev_enc_name;
+    char *dev_xcoder = ctx->enc.dev_xcoder;
+    int64_t bit_rate = ctx->enc.bit_rate;
+
+    netint_zc_release_output(ctx);
+    if (ctx->enc.p_session_ctx && p_ni_logan_encode_close) {
+        p_ni_logan_encode_close(&ctx->enc);
     }
 
-    pthread_mutex_lock(&ctx->frame_queue_mutex);
+    /* libxcoder freed its own allocations; start over from the configured fields */
+    ctx->enc = ctx->enc_template;
+    ctx->enc.dev_enc_name = dev_enc_name;
+    ctx->enc.dev_xcoder = dev_xcoder;
+    ctx->enc.bit_rate = bit_rate;
 
-    while (!ctx->stop_thread && ctx->frame_queue_cond_initialized &&
-           ctx->max_pipeline_depth > 0 &&
-           (ctx->pending_jobs + ctx->inflight_frames) >= ctx->max_pipeline_depth) {
-        pthread_cond_wait(&ctx->frame_queue_cond, &ctx->frame_queue_mutex);
+    if (other_device) {
+        netint_watchdog_switch_device(ctx);
     }
 
-    if (ctx->stop_thread) {
-        pthread_mutex_unlock(&ctx->frame_queue_mutex);
-        return false;
+    /* Only this thread and a parked IO client store headers */
+    ctx->keep_stream_headers = ctx->got_headers;
+    bool opened = netint_open_session(ctx);
+    ctx->keep_stream_headers = false;
+
+    /* The next frame carries the ROI map again */
+    os_atomic_set_bool(&ctx->roi_resend, true);
+    return opened;
+}
+
+/**
+ * @brief Run the reopen attempts, then let the parked IO client go again
+ */
+static void *netint_watchdog_thread(void *data)
+{
+    struct netint_ctx *ctx = data;
+    os_set_thread_name("netint-watchdog");
+
+    bool opened = netint_watchdog_reopen(ctx, ctx->recovery_attempts > 1);
+    if (!opened && ctx->recovery_attempts == 1) {
+        opened = netint_watchdog_reopen(ctx, true);
+    }
+    if (opened) {
+        ctx->restart_stream = true;
+        ctx->consecutive_errors = 0;
+        ctx->last_packet_ns = os_gettime_ns();
+        blog(LOG_INFO, "[obs-netint-t4xx] Watchdog: session reopened on '%s' in %.1f ms",
+             ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "",
+             (double)(ctx->last_packet_ns - ctx->recovery_start_ns) / 1000000.0);
+    } else {
+        netint_watchdog_fail(ctx, "could not reopen the session");
     }
 
-    if (count_frame && ctx->frames_submitted == 0) {
-        job->start_of_stream = true;
+    os_atomic_set_bool(&ctx->reopening, false);
+    if (ctx->io_attached) {
+        netint_reactor_kick(&ctx->io_client);
     }
+    netint_ring_wake(&ctx->job_ring);
+    return NULL;
+}
 
-    if (count_frame) {
-        ctx->frames_submitted++;
+/**
+ * @brief Wait for a reopen that is still running (OBS thread, once IO has stopped)
+ */
+static void netint_watchdog_join(struct netint_ctx *ctx)
+{
+    if (ctx->recovery_thread_started) {
+        pthread_join(ctx->recovery_thread, NULL);
+        ctx->recovery_thread_started = false;
     }
+}
 
-    job->next = NULL;
+/**
+ * @brief Reopen a stalled or failing session in place (IO thread)
+ *
+ * Frames in the card are lost; frames still queued go to the new session,
+ * the first of them as an IDR. Closing and opening a session blocks for up
+ * to the libxcoder timeouts, so that runs on a thread of its own while the
+ * IO client is parked: a reactor worker keeps serving the other sessions
+ * and get_extra_data() is not held up.
+ */
+static void netint_watchdog_recover(struct netint_ctx *ctx, const char *reason)
+{
+    ctx->recovery_start_ns = os_gettime_ns();
+    ctx->encoder_state = NETINT_ENCODER_STATE_HUNG;
+    ctx->recovery_attempts++;
+    os_atomic_inc_long(&ctx->telemetry.recoveries);
+
+    long lost = os_atomic_set_long(&ctx->inflight_frames, 0);
+    blog(LOG_WARNING, "[obs-netint-t4xx] [IO THREAD] Watchdog: %s on '%s' (%ld frame(s) in the card), attempt %d/%d",
+         reason, ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "", lost, ctx->recovery_attempts,
+         MAX_RECOVERY_ATTEMPTS);
+
+    /* Nothing in the card will come back: free the latency slots and any
+     * held header-only packet, and release a producer waiting for room */
+    memset(ctx->send_time_ns, 0, sizeof(ctx->send_time_ns));
+    if (ctx->pkt_prefix) {
+        netint_release_packet(ctx, ctx->pkt_prefix);
+        ctx->pkt_prefix = NULL;
+    }
+    netint_ring_wake(&ctx->job_ring);
 
-    if (!ctx->frame_queue_head) {
-        ctx->frame_queue_head = job;
-        ctx->frame_queue_tail = job;
-    } else {
-        ctx->frame_queue_tail->next = job;
-        ctx->frame_queue_tail = job;
+    if (ctx->flushing) {
+        netint_watchdog_fail(ctx, "stalled while flushing");
+        return;
+    }
+    if (ctx->recovery_attempts > MAX_RECOVERY_ATTEMPTS) {
+        netint_watchdog_fail(ctx, "too many recovery attempts");
+        return;
     }
 
-    ctx->pending_jobs++;
-    if (ctx->frame_queue_cond_initialized) {
-        pthread_cond_signal(&ctx->frame_queue_cond);
+    ctx->encoder_state = NETINT_ENCODER_STATE_RECOVERING;
+    /* The previous reopen finished before the client was let go */
+    netint_watchdog_join(ctx);
+    os_atomic_set_bool(&ctx->reopening, true);
+    if (pthread_create(&ctx->recovery_thread, NULL, netint_watchdog_thread, ctx) != 0) {
+        os_atomic_set_bool(&ctx->reopening, false);
+        netint_watchdog_fail(ctx, "could not start the reopen");
+        return;
     }
-    pthread_mutex_unlock(&ctx->frame_queue_mutex);
-    return true;
+    ctx->recovery_thread_started = true;
 }
 
-static struct netint_frame_job *netint_dequeue_job(struct netint_ctx *ctx, bool wait_for_job)
+/**
+ * @brief Look for a stalled session after each IO round (IO thread)
+ *
+ * A stall is a frame the card owes us that was sent longer than the
+ * threshold ago, with no packet since then either. The GOP may hold back
+ * reorder_depth frames until more input arrives (e.g. while the output is
+ * paused), so only frames beyond that count, except while flushing. Nothing
+ * is checked while OBS isn't taking packets.
+ */
+static void netint_watchdog_check(struct netint_ctx *ctx)
 {
-    struct netint_frame_job *job = NULL;
+    if (!ctx->watchdog_ns || os_atomic_load_bool(&ctx->encoder_failed) || ctx->enc.encoder_eof ||
+        ctx->pkt_backlog) {
+        return;
+    }
 
-    pthread_mutex_lock(&ctx->frame_queue_mutex);
-    while (wait_for_job && !ctx->stop_thread && !ctx->frame_queue_head) {
-        if (!ctx->frame_queue_cond_initialized) {
-            break;
+    if (ctx->consecutive_errors >= MAX_CONSECUTIVE_ERRORS) {
+        netint_watchdog_recover(ctx, "repeated errors");
+        return;
+    }
+
+    long inflight = os_atomic_load_long(&ctx->inflight_frames);
+    if (inflight <= (ctx->flushing ? 0 : ctx->reorder_depth)) {
+        return;
+    }
+
+    uint64_t oldest_ns = 0;
+    for (int i = 0; i < NETINT_LATENCY_SLOTS; i++) {
+        if (ctx->send_time_ns[i] && (!oldest_ns || ctx->send_time_ns[i] < oldest_ns)) {
+            oldest_ns = ctx->send_time_ns[i];
         }
-        pthread_cond_wait(&ctx->frame_queue_cond, &ctx->frame_queue_mutex);
+    }
+    if (!oldest_ns) {
+        return;
     }
 
-    if (ctx->frame_queue_head) {
-        job = ctx->frame_queue_head;
-        ctx->frame_queue_head = job->next;
-        if (!ctx->frame_queue_head) {
-            ctx->frame_queue_tail = NULL;
-        }
-        job->next = NULL;
-        ctx->pending_jobs--;
-        if (ctx->frame_queue_cond_initialized) {
-            pthread_cond_broadcast(&ctx->frame_queue_cond);
-        }
+    uint64_t since_ns = oldest_ns > ctx->last_packet_ns ? oldest_ns : ctx->last_packet_ns;
+    uint64_t limit_ns = ctx->enc.firstPktArrived ? ctx->watchdog_ns : ENCODER_HANG_TIMEOUT_SEC * 1000000000ULL;
+    uint64_t now_ns = os_gettime_ns();
+    if (now_ns <= since_ns || now_ns - since_ns < limit_ns) {
+        return;
     }
-    pthread_mutex_unlock(&ctx->frame_queue_mutex);
 
-    return job;
+    char reason[64];
+    snprintf(reason, sizeof(reason), "no packet for %llu ms", (unsigned long long)((now_ns - since_ns) / 1000000ULL));
+    netint_watchdog_recover(ctx, reason);
 }
 
-static bool netint_queue_frame(struct netint_ctx *ctx, struct encoder_frame *frame)
+static void *netint_io_thread(void *data)
 {
-    struct netint_frame_job *job = netint_acquire_job(ctx, true);
-    if (!job) {
-        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to acquire frame job");
-        return false;
-    }
-
-	if (ctx->hw_frame_size > 0 &&
-	    (!job->hw_frame.p_buffer || job->hw_frame_capacity < ctx->hw_frame_size)) {
-		netint_job_release_hw_frame(job);
-		if (!netint_job_allocate_hw_frame(ctx, job)) {
-			blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate hardware buffer for frame job");
-			netint_release_job(ctx, job);
-			return false;
-		}
-	}
-
-    job->pts = frame->pts;
-    job->end_of_stream = false;
-    job->start_of_stream = false;
+    struct netint_ctx *ctx = data;
+    blog(LOG_INFO, "[obs-netint-t4xx] IO thread started (event-driven send/receive)");
 
-    if (ctx->hw_frame_size > 0) {
-		if (!job->hw_frame.p_data[0]) {
-			blog(LOG_ERROR, "[obs-netint-t4xx] Frame job missing hardware buffer (%zu bytes expected)",
-			     ctx->hw_frame_size);
-            netint_release_job(ctx, job);
-            return false;
+    int bound_node = -1;
+    while (true) {
+        /* The watchdog owns the session until its reopen is done */
+        if (os_atomic_load_bool(&ctx->reopening)) {
+            os_sleep_ms(NETINT_IO_POLL_INTERVAL_MS);
+            continue;
         }
-        uint8_t *dest_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {0};
-        for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-            if (ctx->hw_plane_size[i] > 0) {
-				dest_planes[i] = (uint8_t *)job->hw_frame.p_data[i];
+
+        /* Follow the device across a watchdog failover */
+        if (ctx->numa_node != bound_node) {
+            bound_node = ctx->numa_node;
+            if (netint_numa_bind_thread(bound_node)) {
+                blog(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Pinned to NUMA node %d", bound_node);
             }
         }
 
-        uint8_t *src_planes[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
-            frame->data[0],
-            frame->data[1],
-            frame->data[2],
-            NULL};
-
-        int src_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
-            frame->linesize[0],
-            frame->linesize[1],
-            frame->linesize[2],
-            0};
+        long inflight = os_atomic_load_long(&ctx->inflight_frames);
 
-        int src_height[NI_LOGAN_MAX_NUM_DATA_POINTERS] = {
-            ctx->enc.height,
-            ctx->enc.height / 2,
-            ctx->enc.height / 2,
-            0};
+        /* Nothing in the card: sleep until OBS hands us a frame. Otherwise
+         * wake up every poll interval so finished packets are collected as
+         * soon as the card has them, not when the next frame arrives. */
+        long timeout_ms = (inflight > 0 || (ctx->flushing && !ctx->enc.encoder_eof))
+                              ? NETINT_IO_POLL_INTERVAL_MS
+                              : NETINT_WAIT_INFINITE;
+        struct netint_frame_job *job = netint_dequeue_job(ctx, timeout_ms);
 
-        bool can_bulk_copy = true;
-        for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-            if (ctx->hw_plane_size[i] == 0)
-                continue;
-            if (!src_planes[i] || !dest_planes[i]) {
-                can_bulk_copy = false;
-                break;
-            }
-            if (src_stride[i] != ctx->hw_stride[i]) {
-                can_bulk_copy = false;
-                break;
-            }
+        if (!job && os_atomic_load_bool(&ctx->stop_thread)) {
+            break;
         }
 
-        if (ctx->codec_type == 0) {
-            if (ctx->frames_submitted == 0) {
-                for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-                    if (ctx->hw_plane_size[i] == 0)
-                        continue;
-                    blog(LOG_INFO,
-                         "[obs-netint-t4xx] [H264] Plane %d: src=%p dst=%p size=%zu src_stride=%d hw_stride=%d hw_height=%d job_capacity=%zu",
-                         i, (void *)src_planes[i], (void *)dest_planes[i],
-                         ctx->hw_plane_size[i], src_stride[i], ctx->hw_stride[i],
-					     ctx->hw_height[i], job->hw_frame_capacity);
-                }
+        if (job && netint_drop_pending_job(ctx, job)) {
+            netint_release_job(ctx, job);
+        } else if (job) {
+            if (netint_hw_send_job(ctx, job) && !job->end_of_stream) {
+                os_atomic_inc_long(&ctx->inflight_frames);
             }
-            can_bulk_copy = false;
+            netint_release_job(ctx, job);
         }
 
-        if (can_bulk_copy) {
-            for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-                if (ctx->hw_plane_size[i] == 0)
-                    continue;
-                memcpy(dest_planes[i], src_planes[i], ctx->hw_plane_size[i]);
-            }
-        } else {
-            p_ni_logan_copy_hw_yuv420p(dest_planes,
-                                       src_planes,
-                                       ctx->enc.width,
-                                       ctx->enc.height,
-                                       1,
-                                       ctx->hw_stride,
-                                       ctx->hw_height,
-                                       src_stride,
-                                       src_height);
-        }
+        /* Collect every packet that is ready, not just one per frame sent */
+        netint_hw_drain(ctx, true);
+        netint_watchdog_check(ctx);
     }
 
-	job->hw_frame.pts = job->pts;
-	job->hw_frame.dts = job->pts;
-	job->hw_frame.start_of_stream = job->start_of_stream ? 1 : 0;
-	job->hw_frame.end_of_stream = 0;
-	job->hw_frame.force_key_frame = job->start_of_stream ? 1 : 0;
-	job->hw_frame.ni_logan_pict_type = job->start_of_stream ? LOGAN_PIC_TYPE_IDR : 0;
+    /* Final drain to ensure packets (including EOS) are delivered */
+    netint_hw_drain(ctx, true);
 
-    if (job->roi_data) {
-        bfree(job->roi_data);
-        job->roi_data = NULL;
-        job->roi_data_size = 0;
+    blog(LOG_INFO, "[obs-netint-t4xx] IO thread exiting");
+    return NULL;
+}
+
+/**
+ * @brief One non-blocking IO round on a shared reactor worker
+ *
+ * Does what one pass of netint_io_thread() does, but never waits: queued
+ * jobs are sent in a bounded batch, ready packets are collected, and the
+ * return value tells the reactor when to come back.
+ */
+static enum netint_reactor_next netint_io_service(void *data)
+{
+    struct netint_ctx *ctx = data;
+
+    /* Parked: the watchdog kicks the client once its reopen is done */
+    if (os_atomic_load_bool(&ctx->reopening)) {
+        return NETINT_REACTOR_IDLE;
     }
 
-    if (ctx->roi_enabled && ctx->roi_supported && p_ni_logan_enc_prep_aux_data && obs_encoder_has_roi(ctx->encoder)) {
-        size_t roi_count = 0;
-        obs_encoder_enum_roi(ctx->encoder, netint_roi_count_cb, &roi_count);
-        if (roi_count > 0) {
-            size_t roi_bytes = roi_count * sizeof(struct netint_roi_entry);
-            struct netint_roi_entry *entries = bzalloc(roi_bytes);
-            if (!entries) {
-                blog(LOG_WARNING, "[obs-netint-t4xx] Failed to allocate ROI side data (%zu bytes)", roi_bytes);
-            } else {
-                struct netint_roi_fill_ctx fill_ctx = {
-                    .entries = entries,
-                    .index = 0,
-                    .width = (uint32_t)ctx->enc.width,
-                    .height = (uint32_t)ctx->enc.height,
-                };
-                obs_encoder_enum_roi(ctx->encoder, netint_roi_fill_cb, &fill_ctx);
-                job->roi_data = (uint8_t *)entries;
-                job->roi_data_size = roi_bytes;
-            }
+    /* OBS has made room since the last round? */
+    if (ctx->pkt_backlog) {
+        if (!netint_ring_push(&ctx->pkt_ring, ctx->pkt_backlog)) {
+            return NETINT_REACTOR_POLL;
         }
+        int64_t pts = ctx->pkt_backlog->pts;
+        ctx->pkt_backlog = NULL;
+        netint_pkt_queued(ctx, pts);
     }
 
-    if (!netint_enqueue_job(ctx, job, true)) {
-        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to enqueue frame job (encoder shutting down?)");
+    /* Bounded, so one session can't hold a worker for a whole backlog */
+    long batch = ctx->max_inflight > 0 ? ctx->max_inflight : 1;
+    struct netint_frame_job *job = NULL;
+    while (batch-- > 0 && (job = netint_dequeue_job(ctx, 0)) != NULL) {
+        if (netint_drop_pending_job(ctx, job)) {
+            netint_release_job(ctx, job);
+            continue;
+        }
+        if (netint_hw_send_job(ctx, job) && !job->end_of_stream) {
+            os_atomic_inc_long(&ctx->inflight_frames);
+        }
         netint_release_job(ctx, job);
-        return false;
-    }
-    return true;
-}
-
-static bool netint_queue_eos(struct netint_ctx *ctx)
-{
-    struct netint_frame_job *job = netint_acquire_job(ctx, false);
-    if (!job) {
-        job = bzalloc(sizeof(*job));
-        if (!job) {
-            blog(LOG_ERROR, "[obs-netint-t4xx] Failed to allocate EOS job");
-            return false;
+        netint_hw_drain(ctx, true);
+        /* pkt_ring is full: nothing more can be received until OBS catches up */
+        if (ctx->pkt_backlog) {
+            break;
         }
     }
+    netint_hw_drain(ctx, true);
+    netint_watchdog_check(ctx);
 
-    job->pts = 0;
-    job->end_of_stream = true;
-    job->start_of_stream = false;
-	job->hw_frame.pts = 0;
-	job->hw_frame.dts = 0;
-	job->hw_frame.start_of_stream = 0;
-	job->hw_frame.end_of_stream = 1;
-	job->hw_frame.force_key_frame = 0;
-	job->hw_frame.ni_logan_pict_type = 0;
-
-    if (!netint_enqueue_job(ctx, job, false)) {
-        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to enqueue EOS job (encoder shutting down)");
-        netint_release_job(ctx, job);
-        return false;
+    if (ctx->pkt_backlog) {
+        return NETINT_REACTOR_POLL;
     }
-    return true;
+    if (netint_ring_count(&ctx->job_ring) > 0) {
+        return NETINT_REACTOR_AGAIN;
+    }
+    if (os_atomic_load_long(&ctx->inflight_frames) > 0 || (ctx->flushing && !ctx->enc.encoder_eof)) {
+        return NETINT_REACTOR_POLL;
+    }
+    return NETINT_REACTOR_IDLE;
 }
 
-static bool netint_hw_send_job(struct netint_ctx *ctx, struct netint_frame_job *job)
+/**
+ * @brief Hand the next packet produced by the IO thread to OBS, if any
+ *
+ * The previously delivered packet is recycled first (OBS copies packet data
+ * before calling back into the encoder).
+ *
+ * @return true if a packet was written to @p packet
+ */
+static bool netint_deliver_packet(struct netint_ctx *ctx, struct encoder_packet *packet)
 {
-	bool success = false;
+    if (ctx->last_delivered_pkt) {
+        netint_return_packet(ctx, ctx->last_delivered_pkt);
+        ctx->last_delivered_pkt = NULL;
+    }
 
-	int get_ret = p_ni_logan_encode_get_frame(&ctx->enc);
-	if (get_ret < 0) {
-		blog(LOG_ERROR, "[obs-netint-t4xx] ni_logan_encode_get_frame failed (ret=%d)", get_ret);
-		netint_log_error(ctx, "ni_logan_encode_get_frame", get_ret);
-		return false;
-	}
+    /* Check for packets produced by IO thread */
+    struct netint_pkt *pkt = ctx->rings_initialized ? netint_ring_pop(&ctx->pkt_ring) : NULL;
 
-	ni_logan_session_data_io_t *input_fme = ctx->enc.p_input_fme;
-	if (!input_fme) {
-		blog(LOG_ERROR, "[obs-netint-t4xx] p_input_fme is NULL after encode_get_frame");
-		return false;
-	}
+    bool delivered_packet = false;
+    if (pkt) {
+        packet->data = netint_pkt_bytes(pkt);
+        packet->size = pkt->size;
+        packet->pts = pkt->pts;
+        packet->dts = pkt->dts;
+        packet->keyframe = pkt->keyframe;
+        packet->priority = pkt->priority;
+        packet->type = OBS_ENCODER_VIDEO;
 
-	ni_logan_frame_t *ni_frame = &input_fme->data.frame;
+        /* Set from the video output at create; it can't change for the encoder's lifetime */
+        packet->timebase_num = ctx->enc.timebase_num;
+        packet->timebase_den = ctx->enc.timebase_den;
 
-	bool eos_frame_allocated = false;
-	ni_logan_frame_t eos_frame;
+        os_atomic_inc_long(&ctx->telemetry.packets_out);
+        ctx->telemetry.bytes_out += pkt->size;
 
-	if (!job->end_of_stream && ctx->hw_frame_size > 0) {
-		if (!job->hw_frame.p_buffer) {
-			blog(LOG_ERROR, "[obs-netint-t4xx] Job missing pre-allocated hardware buffer");
-			return false;
-		}
+        ctx->last_delivered_pkt = pkt;
+        pkt = NULL;
+        delivered_packet = true;
+    } else {
+        packet->data = NULL;
+        packet->size = 0;
+        packet->pts = 0;
+        packet->dts = 0;
+        packet->keyframe = false;
+        packet->priority = 0;
+    }
 
-		*ni_frame = job->hw_frame;
-	} else if (job->end_of_stream) {
-		memset(&eos_frame, 0, sizeof(eos_frame));
-		eos_frame.extra_data_len = 64;
-
-		int alloc_ret = p_ni_logan_encoder_frame_buffer_alloc(
-			&eos_frame, ctx->enc.width, ctx->enc.height, ctx->hw_stride,
-			(ctx->codec_type == 0) ? 1 : 0, eos_frame.extra_data_len, 1);
-		if (alloc_ret != NI_LOGAN_RETCODE_SUCCESS) {
-			blog(LOG_WARNING,
-			     "[obs-netint-t4xx] Failed to allocate temporary EOS frame buffer (ret=%d)",
-			     alloc_ret);
-			memset(ni_frame, 0, sizeof(*ni_frame));
-		} else {
-			*ni_frame = eos_frame;
-			eos_frame_allocated = true;
-		}
-	} else {
-		memset(ni_frame, 0, sizeof(*ni_frame));
-	}
+    return delivered_packet;
+}
 
-	ni_frame->video_width = ctx->enc.width;
-	ni_frame->video_height = ctx->enc.height;
-	ni_frame->video_orig_width = ctx->enc.width;
-	ni_frame->video_orig_height = ctx->enc.height;
-	ni_frame->pts = job->end_of_stream ? 0 : job->pts;
-	ni_frame->dts = ni_frame->pts;
-	ni_frame->start_of_stream = job->start_of_stream ? 1 : 0;
-	ni_frame->end_of_stream = job->end_of_stream ? 1 : 0;
-	ni_frame->force_key_frame = job->start_of_stream ? 1 : 0;
-	ni_frame->ni_logan_pict_type = job->start_of_stream ? LOGAN_PIC_TYPE_IDR : 0;
-	ni_frame->bit_depth = 8;
-	ni_frame->color_primaries = (uint8_t)ctx->enc.color_primaries;
-	ni_frame->color_trc = (uint8_t)ctx->enc.color_trc;
-	ni_frame->color_space = (uint8_t)ctx->enc.color_space;
-	ni_frame->video_full_range_flag = ctx->enc.color_range;
-	ni_frame->extra_data_len = job->end_of_stream ? 0 : job->hw_frame.extra_data_len;
+/* ------------------------------------------------------------------------- */
+/* ABR ladder                                                                */
 
-	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-		if (ctx->hw_plane_size[i] > 0) {
-			ni_frame->data_len[i] = (uint32_t)ctx->hw_plane_size[i];
-		} else {
-			ni_frame->data_len[i] = 0;
-		}
-	}
+static pthread_mutex_t s_ladder_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct netint_ladder *s_ladders;
 
-    if (ctx->roi_enabled && ctx->roi_supported && p_ni_logan_enc_prep_aux_data) {
-        ni_logan_frame_t roi_frame;
-        memset(&roi_frame, 0, sizeof(roi_frame));
-        ni_aux_data_t roi_aux;
-        if (job->roi_data && job->roi_data_size > 0) {
-            roi_aux.type = NI_FRAME_AUX_DATA_REGIONS_OF_INTEREST;
-            roi_aux.data = job->roi_data;
-            roi_aux.size = (int)job->roi_data_size;
-            roi_frame.nb_aux_data = 1;
-            roi_frame.aux_data[0] = &roi_aux;
+/**
+ * @brief Scale worker of one rung: waits for a frame, scales it, reports back
+ */
+static void *netint_ladder_worker(void *data)
+{
+    struct netint_ladder_rung *rung = data;
+    struct netint_ctx *ctx = rung->ctx;
+    os_set_thread_name("netint-ladder-scale");
+
+    while (os_sem_wait(rung->start) == 0 && !os_atomic_load_bool(&rung->stop)) {
+        const ni_logan_frame_t *src = rung->src;
+        uint8_t *dst_planes[3];
+        const uint8_t *src_planes[3];
+        for (int i = 0; i < 3; i++) {
+            dst_planes[i] = (uint8_t *)rung->job->hw_frame.p_data[i];
+            src_planes[i] = (const uint8_t *)src->p_data[i];
         }
-        roi_frame.video_width = ctx->enc.width;
-        roi_frame.video_height = ctx->enc.height;
-        p_ni_logan_enc_prep_aux_data((ni_logan_session_context_t *)ctx->enc.p_session_ctx,
-                                     ni_frame,
-                                     &roi_frame,
-                                     ctx->enc.codec_format,
-                                     0, NULL, NULL, NULL, NULL, NULL);
+        netint_scaler_run(&rung->scaler, dst_planes, ctx->hw_stride, ctx->hw_height, src_planes,
+                          rung->src_stride);
+        os_sem_post(rung->done);
     }
+    return NULL;
+}
 
-	int send_ret = p_ni_logan_encode_send(&ctx->enc);
-	if (send_ret < 0) {
-		blog(LOG_ERROR, "[obs-netint-t4xx] ni_logan_encode_send failed (ret=%d)", send_ret);
-		netint_log_error(ctx, "ni_logan_encode_send", send_ret);
-		return false;
-	}
+/**
+ * @brief Parse "WxH:kbps,WxH:kbps" into renditions no larger than the source
+ *
+ * @return Number of renditions, 0 if none is usable
+ */
+static int netint_ladder_parse(const char *spec, int src_width, int src_height,
+                               struct netint_rendition out[NETINT_LADDER_MAX_RENDITIONS])
+{
+    int count = 0;
+
+    for (const char *p = spec; p && *p && count < NETINT_LADDER_MAX_RENDITIONS;) {
+        int width = 0;
+        int height = 0;
+        int kbps = 0;
+        if (sscanf(p, " %dx%d:%d", &width, &height, &kbps) != 3) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Ladder: cannot parse rendition '%s'", p);
+        } else if (width < 64 || height < 64 || width > src_width || height > src_height || kbps <= 0) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Ladder: skipping rendition %dx%d @ %d kbps (source %dx%d)",
+                 width, height, kbps, src_width, src_height);
+        } else {
+            /* 4:2:0 needs even sizes */
+            out[count].width = width & ~1;
+            out[count].height = height & ~1;
+            out[count].bit_rate = (int64_t)kbps * 1000;
+            count++;
+        }
 
-	if (!ctx->enc.started) {
-		ctx->enc.started = 1;
-		blog(LOG_INFO, "[obs-netint-t4xx] Encoder marked as started (ni_logan_encode_send success)");
-	}
+        p = strchr(p, ',');
+        if (p) {
+            p++;
+        }
+    }
+    return count;
+}
 
-	if (!job->end_of_stream) {
-		ctx->frame_count++;
-	}
+/**
+ * @brief Open a session and a scale worker per rendition in "ladder_renditions"
+ */
+static bool netint_ladder_open(struct netint_ctx *ctx, obs_data_t *settings)
+{
+    struct netint_rendition renditions[NETINT_LADDER_MAX_RENDITIONS];
+    int count = netint_ladder_parse(obs_data_get_string(settings, "ladder_renditions"), ctx->enc.width,
+                                    ctx->enc.height, renditions);
+    if (count == 0) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Ladder: no extra renditions configured, encoding %dx%d only",
+             ctx->enc.width, ctx->enc.height);
+        return true;
+    }
 
-	ctx->consecutive_errors = 0;
-	success = true;
+    struct netint_ladder *ladder = bzalloc(sizeof(*ladder));
+    ladder->main = ctx;
+    ctx->ladder = ladder;
 
-	for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
-		ni_frame->p_data[i] = NULL;
-		ni_frame->data_len[i] = 0;
-	}
-	ni_frame->p_buffer = NULL;
-	ni_frame->buffer_size = 0;
-	ni_frame->extra_data_len = 0;
+    for (int i = 0; i < count; i++) {
+        struct netint_ladder_rung *rung = &ladder->rungs[i];
 
-	if (eos_frame_allocated && p_ni_logan_frame_buffer_free) {
-		p_ni_logan_frame_buffer_free(&eos_frame);
-	}
+        blog(LOG_INFO, "[obs-netint-t4xx] Ladder: opening rendition %d: %dx%d @ %lld kbps", i + 1,
+             renditions[i].width, renditions[i].height, (long long)(renditions[i].bit_rate / 1000));
+        rung->ctx = netint_create_internal(settings, ctx->encoder, false, &renditions[i]);
+        if (!rung->ctx) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Ladder: failed to open rendition %dx%d", renditions[i].width,
+                 renditions[i].height);
+            goto fail;
+        }
+        ladder->count++;
+        memcpy(rung->src_stride, ctx->hw_stride, sizeof(rung->src_stride));
 
-	return success;
-}
+        if (!netint_scaler_init(&rung->scaler, ctx->enc.width, ctx->enc.height, renditions[i].width,
+                                renditions[i].height, ctx->bit_depth_factor)) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Ladder: failed to build the %dx%d scaler", renditions[i].width,
+                 renditions[i].height);
+            goto fail;
+        }
+        if (os_sem_init(&rung->start, 0) != 0 || os_sem_init(&rung->done, 0) != 0) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Ladder: failed to create worker semaphores");
+            goto fail;
+        }
+        if (pthread_create(&rung->thread, NULL, netint_ladder_worker, rung) != 0) {
+            blog(LOG_ERROR, "[obs-netint-t4xx] Ladder: failed to start scale worker");
+            goto fail;
+        }
+        rung->thread_created = true;
+    }
 
-static bool netint_hw_receive_once(struct netint_ctx *ctx)
-{
-    struct netint_pkt *pkt = NULL;
-    int64_t pkt_pts = 0;
-    int64_t pkt_dts = 0;
-    bool pkt_keyframe = false;
-    bool got_packet = false;
+    pthread_mutex_lock(&s_ladder_mutex);
+    ladder->next = s_ladders;
+    s_ladders = ladder;
+    pthread_mutex_unlock(&s_ladder_mutex);
+    return true;
 
-    int recv_size = p_ni_logan_encode_receive(&ctx->enc);
+fail:
+    netint_ladder_destroy(ladder);
+    ctx->ladder = NULL;
+    return false;
+}
 
-    if (recv_size > 0) {
-        ni_logan_packet_t *ni_pkt = &ctx->enc.output_pkt.data.packet;
-        int packet_size = recv_size;
-        if (ctx->enc.spsPpsAttach && ctx->enc.p_spsPpsHdr && ctx->enc.spsPpsHdrLen > 0) {
-            packet_size += ctx->enc.spsPpsHdrLen;
+static void netint_ladder_destroy(struct netint_ladder *ladder)
+{
+    pthread_mutex_lock(&s_ladder_mutex);
+    for (struct netint_ladder **link = &s_ladders; *link; link = &(*link)->next) {
+        if (*link == ladder) {
+            *link = ladder->next;
+            break;
         }
-
-        pkt = netint_acquire_packet(ctx, (size_t)packet_size);
-        if (!pkt) {
-            blog(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] Failed to acquire reusable packet buffer (%d bytes)",
-                 packet_size);
-            netint_log_error(ctx, "packet_buffer_alloc", -ENOMEM);
-        } else {
-            int first_packet_flag = ctx->enc.firstPktArrived ? 0 : 1;
-            int copy_ret = p_ni_logan_encode_copy_packet_data(&ctx->enc, pkt->data, first_packet_flag,
-                                                              ctx->enc.spsPpsAttach);
-            if (copy_ret < 0) {
-                blog(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] encode_copy_packet_data failed (ret=%d)", copy_ret);
-                netint_log_error(ctx, "ni_logan_encode_copy_packet_data", copy_ret);
-                netint_release_packet(ctx, pkt);
-                pkt = NULL;
-            } else {
-                if (packet_size > pkt->capacity) {
-                    blog(LOG_ERROR, "[obs-netint-t4xx] [IO THREAD] Packet size (%d) exceeds buffer capacity (%zu)",
-                         packet_size, pkt->capacity);
-                    netint_release_packet(ctx, pkt);
-                    pkt = NULL;
-                } else {
-                    pkt->size = (size_t)packet_size;
-
-                    if (!ctx->got_headers && ctx->enc.p_spsPpsHdr && ctx->enc.spsPpsHdrLen > 0) {
-                        if (ctx->extra) bfree(ctx->extra);
-                        ctx->extra = bmemdup(ctx->enc.p_spsPpsHdr, (size_t)ctx->enc.spsPpsHdrLen);
-                        ctx->extra_size = (size_t)ctx->enc.spsPpsHdrLen;
-                        ctx->got_headers = true;
-                        blog(LOG_INFO, "[obs-netint-t4xx] [IO THREAD] Stored SPS/PPS extradata (%zu bytes)", ctx->extra_size);
-                    }
-
-                    pkt_pts = ni_pkt->pts;
-                    pkt_dts = ni_pkt->dts;
-                    if (pkt_pts == 0 && ctx->enc.latest_dts != 0) {
-                        pkt_pts = ctx->enc.latest_dts;
-                        pkt_dts = pkt_pts;
-                    }
-
-                    if (ctx->codec_type == 1) {
-                        pkt_keyframe = obs_hevc_keyframe(pkt->data, pkt->size);
-                    } else {
-                        pkt_keyframe = obs_avc_keyframe(pkt->data, pkt->size);
-                    }
-
-                    ctx->enc.encoder_eof = ni_pkt->end_of_stream;
-                    ctx->enc.firstPktArrived = 1;
-                    got_packet = true;
-                }
-            }
+    }
+    pthread_mutex_unlock(&s_ladder_mutex);
+
+    for (int i = 0; i < NETINT_LADDER_MAX_RENDITIONS; i++) {
+        struct netint_ladder_rung *rung = &ladder->rungs[i];
+        if (rung->thread_created) {
+            os_atomic_set_bool(&rung->stop, true);
+            os_sem_post(rung->start);
+            pthread_join(rung->thread, NULL);
         }
-    } else if (recv_size < 0) {
-        if (ctx->enc.encoder_eof) {
-            return false;
+        os_sem_destroy(rung->start);
+        os_sem_destroy(rung->done);
+        netint_scaler_free(&rung->scaler);
+        if (rung->ctx) {
+            netint_destroy(rung->ctx);
         }
     }
+    bfree(ladder);
+}
 
-    if (!got_packet || !pkt) {
-        if (pkt) {
-            netint_release_packet(ctx, pkt);
-        }
-        return false;
+/**
+ * @brief Upload a frame for the ladder's own session and scale it into every rung
+ *
+ * The rungs are scaled in parallel from the uploaded hardware buffer and all
+ * jobs are submitted once every worker is done with it. A rung that cannot
+ * take the frame skips it; the others carry on.
+ */
+static bool netint_ladder_queue_frame(struct netint_ctx *ctx, struct encoder_frame *frame)
+{
+    struct netint_ladder *ladder = ctx->ladder;
+    if (!netint_pipeline_admit(ctx)) {
+        return true;
     }
 
-    pkt->pts = pkt_pts;
-    pkt->dts = pkt_dts;
-    pkt->keyframe = pkt_keyframe;
-    pkt->priority = 0;
+    struct netint_frame_job *job = netint_prepare_frame_job(ctx, frame->pts);
+    if (!job) {
+        return false;
+    }
 
-    pthread_mutex_lock(&ctx->queue_mutex);
-    pkt->next = NULL;
-    if (ctx->pkt_queue_tail) {
-        ctx->pkt_queue_tail->next = pkt;
-        ctx->pkt_queue_tail = pkt;
-    } else {
-        ctx->pkt_queue_head = pkt;
-        ctx->pkt_queue_tail = pkt;
+    if (!netint_share_frame(ctx, job, frame) && !netint_upload_frame(ctx, job, &job->hw_frame, frame)) {
+        netint_release_job(ctx, job);
+        return false;
     }
-    pthread_mutex_unlock(&ctx->queue_mutex);
 
-    pthread_mutex_lock(&ctx->frame_queue_mutex);
-    if (ctx->inflight_frames > 0) {
-        ctx->inflight_frames--;
+    const ni_logan_frame_t *src = job->shared ? &job->shared->hw_frame : &job->hw_frame;
+    for (int i = 0; i < ladder->count; i++) {
+        struct netint_ladder_rung *rung = &ladder->rungs[i];
+        rung->job = netint_pipeline_admit(rung->ctx) ? netint_prepare_frame_job(rung->ctx, frame->pts) : NULL;
+        if (rung->job) {
+            rung->src = src;
+            os_sem_post(rung->start);
+        }
     }
-    if (ctx->frame_queue_cond_initialized) {
-        pthread_cond_broadcast(&ctx->frame_queue_cond);
+    for (int i = 0; i < ladder->count; i++) {
+        if (ladder->rungs[i].job) {
+            os_sem_wait(ladder->rungs[i].done);
+        }
     }
-    pthread_mutex_unlock(&ctx->frame_queue_mutex);
 
-    ctx->consecutive_errors = 0;
-    return true;
+    bool ok = netint_submit_frame_job(ctx, job);
+
+    for (int i = 0; i < ladder->count; i++) {
+        struct netint_ladder_rung *rung = &ladder->rungs[i];
+        if (!rung->job) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Ladder: rendition %dx%d dropped frame pts=%lld",
+                 rung->ctx->enc.width, rung->ctx->enc.height, (long long)frame->pts);
+            continue;
+        }
+        netint_submit_frame_job(rung->ctx, rung->job);
+        rung->job = NULL;
+        rung->src = NULL;
+    }
+    return ok;
 }
 
-static void netint_hw_drain(struct netint_ctx *ctx, bool drain_all)
+/**
+ * @brief Queue EOS on every rung that has not been flushed yet
+ */
+static void netint_ladder_queue_eos(struct netint_ladder *ladder)
 {
-    int drained = 0;
-    while (netint_hw_receive_once(ctx)) {
-        drained++;
-        if (!drain_all && drained >= 1) {
-            break;
+    for (int i = 0; i < ladder->count; i++) {
+        struct netint_ctx *rung_ctx = ladder->rungs[i].ctx;
+        if (!rung_ctx->flushing && netint_queue_eos(rung_ctx)) {
+            rung_ctx->flushing = true;
         }
     }
 }
 
-static void *netint_io_thread(void *data)
+/**
+ * @brief Hand every finished rendition packet to "netint_t4xx_ladder_packet" listeners
+ *
+ * Listeners run on the OBS encode thread and must copy the packet before
+ * returning; its data is recycled on the next call.
+ */
+static void netint_ladder_emit_packets(struct netint_ladder *ladder)
 {
-    struct netint_ctx *ctx = data;
-    blog(LOG_INFO, "[obs-netint-t4xx] IO thread started (pipelined send/receive)");
-
-    while (true) {
-        struct netint_frame_job *job = netint_dequeue_job(ctx, true);
-
-        if (!job) {
-            if (ctx->stop_thread) {
-                break;
+    signal_handler_t *sh = obs_get_signal_handler();
+    uint8_t stack[256];
+    struct calldata cd;
+
+    for (int i = 0; i < ladder->count; i++) {
+        struct netint_ctx *rung_ctx = ladder->rungs[i].ctx;
+        struct encoder_packet packet = {0};
+
+        while (netint_deliver_packet(rung_ctx, &packet)) {
+            calldata_init_fixed(&cd, stack, sizeof(stack));
+            calldata_set_ptr(&cd, "encoder", ladder->main->encoder);
+            calldata_set_int(&cd, "rendition", i + 1);
+            calldata_set_int(&cd, "width", rung_ctx->enc.width);
+            calldata_set_int(&cd, "height", rung_ctx->enc.height);
+            calldata_set_ptr(&cd, "packet", &packet);
+            if (sh) {
+                signal_handler_signal(sh, "netint_t4xx_ladder_packet", &cd);
             }
-
-            netint_hw_drain(ctx, false);
-            continue;
-        }
-
-        if (!netint_hw_send_job(ctx, job)) {
-            netint_release_job(ctx, job);
-            continue;
         }
+    }
+}
 
-        if (!job->end_of_stream) {
-            pthread_mutex_lock(&ctx->frame_queue_mutex);
-            ctx->inflight_frames++;
-            pthread_mutex_unlock(&ctx->frame_queue_mutex);
+static void netint_ladder_append_json(struct dstr *json, int index, struct netint_ctx *ctx)
+{
+    dstr_catf(json, "{\"rendition\":%d,\"width\":%d,\"height\":%d,\"bitrate_kbps\":%lld,\"device\":\"%s\"", index,
+              ctx->enc.width, ctx->enc.height, (long long)(ctx->enc.bit_rate / 1000),
+              ctx->enc.dev_xcoder ? ctx->enc.dev_xcoder : "");
+
+    /* Parameter sets, for listeners that mux the rendition themselves */
+    if (ctx->header_sync_initialized) {
+        pthread_mutex_lock(&ctx->header_mutex);
+        if (ctx->got_headers && ctx->extra) {
+            dstr_cat(json, ",\"headers\":\"");
+            for (size_t i = 0; i < ctx->extra_size; i++) {
+                dstr_catf(json, "%02x", ctx->extra[i]);
+            }
+            dstr_cat(json, "\"");
         }
+        pthread_mutex_unlock(&ctx->header_mutex);
+    }
+    dstr_cat(json, "}");
+}
 
-        netint_release_job(ctx, job);
+/**
+ * @brief "netint_t4xx_ladder_info" procedure: renditions of one ladder encoder as JSON
+ */
+static void netint_ladder_proc_info(void *data, calldata_t *cd)
+{
+    obs_encoder_t *encoder = calldata_ptr(cd, "encoder");
+    struct dstr json;
 
-        pthread_mutex_lock(&ctx->frame_queue_mutex);
-        int inflight = ctx->inflight_frames;
-        pthread_mutex_unlock(&ctx->frame_queue_mutex);
+    UNUSED_PARAMETER(data);
+    dstr_init_copy(&json, "{\"renditions\":[");
 
-        if (ctx->max_inflight > 0 && inflight >= ctx->max_inflight) {
-            netint_hw_drain(ctx, true);
-        } else {
-            netint_hw_drain(ctx, false);
+    pthread_mutex_lock(&s_ladder_mutex);
+    for (struct netint_ladder *ladder = s_ladders; ladder; ladder = ladder->next) {
+        if (ladder->main->encoder != encoder) {
+            continue;
+        }
+        netint_ladder_append_json(&json, 0, ladder->main);
+        for (int i = 0; i < ladder->count; i++) {
+            dstr_cat(&json, ",");
+            netint_ladder_append_json(&json, i + 1, ladder->rungs[i].ctx);
         }
+        break;
     }
+    pthread_mutex_unlock(&s_ladder_mutex);
 
-    /* Final drain to ensure packets (including EOS) are delivered */
-    netint_hw_drain(ctx, true);
-
-    blog(LOG_INFO, "[obs-netint-t4xx] IO thread exiting");
-    return NULL;
+    dstr_cat(&json, "]}");
+    calldata_set_string(cd, "json", json.array);
+    dstr_free(&json);
 }
 
 static bool netint_encode(void *data, struct encoder_frame *frame, struct encoder_packet *packet, bool *received)
@@ -2301,56 +5015,19 @@ static bool netint_encode(void *data, struct encoder_frame *frame, struct encode
 
     NETINT_VALIDATE_ENC_CONTEXT(ctx, "netint_encode entry");
 
-    /* Check for packets produced by IO thread */
-    pthread_mutex_lock(&ctx->queue_mutex);
-    if (ctx->last_delivered_pkt) {
-        netint_release_packet_locked(ctx, ctx->last_delivered_pkt);
-        ctx->last_delivered_pkt = NULL;
-    }
-
-    struct netint_pkt *pkt = ctx->pkt_queue_head;
-    if (pkt) {
-        ctx->pkt_queue_head = pkt->next;
-        if (!ctx->pkt_queue_head) {
-            ctx->pkt_queue_tail = NULL;
-        }
+    *received = netint_deliver_packet(ctx, packet);
+    if (os_atomic_load_bool(&ctx->encoder_failed)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Encoder session failed and could not be recovered");
+        return false;
     }
-    pthread_mutex_unlock(&ctx->queue_mutex);
-
-    bool delivered_packet = false;
-    if (pkt) {
-        packet->data = pkt->data;
-        packet->size = pkt->size;
-        packet->pts = pkt->pts;
-        packet->dts = pkt->dts;
-        packet->keyframe = pkt->keyframe;
-        packet->type = OBS_ENCODER_VIDEO;
-
-        video_t *video = obs_encoder_video(ctx->encoder);
-        const struct video_output_info *voi = video_output_get_info(video);
-        packet->timebase_num = (int32_t)voi->fps_den;
-        packet->timebase_den = (int32_t)voi->fps_num;
-
-        if (ctx->codec_type == 1) {
-            packet->priority = obs_parse_hevc_packet_priority(packet);
-        } else {
-            packet->priority = obs_parse_avc_packet_priority(packet);
-        }
-
-        ctx->last_delivered_pkt = pkt;
-        pkt = NULL;
-        *received = true;
-        delivered_packet = true;
-    } else {
-        packet->data = NULL;
-        packet->size = 0;
-        packet->pts = 0;
-        packet->dts = 0;
-        packet->keyframe = false;
-        packet->priority = 0;
+    if (ctx->ladder) {
+        netint_ladder_emit_packets(ctx->ladder);
     }
 
     if (!frame) {
+        if (ctx->ladder) {
+            netint_ladder_queue_eos(ctx->ladder);
+        }
         if (!ctx->flushing) {
             blog(LOG_INFO, "[obs-netint-t4xx] Queueing EOS frame");
             if (!netint_queue_eos(ctx)) {
@@ -2362,12 +5039,168 @@ static bool netint_encode(void *data, struct encoder_frame *frame, struct encode
         return true;
     }
 
+    if (ctx->ladder) {
+        return netint_ladder_queue_frame(ctx, frame);
+    }
+
     if (!netint_queue_frame(ctx, frame)) {
         return false;
     }
 
-    if (!delivered_packet) {
-        *received = false;
+    return true;
+}
+
+static bool netint_tex_stage_init(struct netint_ctx *ctx)
+{
+    uint32_t width = (uint32_t)ctx->enc.width;
+    uint32_t height = (uint32_t)ctx->enc.height;
+    bool p010 = ctx->input_format == VIDEO_FORMAT_P010;
+    bool ok = true;
+
+    obs_enter_graphics();
+    for (int i = 0; i < NETINT_TEX_STAGE_DEPTH; i++) {
+        ctx->tex_stage[i].y = gs_stagesurface_create(width, height, p010 ? GS_R16 : GS_R8);
+        ctx->tex_stage[i].uv = gs_stagesurface_create(width / 2, height / 2, p010 ? GS_RG16 : GS_R8G8);
+        if (!ctx->tex_stage[i].y || !ctx->tex_stage[i].uv) {
+            ok = false;
+            break;
+        }
+    }
+    obs_leave_graphics();
+
+    ctx->tex_stage_read = 0;
+    ctx->tex_stage_count = 0;
+    return ok;
+}
+
+static void netint_tex_stage_free(struct netint_ctx *ctx)
+{
+    if (!ctx->texture_input) {
+        return;
+    }
+
+    if (ctx->tex_stage_count > 0) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Dropping %d staged texture frame(s)", ctx->tex_stage_count);
+    }
+
+    obs_enter_graphics();
+    for (int i = 0; i < NETINT_TEX_STAGE_DEPTH; i++) {
+        if (ctx->tex_stage[i].y) {
+            gs_stagesurface_destroy(ctx->tex_stage[i].y);
+            ctx->tex_stage[i].y = NULL;
+        }
+        if (ctx->tex_stage[i].uv) {
+            gs_stagesurface_destroy(ctx->tex_stage[i].uv);
+            ctx->tex_stage[i].uv = NULL;
+        }
+    }
+    obs_leave_graphics();
+    ctx->tex_stage_count = 0;
+}
+
+/**
+ * @brief Map the oldest staged frame and copy it straight into a job buffer
+ *
+ * The job (and its hardware buffer) is acquired before entering the graphics
+ * context and submitted after leaving it, so a full pipeline never stalls
+ * the OBS render thread. The slot is consumed even on failure.
+ */
+static bool netint_tex_upload_oldest(struct netint_ctx *ctx)
+{
+    struct netint_tex_stage *slot = &ctx->tex_stage[ctx->tex_stage_read];
+    ctx->tex_stage_read = (ctx->tex_stage_read + 1) % NETINT_TEX_STAGE_DEPTH;
+    ctx->tex_stage_count--;
+
+    /* A skipped frame just frees its staging slot */
+    if (!netint_pipeline_admit(ctx)) {
+        return true;
+    }
+
+    struct netint_frame_job *job = netint_prepare_frame_job(ctx, slot->pts);
+    if (!job) {
+        return false;
+    }
+
+    struct encoder_frame frame = {0};
+    bool mapped_y = false;
+    bool mapped_uv = false;
+    bool copied = false;
+
+    obs_enter_graphics();
+    mapped_y = gs_stagesurface_map(slot->y, &frame.data[0], &frame.linesize[0]);
+    mapped_uv = mapped_y && gs_stagesurface_map(slot->uv, &frame.data[1], &frame.linesize[1]);
+    if (mapped_uv) {
+        frame.pts = slot->pts;
+        copied = netint_upload_frame(ctx, job, &job->hw_frame, &frame);
+    }
+    if (mapped_uv) {
+        gs_stagesurface_unmap(slot->uv);
+    }
+    if (mapped_y) {
+        gs_stagesurface_unmap(slot->y);
+    }
+    obs_leave_graphics();
+
+    if (!copied) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Failed to read back staged texture (pts=%lld)",
+             (long long)slot->pts);
+        netint_release_job(ctx, job);
+        return false;
+    }
+
+    return netint_submit_frame_job(ctx, job);
+}
+
+/**
+ * @brief Encode an OBS NV12/P010 texture (CAP_PASS_TEXTURE variants)
+ *
+ * The texture is copied into a staging surface on the GPU, and the staging
+ * surface filled on the previous call is mapped and repacked directly into a
+ * pooled hw_frame buffer. libobs never reads the frame back or converts it,
+ * and no intermediate system-memory frame exists.
+ */
+static bool netint_encode_texture2(void *data, struct encoder_texture *texture, int64_t pts,
+                                   uint64_t lock_key, uint64_t *next_key,
+                                   struct encoder_packet *packet, bool *received)
+{
+    struct netint_ctx *ctx = data;
+    *received = false;
+    *next_key = lock_key;
+
+    if (!texture || !texture->tex[0] || !texture->tex[1]) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] encode_texture2 called without luma/chroma textures");
+        return false;
+    }
+
+    NETINT_VALIDATE_ENC_CONTEXT(ctx, "netint_encode_texture2 entry");
+
+    *received = netint_deliver_packet(ctx, packet);
+    if (os_atomic_load_bool(&ctx->encoder_failed)) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Encoder session failed and could not be recovered");
+        return false;
+    }
+
+    int write_slot = (ctx->tex_stage_read + ctx->tex_stage_count) % NETINT_TEX_STAGE_DEPTH;
+    struct netint_tex_stage *slot = &ctx->tex_stage[write_slot];
+
+    obs_enter_graphics();
+#ifdef _WIN32
+    /* OBS textures are keyed-mutex shared on Windows */
+    gs_texture_acquire_sync(texture->tex[0], lock_key, GS_WAIT_INFINITE);
+#endif
+    gs_stage_texture(slot->y, texture->tex[0]);
+    gs_stage_texture(slot->uv, texture->tex[1]);
+#ifdef _WIN32
+    gs_texture_release_sync(texture->tex[0], *next_key);
+#endif
+    obs_leave_graphics();
+
+    slot->pts = pts;
+    ctx->tex_stage_count++;
+
+    /* Ring full: the oldest slot was staged on an earlier call and is ready to map */
+    if (ctx->tex_stage_count == NETINT_TEX_STAGE_DEPTH) {
+        return netint_tex_upload_oldest(ctx);
     }
     return true;
 }
@@ -2407,6 +5240,13 @@ static void netint_h264_get_defaults(obs_data_t *settings)
     
     /* Default GOP preset: default (I-B-B-B-P pattern with B-frames for best quality) */
     obs_data_set_default_string(settings, "gop_preset", "default");
+
+    /* Default pipeline depth: follow measured hardware latency */
+    obs_data_set_default_string(settings, "pipeline_depth", "auto");
+    obs_data_set_default_string(settings, "overload_policy", "block");
+
+    /* Default placement: least loaded device */
+    obs_data_set_default_string(settings, "device_placement", "least_load");
     
     /* Default repeat headers: true (attach SPS/PPS to every keyframe) */
     /* This is important for streaming where clients may join mid-stream */
@@ -2449,6 +5289,13 @@ static void netint_h265_get_defaults(obs_data_t *settings)
     
     /* Default GOP preset: default (I-B-B-B-P pattern with B-frames for best quality) */
     obs_data_set_default_string(settings, "gop_preset", "default");
+
+    /* Default pipeline depth: follow measured hardware latency */
+    obs_data_set_default_string(settings, "pipeline_depth", "auto");
+    obs_data_set_default_string(settings, "overload_policy", "block");
+
+    /* Default placement: least loaded device */
+    obs_data_set_default_string(settings, "device_placement", "least_load");
     
     /* Default repeat headers: true (attach SPS/PPS to every keyframe) */
     /* This is important for streaming where clients may join mid-stream */
@@ -2479,6 +5326,16 @@ static obs_properties_t *netint_h264_get_properties(void *data)
     
     /* Device name: text input (will be converted to dropdown if discovery works) */
     obs_properties_add_text(props, "device", "Device Name (optional)", OBS_TEXT_DEFAULT);
+
+    /* Placement used when no device is named */
+    obs_property_t *placement = obs_properties_add_list(props, "device_placement", "Device Placement",
+                                                        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(placement, "Least Loaded", "least_load");
+    obs_property_list_add_string(placement, "Least Loaded, Keep Same Canvas Together", "affinity");
+    obs_property_set_long_description(placement,
+        "How a device is chosen when Device Name is empty:\n"
+        "• Least Loaded: The device with the lowest encoder load\n"
+        "• Keep Same Canvas Together: Encoders of the same video output share a device while it has headroom");
     
     /* Rate control mode: CBR (constant) or VBR (variable) */
     obs_property_t *rc = obs_properties_add_list(props, "rc_mode", "Rate Control", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
@@ -2508,31 +5365,56 @@ static obs_properties_t *netint_h264_get_properties(void *data)
     obs_property_t *gop = obs_properties_add_list(props, "gop_preset", "GOP Preset", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
     obs_property_list_add_string(gop, "Default (I-B-B-B-P) - Best Quality", "default");
     obs_property_list_add_string(gop, "Simple (I-P-P-P) - Lower Latency", "simple");
+    obs_property_list_add_string(gop, "Ultra Low Latency (I-P-P-P, Intra Refresh)", "low_latency");
     obs_property_set_long_description(gop, 
         "GOP structure controls compression efficiency:\n"
         "• Default: Uses B-frames for best quality and compression\n"
-        "• Simple: No B-frames, lower latency but larger file size");
+        "• Simple: No B-frames, lower latency but larger file size\n"
+        "• Ultra Low Latency: No B-frames, low-delay coding, intra refresh instead of\n"
+        "  periodic keyframes (no bitrate spikes) and at most two frames in the encoder");
+
+    /* Pipeline depth: frames in flight in the card (latency vs memory vs throughput) */
+    obs_property_t *pipeline = obs_properties_add_list(props, "pipeline_depth", "Pipeline Depth",
+                                                       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(pipeline, "Auto", "auto");
+    obs_property_list_add_string(pipeline, "Low Latency", "low_latency");
+    obs_property_list_add_string(pipeline, "Balanced", "balanced");
+    obs_property_list_add_string(pipeline, "Throughput", "throughput");
+    obs_property_set_long_description(pipeline,
+        "How many frames may be queued in the encoder at once:\n"
+        "• Auto: Starts balanced and follows the measured hardware latency\n"
+        "• Low Latency: Only what the GOP structure needs\n"
+        "• Balanced: Two frames of headroom\n"
+        "• Throughput: Deep queue for cards shared by many sessions (more memory)");
+
+    /* Overload policy: what happens to new frames while the pipeline is full */
+    obs_property_t *overload = obs_properties_add_list(props, "overload_policy", "When Encoder Falls Behind",
+                                                       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(overload, "Wait (never lose frames)", "block");
+    obs_property_list_add_string(overload, "Drop Oldest Queued Frame", "drop_oldest");
+    obs_property_list_add_string(overload, "Skip New Frame", "skip");
+    obs_property_set_long_description(overload,
+        "What a new frame does when the encoder pipeline is full:\n"
+        "• Wait: OBS waits for the card, which stalls every encoder and output\n"
+        "• Drop Oldest: a queued frame that hasn't reached the card is discarded\n"
+        "• Skip: the new frame is not encoded\n"
+        "Lost frames are counted in the encoder stats.");
     
     /* Repeat headers checkbox: attach SPS/PPS to every keyframe */
     obs_properties_add_bool(props, "repeat_headers", "Repeat SPS/PPS on Keyframes");
 
-    /* Populate device list if discovery APIs are available */
-    if (p_ni_logan_rsrc_init && p_ni_logan_rsrc_get_local_device_list) {
-        int rsrc_ret = p_ni_logan_rsrc_init(0, 1);
-        if (rsrc_ret == 0 || rsrc_ret == 0x7FFFFFFF) {
-            char names[16][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
-            int n = p_ni_logan_rsrc_get_local_device_list(names, 16);
-            if (n > 0) {
-                obs_property_t *dev = obs_properties_get(props, "device");
-                if (dev) {
-                    obs_property_set_long_description(dev, "Device Name");
-                } else {
-                    dev = obs_properties_add_list(props, "device", "Device", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
-                }
-                for (int i = 0; i < n; i++) {
-                    obs_property_list_add_string(dev, names[i], names[i]);
-                }
-            }
+    /* Populate device list from the module's device registry (cached) */
+    char names[16][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    int n = netint_device_list(names, 16);
+    if (n > 0) {
+        obs_property_t *dev = obs_properties_get(props, "device");
+        if (dev) {
+            obs_property_set_long_description(dev, "Device Name");
+        } else {
+            dev = obs_properties_add_list(props, "device", "Device", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+        }
+        for (int i = 0; i < n; i++) {
+            obs_property_list_add_string(dev, names[i], names[i]);
         }
     }
     return props;
@@ -2562,6 +5444,16 @@ static obs_properties_t *netint_h265_get_properties(void *data)
     
     /* Device name: text input (will be converted to dropdown if discovery works) */
     obs_properties_add_text(props, "device", "Device Name (optional)", OBS_TEXT_DEFAULT);
+
+    /* Placement used when no device is named */
+    obs_property_t *placement = obs_properties_add_list(props, "device_placement", "Device Placement",
+                                                        OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(placement, "Least Loaded", "least_load");
+    obs_property_list_add_string(placement, "Least Loaded, Keep Same Canvas Together", "affinity");
+    obs_property_set_long_description(placement,
+        "How a device is chosen when Device Name is empty:\n"
+        "• Least Loaded: The device with the lowest encoder load\n"
+        "• Keep Same Canvas Together: Encoders of the same video output share a device while it has headroom");
     
     /* Rate control mode: CBR (constant) or VBR (variable) */
     obs_property_t *rc = obs_properties_add_list(props, "rc_mode", "Rate Control", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
@@ -2595,36 +5487,96 @@ static obs_properties_t *netint_h265_get_properties(void *data)
     obs_property_t *gop = obs_properties_add_list(props, "gop_preset", "GOP Preset", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
     obs_property_list_add_string(gop, "Default (I-B-B-B-P) - Best Quality", "default");
     obs_property_list_add_string(gop, "Simple (I-P-P-P) - Lower Latency", "simple");
+    obs_property_list_add_string(gop, "Ultra Low Latency (I-P-P-P, Intra Refresh)", "low_latency");
     obs_property_set_long_description(gop, 
         "GOP structure controls compression efficiency:\n"
         "• Default: Uses B-frames for best quality and compression\n"
-        "• Simple: No B-frames, lower latency but larger file size");
+        "• Simple: No B-frames, lower latency but larger file size\n"
+        "• Ultra Low Latency: No B-frames, low-delay coding, intra refresh instead of\n"
+        "  periodic keyframes (no bitrate spikes) and at most two frames in the encoder");
+
+    /* Pipeline depth: frames in flight in the card (latency vs memory vs throughput) */
+    obs_property_t *pipeline = obs_properties_add_list(props, "pipeline_depth", "Pipeline Depth",
+                                                       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(pipeline, "Auto", "auto");
+    obs_property_list_add_string(pipeline, "Low Latency", "low_latency");
+    obs_property_list_add_string(pipeline, "Balanced", "balanced");
+    obs_property_list_add_string(pipeline, "Throughput", "throughput");
+    obs_property_set_long_description(pipeline,
+        "How many frames may be queued in the encoder at once:\n"
+        "• Auto: Starts balanced and follows the measured hardware latency\n"
+        "• Low Latency: Only what the GOP structure needs\n"
+        "• Balanced: Two frames of headroom\n"
+        "• Throughput: Deep queue for cards shared by many sessions (more memory)");
+
+    /* Overload policy: what happens to new frames while the pipeline is full */
+    obs_property_t *overload = obs_properties_add_list(props, "overload_policy", "When Encoder Falls Behind",
+                                                       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+    obs_property_list_add_string(overload, "Wait (never lose frames)", "block");
+    obs_property_list_add_string(overload, "Drop Oldest Queued Frame", "drop_oldest");
+    obs_property_list_add_string(overload, "Skip New Frame", "skip");
+    obs_property_set_long_description(overload,
+        "What a new frame does when the encoder pipeline is full:\n"
+        "• Wait: OBS waits for the card, which stalls every encoder and output\n"
+        "• Drop Oldest: a queued frame that hasn't reached the card is discarded\n"
+        "• Skip: the new frame is not encoded\n"
+        "Lost frames are counted in the encoder stats.");
     
     /* Repeat headers checkbox: attach SPS/PPS to every keyframe */
     obs_properties_add_bool(props, "repeat_headers", "Repeat VPS/SPS/PPS on Keyframes");
 
-    /* Populate device list if discovery APIs are available */
-    if (p_ni_logan_rsrc_init && p_ni_logan_rsrc_get_local_device_list) {
-        int rsrc_ret = p_ni_logan_rsrc_init(0, 1);
-        if (rsrc_ret == 0 || rsrc_ret == 0x7FFFFFFF) {
-            char names[16][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
-            int n = p_ni_logan_rsrc_get_local_device_list(names, 16);
-            if (n > 0) {
-                obs_property_t *dev = obs_properties_get(props, "device");
-                if (dev) {
-                    obs_property_set_long_description(dev, "Device Name");
-                } else {
-                    dev = obs_properties_add_list(props, "device", "Device", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
-                }
-                for (int i = 0; i < n; i++) {
-                    obs_property_list_add_string(dev, names[i], names[i]);
-                }
-            }
+    /* Populate device list from the module's device registry (cached) */
+    char names[16][NI_LOGAN_MAX_DEVICE_NAME_LEN] = {0};
+    int n = netint_device_list(names, 16);
+    if (n > 0) {
+        obs_property_t *dev = obs_properties_get(props, "device");
+        if (dev) {
+            obs_property_set_long_description(dev, "Device Name");
+        } else {
+            dev = obs_properties_add_list(props, "device", "Device", OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+        }
+        for (int i = 0; i < n; i++) {
+            obs_property_list_add_string(dev, names[i], names[i]);
         }
     }
     return props;
 }
 
+static void netint_ladder_add_properties(obs_properties_t *props)
+{
+    obs_property_t *p = obs_properties_add_text(props, "ladder_renditions", "Extra Renditions", OBS_TEXT_DEFAULT);
+    obs_property_set_long_description(p,
+        "Comma-separated WIDTHxHEIGHT:KBPS list, e.g. 1280x720:3000,854x480:1200 (up to 3).\n"
+        "Each rendition is scaled from this encoder's frame and encoded in its own session on the least loaded die. "
+        "Packets are published through the netint_t4xx_ladder_packet signal; netint_t4xx_ladder_info lists them.");
+}
+
+static void netint_h264_ladder_get_defaults(obs_data_t *settings)
+{
+    netint_h264_get_defaults(settings);
+    obs_data_set_default_string(settings, "ladder_renditions", NETINT_LADDER_DEFAULT_RENDITIONS);
+}
+
+static void netint_h265_ladder_get_defaults(obs_data_t *settings)
+{
+    netint_h265_get_defaults(settings);
+    obs_data_set_default_string(settings, "ladder_renditions", NETINT_LADDER_DEFAULT_RENDITIONS);
+}
+
+static obs_properties_t *netint_h264_ladder_get_properties(void *data)
+{
+    obs_properties_t *props = netint_h264_get_properties(data);
+    netint_ladder_add_properties(props);
+    return props;
+}
+
+static obs_properties_t *netint_h265_ladder_get_properties(void *data)
+{
+    obs_properties_t *props = netint_h265_get_properties(data);
+    netint_ladder_add_properties(props);
+    return props;
+}
+
 /**
  * @brief Get encoder extradata (SPS/PPS headers) for stream initialization
  * 
@@ -2656,26 +5608,40 @@ static bool netint_get_extra_data(void *data, uint8_t **extra_data, size_t *size
     
     blog(LOG_INFO, "[obs-netint-t4xx] ▶ get_extra_data() called, got_headers=%d", ctx->got_headers);
     
-    /* If headers not available yet, wait for them (up to 5 seconds) */
-    /* This handles the case where headers are extracted from the first packet */
-    if (!ctx->got_headers) {
-        blog(LOG_INFO, "[obs-netint-t4xx] Headers not yet available, waiting for first packet...");
-        
-        /* Wait up to 5 seconds (50 x 100ms) for headers to be extracted */
-        for (int i = 0; i < 50; i++) {
-            os_sleep_ms(100);
-            
+    /* Headers normally come from encode_header at create. Otherwise the IO
+     * thread extracts them from the first packet and signals header_cond. */
+    if (ctx->header_sync_initialized) {
+        pthread_mutex_lock(&ctx->header_mutex);
+        if (!ctx->got_headers) {
+            blog(LOG_INFO, "[obs-netint-t4xx] Headers not yet available, waiting for first packet...");
+
+            uint64_t start_ns = os_gettime_ns();
+            struct timespec deadline;
+            timespec_get(&deadline, TIME_UTC);
+            deadline.tv_sec += NETINT_HEADER_WAIT_MS / 1000;
+            deadline.tv_nsec += (NETINT_HEADER_WAIT_MS % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            while (!ctx->got_headers && !os_atomic_load_bool(&ctx->stop_thread)) {
+                if (pthread_cond_timedwait(&ctx->header_cond, &ctx->header_mutex, &deadline) == ETIMEDOUT) {
+                    break;
+                }
+            }
+
             if (ctx->got_headers) {
-                blog(LOG_INFO, "[obs-netint-t4xx] Headers became available after %d ms", i * 100);
-                break;
+                blog(LOG_INFO, "[obs-netint-t4xx] Headers became available after %llu ms",
+                     (unsigned long long)((os_gettime_ns() - start_ns) / 1000000ULL));
             }
         }
-        
-        if (!ctx->got_headers) {
-            blog(LOG_ERROR, "[obs-netint-t4xx] Timeout waiting for encoder headers");
-            return false;
-        }
+        pthread_mutex_unlock(&ctx->header_mutex);
+    }
 
+    if (!ctx->got_headers) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] Timeout waiting for encoder headers");
+        return false;
     }
     
     /* Double-check extradata is valid */
@@ -2705,7 +5671,7 @@ static bool netint_get_extra_data(void *data, uint8_t **extra_data, size_t *size
  * - get_name: Returns display name shown in UI
  * - create: Called when encoder is created (user selects it)
  * - destroy: Called when encoder is destroyed
- * - update: Called when settings change (returns false - encoder doesn't support updates)
+ * - update: Called when settings change (live bitrate change, see DYN_BITRATE below)
  * - encode: Called for each video frame to encode
  * - get_defaults: Sets default values for settings
  * - get_properties: Creates settings UI
@@ -2714,14 +5680,17 @@ static bool netint_get_extra_data(void *data, uint8_t **extra_data, size_t *size
  * Capability Flags (caps):
  * - OBS_ENCODER_CAP_SCALING: The encoder consumes whatever scaled width/height OBS configured.
  * - OBS_ENCODER_CAP_ROI: ROI metadata is translated to NETINT ROI maps when supported.
+ * - OBS_ENCODER_CAP_DYN_BITRATE: netint_update queues the new target bitrate and the
+ *   IO thread applies it with the next frame (BITRATE aux data); VBV stays fixed.
+ * - OBS_ENCODER_CAP_PASS_TEXTURE (texture variants only): NV12 textures are staged
+ *   and copied straight into job buffers; they reroute to the CPU variant otherwise.
  * - Not advertised:
- *   - OBS_ENCODER_CAP_PASS_TEXTURE (CPU frame ingest only)
- *   - OBS_ENCODER_CAP_DYN_BITRATE (libxcoder lacks live reconfigure path in this integration)
  *   - OBS_ENCODER_CAP_INTERNAL / OBS_ENCODER_CAP_DEPRECATED (public, fully supported encoder)
  * 
- * Optional Callbacks (explicitly NULL):
+ * Optional Callbacks:
  * - get_sei_data: Not implemented (returns NULL)
- * - get_video_info: Not implemented (returns NULL)
+ * - get_video_info: Raw format to request; the texture variants use their own,
+ *   limited to the NV12/P010 surfaces they can map
  * 
  * These are set to NULL explicitly to ensure forward compatibility if OBS adds
  * new optional callbacks to the structure in future versions.
@@ -2732,7 +5701,7 @@ static struct obs_encoder_info netint_h264_info = {
     .id = "obs_netint_t4xx_h264",      /**< Unique identifier for this encoder */
     .codec = "h264",                   /**< Codec string (matches OBS codec type) */
     .type = OBS_ENCODER_VIDEO,        /**< Encoder type: video encoder */
-    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI,   /**< Accepts scaled frames and supports ROI */
+    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE, /**< Scaled frames, ROI, live bitrate */
     .get_name = netint_h264_get_name,  /**< Returns "NETINT T4XX H.264" */
     .create = netint_create,
     .destroy = netint_destroy,
@@ -2744,7 +5713,7 @@ static struct obs_encoder_info netint_h264_info = {
     /* Optional callbacks - explicitly NULL for forward compatibility */
     .get_sei_data = NULL,              /**< SEI data not provided (NULL callback) */
     .get_audio_info = NULL,            /**< Audio info not applicable (video encoder only) */
-    .get_video_info = netint_get_video_info,  /**< Request I420 format from OBS */
+    .get_video_info = netint_get_video_info,  /**< Request I420/NV12, or P010/I010 for 10-bit H.265 */
 };
 
 /** H.265 (HEVC) encoder registration - appears as "NETINT T4XX H.265" in encoder list */
@@ -2752,7 +5721,7 @@ static struct obs_encoder_info netint_h265_info = {
     .id = "obs_netint_t4xx_h265",      /**< Unique identifier for this encoder */
     .codec = "hevc",                   /**< Codec string (OBS uses "hevc" for H.265) */
     .type = OBS_ENCODER_VIDEO,        /**< Encoder type: video encoder */
-    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI,   /**< Accepts scaled frames and supports ROI */
+    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE, /**< Scaled frames, ROI, live bitrate */
     .get_name = netint_h265_get_name,  /**< Returns "NETINT T4XX H.265" */
     .create = netint_create,
     .destroy = netint_destroy,
@@ -2764,7 +5733,75 @@ static struct obs_encoder_info netint_h265_info = {
     /* Optional callbacks - explicitly NULL for forward compatibility */
     .get_sei_data = NULL,              /**< SEI data not provided (NULL callback) */
     .get_audio_info = NULL,            /**< Audio info not applicable (video encoder only) */
-    .get_video_info = netint_get_video_info,  /**< Request I420 format from OBS */
+    .get_video_info = netint_get_video_info,  /**< Request I420/NV12, or P010/I010 for 10-bit H.265 */
+};
+
+/** H.264 texture-input registration - reroutes to netint_h264_info when NV12 textures are unavailable */
+static struct obs_encoder_info netint_h264_tex_info = {
+    .id = "obs_netint_t4xx_h264_tex",
+    .codec = "h264",
+    .type = OBS_ENCODER_VIDEO,
+    .caps = OBS_ENCODER_CAP_PASS_TEXTURE | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE,
+    .get_name = netint_h264_tex_get_name,
+    .create = netint_h264_tex_create,
+    .destroy = netint_destroy,
+    .update = netint_update,
+    .encode_texture2 = netint_encode_texture2,
+    .get_defaults = netint_h264_get_defaults,
+    .get_properties = netint_h264_get_properties,
+    .get_extra_data = netint_get_extra_data,
+    .get_video_info = netint_tex_get_video_info,  /**< Request NV12, or P010 for 10-bit H.265 */
+};
+
+/** H.265 texture-input registration - reroutes to netint_h265_info when NV12 textures are unavailable */
+static struct obs_encoder_info netint_h265_tex_info = {
+    .id = "obs_netint_t4xx_h265_tex",
+    .codec = "hevc",
+    .type = OBS_ENCODER_VIDEO,
+    .caps = OBS_ENCODER_CAP_PASS_TEXTURE | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE,
+    .get_name = netint_h265_tex_get_name,
+    .create = netint_h265_tex_create,
+    .destroy = netint_destroy,
+    .update = netint_update,
+    .encode_texture2 = netint_encode_texture2,
+    .get_defaults = netint_h265_get_defaults,
+    .get_properties = netint_h265_get_properties,
+    .get_extra_data = netint_get_extra_data,
+    .get_video_info = netint_tex_get_video_info,  /**< Request NV12, or P010 for 10-bit H.265 */
+};
+
+/** H.264 ABR ladder - full-size output to OBS, extra renditions via netint_t4xx_ladder_packet */
+static struct obs_encoder_info netint_h264_ladder_info = {
+    .id = "obs_netint_t4xx_h264_ladder",
+    .codec = "h264",
+    .type = OBS_ENCODER_VIDEO,
+    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE,
+    .get_name = netint_h264_ladder_get_name,
+    .create = netint_ladder_create,
+    .destroy = netint_destroy,
+    .update = netint_update,
+    .encode = netint_encode,
+    .get_defaults = netint_h264_ladder_get_defaults,
+    .get_properties = netint_h264_ladder_get_properties,
+    .get_extra_data = netint_get_extra_data,
+    .get_video_info = netint_get_video_info,
+};
+
+/** H.265 ABR ladder - full-size output to OBS, extra renditions via netint_t4xx_ladder_packet */
+static struct obs_encoder_info netint_h265_ladder_info = {
+    .id = "obs_netint_t4xx_h265_ladder",
+    .codec = "hevc",
+    .type = OBS_ENCODER_VIDEO,
+    .caps = OBS_ENCODER_CAP_SCALING | OBS_ENCODER_CAP_ROI | OBS_ENCODER_CAP_DYN_BITRATE,
+    .get_name = netint_h265_ladder_get_name,
+    .create = netint_ladder_create,
+    .destroy = netint_destroy,
+    .update = netint_update,
+    .encode = netint_encode,
+    .get_defaults = netint_h265_ladder_get_defaults,
+    .get_properties = netint_h265_ladder_get_properties,
+    .get_extra_data = netint_get_extra_data,
+    .get_video_info = netint_get_video_info,
 };
 /*@}*/
 
@@ -2806,6 +5843,42 @@ void netint_register_encoders(void)
 {
     obs_register_encoder(&netint_h264_info);
     obs_register_encoder(&netint_h265_info);
+    obs_register_encoder(&netint_h264_tex_info);
+    obs_register_encoder(&netint_h265_tex_info);
+    obs_register_encoder(&netint_h264_ladder_info);
+    obs_register_encoder(&netint_h265_ladder_info);
+
+    /* Ladder renditions leave through the global handlers, each tagged with its encoder */
+    signal_handler_t *sh = obs_get_signal_handler();
+    if (sh) {
+        signal_handler_add(sh, "void netint_t4xx_ladder_packet(ptr encoder, int rendition, int width, int height, "
+                               "ptr packet)");
+        signal_handler_add(sh, "void netint_t4xx_overload(ptr encoder, int dropped, int skipped)");
+    }
+    proc_handler_t *ph = obs_get_proc_handler();
+    if (ph) {
+        proc_handler_add(ph, "void netint_t4xx_ladder_info(in ptr encoder, out string json)",
+                         netint_ladder_proc_info, NULL);
+    }
+}
+
+const struct obs_encoder_info *netint_find_encoder_info(const char *id)
+{
+    const struct obs_encoder_info *infos[] = {
+        &netint_h264_info,
+        &netint_h265_info,
+        &netint_h264_tex_info,
+        &netint_h265_tex_info,
+        &netint_h264_ladder_info,
+        &netint_h265_ladder_info,
+    };
+
+    for (size_t i = 0; id && i < sizeof(infos) / sizeof(infos[0]); i++) {
+        if (strcmp(infos[i]->id, id) == 0) {
+            return infos[i];
+        }
+    }
+    return NULL;
 }
 
 
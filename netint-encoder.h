@@ -55,4 +55,36 @@ void netint_loader_deinit(void);
  */
 void netint_register_encoders(void);
 
+/**
+ * @brief Look up one of the encoder definitions registered by netint_register_encoders()
+ *
+ * For tools that build the encoder sources in and drive the obs_encoder_info
+ * callbacks directly (tools/netint-bench.c).
+ *
+ * @return The definition, or NULL if @p id isn't one of this plugin's encoders
+ */
+const struct obs_encoder_info *netint_find_encoder_info(const char *id);
+
+struct netint_session_config;
+
+/**
+ * @brief Open a session for the session pool (netint-session-pool.c)
+ *
+ * The returned session holds an open libxcoder context and a device lease,
+ * but no IO thread; an encoder created with the same configuration adopts it.
+ *
+ * @return The session, or NULL if it could not be opened
+ */
+void *netint_warm_session_open(const struct netint_session_config *config);
 
+/**
+ * @brief Start a fresh stream on a session recycled after EOS
+ *
+ * @return false if the session could not be reopened; close it then
+ */
+bool netint_warm_session_restart(void *session, const struct netint_session_config *config);
+
+/**
+ * @brief Close a pooled session that was never adopted
+ */
+void netint_warm_session_close(void *session);
@@ -0,0 +1,278 @@
+/**
+ * @file netint-frame-cache.c
+ * @brief Hardware-formatted frames shared between NETINT encoders
+ *
+ * See netint-frame-cache.h. One module mutex guards the group list, the
+ * entry lists and every reference count; it is never held across a copy or
+ * a call into the card.
+ */
+
+#include "netint-frame-cache.h"
+
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <string.h>
+
+struct netint_frame_group {
+    struct netint_frame_layout layout;
+    long users;
+    struct netint_shared_frame *entries;
+    int idle;                         /**< Entries with no reference */
+    struct netint_frame_group *next;
+};
+
+static pthread_mutex_t s_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct netint_frame_group *s_groups;
+
+static size_t netint_frame_layout_plane_size(const struct netint_frame_layout *layout, int plane)
+{
+    if (layout->hw_stride[plane] <= 0 || layout->hw_height[plane] <= 0) {
+        return 0;
+    }
+    return (size_t)layout->hw_stride[plane] * (size_t)layout->hw_height[plane];
+}
+
+static void netint_shared_frame_free(struct netint_shared_frame *shared)
+{
+    if (shared->hw_frame.p_buffer && p_ni_logan_frame_buffer_free) {
+        p_ni_logan_frame_buffer_free(&shared->hw_frame);
+    }
+    pthread_mutex_destroy(&shared->send_mutex);
+    bfree(shared);
+}
+
+static struct netint_shared_frame *netint_shared_frame_alloc(struct netint_frame_group *group)
+{
+    const struct netint_frame_layout *layout = &group->layout;
+    struct netint_shared_frame *shared = bzalloc(sizeof(*shared));
+    int hw_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS];
+
+    if (pthread_mutex_init(&shared->send_mutex, NULL) != 0) {
+        bfree(shared);
+        return NULL;
+    }
+
+    memcpy(hw_stride, layout->hw_stride, sizeof(hw_stride));
+    shared->hw_frame.extra_data_len = layout->extra_data_len;
+    int ret = p_ni_logan_encoder_frame_buffer_alloc(&shared->hw_frame, layout->width, layout->height, hw_stride,
+                                                    layout->is_h264, layout->extra_data_len,
+                                                    layout->bit_depth_factor);
+    if (ret != NI_LOGAN_RETCODE_SUCCESS) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to allocate shared frame buffer (ret=%d)", ret);
+        memset(&shared->hw_frame, 0, sizeof(shared->hw_frame));
+        netint_shared_frame_free(shared);
+        return NULL;
+    }
+
+    for (int i = 0; i < NI_LOGAN_MAX_NUM_DATA_POINTERS; i++) {
+        shared->hw_frame.data_len[i] = (uint32_t)netint_frame_layout_plane_size(layout, i);
+    }
+    shared->hw_frame.video_width = layout->width;
+    shared->hw_frame.video_height = layout->height;
+    shared->hw_frame.video_orig_width = layout->width;
+    shared->hw_frame.video_orig_height = layout->height;
+    shared->group = group;
+    return shared;
+}
+
+static bool netint_shared_frame_matches(const struct netint_shared_frame *shared,
+                                        const struct encoder_frame *frame, uint64_t now_ns, uint64_t window_ns)
+{
+    if (!shared->ready || now_ns - shared->upload_ns > window_ns) {
+        return false;
+    }
+    for (int i = 0; i < MAX_AV_PLANES; i++) {
+        if (shared->src_data[i] != frame->data[i] || shared->src_linesize[i] != frame->linesize[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct netint_frame_group *netint_frame_cache_attach(const struct netint_frame_layout *layout)
+{
+    struct netint_frame_group *group;
+
+    pthread_mutex_lock(&s_cache_mutex);
+    for (group = s_groups; group; group = group->next) {
+        if (memcmp(&group->layout, layout, sizeof(*layout)) == 0) {
+            break;
+        }
+    }
+    if (!group) {
+        group = bzalloc(sizeof(*group));
+        group->layout = *layout;
+        group->next = s_groups;
+        s_groups = group;
+    }
+    group->users++;
+    long users = group->users;
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    if (users > 1) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Sharing frame uploads with %ld other encoder(s) (%dx%d)", users - 1,
+             layout->width, layout->height);
+    }
+    return group;
+}
+
+void netint_frame_cache_detach(struct netint_frame_group *group)
+{
+    struct netint_shared_frame *entries = NULL;
+
+    if (!group) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_cache_mutex);
+    if (--group->users == 0) {
+        for (struct netint_frame_group **link = &s_groups; *link; link = &(*link)->next) {
+            if (*link == group) {
+                *link = group->next;
+                break;
+            }
+        }
+        entries = group->entries;
+        group->entries = NULL;
+    } else {
+        group = NULL;
+    }
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    while (entries) {
+        struct netint_shared_frame *next = entries->next;
+        if (entries->refs > 0) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] Shared frame freed with %ld reference(s) left", entries->refs);
+        }
+        netint_shared_frame_free(entries);
+        entries = next;
+    }
+    bfree(group);
+}
+
+struct netint_shared_frame *netint_frame_cache_get(struct netint_frame_group *group,
+                                                   const struct encoder_frame *frame, uint64_t window_ns,
+                                                   bool *fresh)
+{
+    struct netint_shared_frame *shared = NULL;
+    struct netint_shared_frame *idle = NULL;
+    uint64_t now_ns = os_gettime_ns();
+
+    *fresh = false;
+    if (!group || !p_ni_logan_encoder_frame_buffer_alloc) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&s_cache_mutex);
+    if (group->users < 2) {
+        pthread_mutex_unlock(&s_cache_mutex);
+        return NULL;
+    }
+
+    for (struct netint_shared_frame *e = group->entries; e; e = e->next) {
+        if (netint_shared_frame_matches(e, frame, now_ns, window_ns)) {
+            shared = e;
+            break;
+        }
+        if (e->refs == 0 && !idle) {
+            idle = e;
+        }
+    }
+
+    if (shared) {
+        if (shared->refs++ == 0) {
+            group->idle--;
+        }
+        pthread_mutex_unlock(&s_cache_mutex);
+        return shared;
+    }
+
+    if (idle) {
+        idle->ready = false;
+        idle->refs = 1;
+        group->idle--;
+        pthread_mutex_unlock(&s_cache_mutex);
+        *fresh = true;
+        return idle;
+    }
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    /* Allocate outside the lock; only this encoder knows about it until publish */
+    shared = netint_shared_frame_alloc(group);
+    if (!shared) {
+        return NULL;
+    }
+    shared->refs = 1;
+
+    pthread_mutex_lock(&s_cache_mutex);
+    shared->next = group->entries;
+    group->entries = shared;
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    *fresh = true;
+    return shared;
+}
+
+void netint_frame_cache_publish(struct netint_shared_frame *shared, const struct encoder_frame *frame)
+{
+    pthread_mutex_lock(&s_cache_mutex);
+    for (int i = 0; i < MAX_AV_PLANES; i++) {
+        shared->src_data[i] = frame->data[i];
+        shared->src_linesize[i] = frame->linesize[i];
+    }
+    shared->upload_ns = os_gettime_ns();
+    shared->ready = true;
+    pthread_mutex_unlock(&s_cache_mutex);
+}
+
+void netint_frame_cache_release(struct netint_shared_frame *shared)
+{
+    struct netint_frame_group *group;
+    bool free_entry = false;
+
+    if (!shared) {
+        return;
+    }
+    group = shared->group;
+
+    pthread_mutex_lock(&s_cache_mutex);
+    if (--shared->refs == 0) {
+        if (group->idle >= NETINT_FRAME_CACHE_IDLE_MAX) {
+            for (struct netint_shared_frame **link = &group->entries; *link; link = &(*link)->next) {
+                if (*link == shared) {
+                    *link = shared->next;
+                    break;
+                }
+            }
+            free_entry = true;
+        } else {
+            group->idle++;
+        }
+    }
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    if (free_entry) {
+        netint_shared_frame_free(shared);
+    }
+}
+
+void netint_frame_cache_shutdown(void)
+{
+    pthread_mutex_lock(&s_cache_mutex);
+    struct netint_frame_group *groups = s_groups;
+    s_groups = NULL;
+    pthread_mutex_unlock(&s_cache_mutex);
+
+    while (groups) {
+        struct netint_frame_group *next = groups->next;
+        blog(LOG_WARNING, "[obs-netint-t4xx] Frame cache group still had %ld encoder(s) at unload", groups->users);
+        while (groups->entries) {
+            struct netint_shared_frame *entry = groups->entries;
+            groups->entries = entry->next;
+            netint_shared_frame_free(entry);
+        }
+        bfree(groups);
+        groups = next;
+    }
+}
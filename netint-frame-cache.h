@@ -0,0 +1,107 @@
+/**
+ * @file netint-frame-cache.h
+ * @brief Hardware-formatted frames shared between NETINT encoders
+ *
+ * A stream and a recording encoder on the same canvas receive the very same
+ * OBS frame. Without sharing, each session repacks it into its own hardware
+ * buffer, so the host copy is paid once per encoder.
+ *
+ * Encoders attach to a group keyed on their layout signature (format, size,
+ * codec alignment and hw_stride/hw_height). Within a group the first encoder
+ * to see a frame uploads it into a reference-counted buffer, and every other
+ * encoder that gets the same frame takes a reference instead of copying.
+ * The buffer goes back to the group's idle list once every session has sent
+ * it.
+ *
+ * A frame is recognised by its source plane pointers plus the time it was
+ * uploaded: encoder PTS values are relative to each encoder's own start, so
+ * they cannot be compared across sessions, while OBS hands all encoders of a
+ * video output the same planes for a frame and only reuses them several frame
+ * intervals later.
+ *
+ * encode_send and prep_aux_data write per-session metadata into the frame
+ * buffer, so sends of a shared frame are serialised with its send mutex.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <obs.h>
+#include <util/threading.h>
+#include "netint-libxcoder.h"
+
+/** Idle buffers kept per group for reuse; more are freed on release */
+#define NETINT_FRAME_CACHE_IDLE_MAX 4
+
+struct netint_frame_layout {
+    int format;                       /**< enum video_format of the input */
+    int width;
+    int height;
+    int is_h264;
+    int bit_depth_factor;
+    int extra_data_len;
+    int hw_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS];
+    int hw_height[NI_LOGAN_MAX_NUM_DATA_POINTERS];
+};
+
+struct netint_frame_group;
+
+struct netint_shared_frame {
+    ni_logan_frame_t hw_frame;        /**< Hardware buffer, owned by the cache */
+    struct netint_frame_group *group;
+
+    /* Key, valid while ready is set */
+    uint8_t *src_data[MAX_AV_PLANES];
+    uint32_t src_linesize[MAX_AV_PLANES];
+    uint64_t upload_ns;
+    bool ready;
+
+    long refs;                        /**< Guarded by the cache mutex */
+    pthread_mutex_t send_mutex;
+    struct netint_shared_frame *next;
+};
+
+/**
+ * @brief Join (or create) the group for @p layout
+ *
+ * @return The group, or NULL on allocation failure
+ */
+struct netint_frame_group *netint_frame_cache_attach(const struct netint_frame_layout *layout);
+
+/**
+ * @brief Leave a group; the last encoder out frees its buffers
+ *
+ * Every shared frame taken from the group must have been released first.
+ */
+void netint_frame_cache_detach(struct netint_frame_group *group);
+
+/**
+ * @brief Get the shared buffer for @p frame (OBS thread)
+ *
+ * If another encoder of the group uploaded the same frame within
+ * @p window_ns, that buffer is returned with a new reference and @p *fresh is
+ * false. Otherwise a buffer is reserved with @p *fresh set; the caller fills
+ * it and calls netint_frame_cache_publish().
+ *
+ * @return NULL when the group has a single encoder (nothing to share) or no
+ *         buffer could be allocated; the caller uploads on its own then.
+ */
+struct netint_shared_frame *netint_frame_cache_get(struct netint_frame_group *group,
+                                                   const struct encoder_frame *frame, uint64_t window_ns,
+                                                   bool *fresh);
+
+/**
+ * @brief Make a freshly filled buffer visible to the other encoders
+ */
+void netint_frame_cache_publish(struct netint_shared_frame *shared, const struct encoder_frame *frame);
+
+/**
+ * @brief Drop one reference (any thread)
+ */
+void netint_frame_cache_release(struct netint_shared_frame *shared);
+
+/**
+ * @brief Free every buffer still cached (obs_module_unload, before libxcoder closes)
+ */
+void netint_frame_cache_shutdown(void);
@@ -85,14 +85,31 @@ typedef enum {
 } ni_logan_device_type_t;
 /*@}*/
 
+/**
+ * @brief Leading fields of the resource manager's device record (ni_rsrc_api_logan.h)
+ *
+ * The record returned by ni_logan_rsrc_get_device_info() is larger; the plugin
+ * only reads this prefix, whose layout is stable across libxcoder releases.
+ * The caller owns the returned memory and releases it with free().
+ */
+typedef struct _ni_logan_device_info {
+    char dev_name[NI_LOGAN_MAX_DEVICE_NAME_LEN];  /**< Character device, e.g. /dev/nvme0 */
+    char blk_name[NI_LOGAN_MAX_DEVICE_NAME_LEN];  /**< Block device, e.g. /dev/nvme0n1 */
+    int hw_id;                                    /**< Encoder hardware index */
+    int module_id;                                /**< Resource manager GUID */
+    int load;                                     /**< Current encoder load in percent */
+    int model_load;                               /**< Firmware model load in percent */
+} ni_logan_device_info_t;
+
 /**
  * @brief Pixel format enumeration
  * 
- * Currently only YUV420P (planar YUV 4:2:0) is supported by the encoder.
- * This format has separate Y, U, and V planes.
+ * The encoder ingests planar YUV 4:2:0 only (separate Y, U, and V planes),
+ * either 8-bit or 10-bit little-endian in 16-bit words (LSB-aligned).
  */
 typedef enum {
-    NI_LOGAN_PIX_FMT_YUV420P = 0,  /**< Planar YUV 4:2:0 format */
+    NI_LOGAN_PIX_FMT_YUV420P = 0,      /**< Planar YUV 4:2:0, 8-bit */
+    NI_LOGAN_PIX_FMT_YUV420P10LE = 1,  /**< Planar YUV 4:2:0, 10-bit in 16-bit LE words */
 } ni_logan_pix_fmt_t;
 
 /**
@@ -12,6 +12,7 @@
  * - Symbol resolution: Function pointers are resolved at runtime via os_dlsym
  * - Optional APIs: Some functions (device discovery, parameter setting) are optional
  * - Path override: Can specify library path via NETINT_LIBXCODER_PATH environment variable
+ * - Mock backend: NETINT_MOCK=1 installs the built-in stand-in (netint-mock.c) instead
  * 
  * Architecture:
  * - Function pointers are stored as global variables (prefixed with p_)
@@ -25,6 +26,8 @@
  */
 
 #include "netint-libxcoder.h"
+#include "netint-mock.h"
+#include "netint-log.h"
 
 #include <obs-module.h>
 #include <util/platform.h>
@@ -36,6 +39,9 @@
  * 
  * libxcoder uses ni_log() which outputs to stderr by default.
  * OBS doesn't capture stderr, so we need to redirect to blog().
+ * It logs from inside send/receive on the IO threads, so messages go through
+ * netint_logva(): filtered by level before they are formatted, rate limited,
+ * and written by the log thread.
  */
 static void netint_log_callback(int level, const char *fmt, va_list vl)
 {
@@ -61,16 +67,7 @@ static void netint_log_callback(int level, const char *fmt, va_list vl)
     }
     
     /* Forward to OBS's logging system with [libxcoder] prefix */
-    char buffer[4096];
-    vsnprintf(buffer, sizeof(buffer), fmt, vl);
-    
-    /* Remove trailing newline if present (blog adds its own) */
-    size_t len = strlen(buffer);
-    if (len > 0 && buffer[len-1] == '\n') {
-        buffer[len-1] = '\0';
-    }
-    
-    blog(obs_level, "[libxcoder] %s", buffer);
+    netint_logva(obs_level, "[libxcoder] ", fmt, vl);
 }
 
 /**
@@ -85,6 +82,9 @@ static void netint_log_callback(int level, const char *fmt, va_list vl)
  */
 static void *s_lib_handle = NULL;
 
+/** true while the function pointers point at the mock backend */
+static bool s_mock_active = false;
+
 /**
  * @name Required Encoder API Function Pointers
  * @brief These functions must be present in libxcoder for basic encoding to work
@@ -176,6 +176,12 @@ int (*p_ni_logan_rsrc_init)(int, int) = NULL;
 
 /** Get list of available NETINT devices on the system */
 int (*p_ni_logan_rsrc_get_local_device_list)(char devices[][NI_LOGAN_MAX_DEVICE_NAME_LEN], int max_handles) = NULL;
+
+/** Look up a device's resource manager GUID by block device name */
+int (*p_ni_logan_rsrc_get_device_by_block_name)(const char *, ni_logan_device_type_t) = NULL;
+
+/** Snapshot of a device's resource manager record (load) */
+ni_logan_device_info_t *(*p_ni_logan_rsrc_get_device_info)(ni_logan_device_type_t, int) = NULL;
 /*@}*/
 
 /**
@@ -209,6 +215,8 @@ void (*p_ni_logan_enc_prep_aux_data)(ni_logan_session_context_t *, ni_logan_fram
 #include <stdarg.h>
 /** Set custom log callback to capture libxcoder logs */
 void (*p_ni_log_set_callback)(void (*log_callback)(int, const char*, va_list)) = NULL;
+/** Set libxcoder's own level, so messages we would filter are never produced */
+void (*p_ni_log_set_level)(int level) = NULL;
 /*@}*/
 
 /**
@@ -241,7 +249,14 @@ bool ni_libxcoder_open(void)
 {
     /* If library is already loaded, return success immediately */
     /* This makes the function idempotent and safe to call multiple times */
-    if (s_lib_handle) {
+    if (s_lib_handle || s_mock_active) {
+        return true;
+    }
+
+    /* NETINT_MOCK runs the plugin without a card or the vendor library */
+    if (netint_mock_requested()) {
+        netint_mock_install();
+        s_mock_active = true;
         return true;
     }
 
@@ -332,6 +347,16 @@ bool ni_libxcoder_open(void)
     /* If missing, we continue - device discovery just won't work in UI */
     p_ni_logan_rsrc_init = (void *)os_dlsym(s_lib_handle, "ni_logan_rsrc_init");
     p_ni_logan_rsrc_get_local_device_list = (void *)os_dlsym(s_lib_handle, "ni_logan_rsrc_get_local_device_list");
+
+    /* Optional load queries - without them sessions are placed by this plugin's own session count */
+    p_ni_logan_rsrc_get_device_by_block_name = (void *)os_dlsym(s_lib_handle, "ni_logan_rsrc_get_device_by_block_name");
+#ifndef _WIN32
+    /* The record is malloc'd by libxcoder and freed by us - not safe across DLL heaps on Windows */
+    p_ni_logan_rsrc_get_device_info = (void *)os_dlsym(s_lib_handle, "ni_logan_rsrc_get_device_info");
+#endif
+    if (!p_ni_logan_rsrc_get_device_by_block_name || !p_ni_logan_rsrc_get_device_info) {
+        blog(LOG_INFO, "[obs-netint-t4xx] Device load query not available - placement uses plugin session load only");
+    }
     
     /* Optional encoder params API - allows runtime parameter adjustment */
     /* If missing, we can't set advanced parameters like CBR/VBR mode dynamically */
@@ -348,6 +373,10 @@ bool ni_libxcoder_open(void)
     if (p_ni_log_set_callback) {
         blog(LOG_INFO, "[obs-netint-t4xx] Redirecting libxcoder log output to OBS");
         p_ni_log_set_callback(netint_log_callback);
+        p_ni_log_set_level = (void *)os_dlsym(s_lib_handle, "ni_log_set_level");
+        if (p_ni_log_set_level) {
+            p_ni_log_set_level(netint_log_libxcoder_level());
+        }
     } else {
         blog(LOG_WARNING, "[obs-netint-t4xx] ni_log_set_callback not found - libxcoder logs will not appear in OBS log");
     }
@@ -376,6 +405,7 @@ bool ni_libxcoder_open(void)
  */
 void ni_libxcoder_close(void)
 {
+    s_mock_active = false;
     if (s_lib_handle) {
         /* Close the library handle - this decrements the reference count */
         /* The library will actually unload when reference count reaches 0 */
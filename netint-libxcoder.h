@@ -45,6 +45,7 @@ typedef struct _ni_logan_packet ni_logan_packet_t;
  * Library path resolution:
  * - Checks NETINT_LIBXCODER_PATH environment variable first
  * - Falls back to platform-specific default: "libxcoder_logan.so" (Linux) or "libxcoder_logan.dll" (Windows)
+ * - With NETINT_MOCK=1, installs the built-in mock backend instead (see netint-mock.h)
  * 
  * @return true if library loaded and all required symbols resolved, false otherwise
  */
@@ -154,6 +155,12 @@ extern int (*p_ni_logan_rsrc_init)(int should_match_rev, int timeout_seconds);
 
 /** Get list of available NETINT devices on the system */
 extern int (*p_ni_logan_rsrc_get_local_device_list)(char devices[][NI_LOGAN_MAX_DEVICE_NAME_LEN], int max_handles);
+
+/** Look up a device's resource manager GUID by block device name (-1 if unknown) */
+extern int (*p_ni_logan_rsrc_get_device_by_block_name)(const char *blk_name, ni_logan_device_type_t device_type);
+
+/** Snapshot of a device's resource manager record, released with free() (used for load-aware placement) */
+extern ni_logan_device_info_t *(*p_ni_logan_rsrc_get_device_info)(ni_logan_device_type_t device_type, int guid);
 /*@}*/
 
 /**
@@ -200,6 +207,9 @@ extern void (*p_ni_logan_enc_prep_aux_data)(ni_logan_session_context_t *, ni_log
 #define NI_LOGAN_ENC_PARAM_INTRA_PERIOD                   "intraPeriod"
 #define NI_LOGAN_ENC_PARAM_ROI_ENABLE                     "roiEnable"
 #define NI_LOGAN_ENC_PARAM_CACHE_ROI                      "cacheRoi"
+#define NI_LOGAN_ENC_PARAM_LOW_DELAY                      "lowDelay"
+#define NI_LOGAN_ENC_PARAM_INTRA_REFRESH_MODE             "intraRefreshMode"
+#define NI_LOGAN_ENC_PARAM_INTRA_REFRESH_ARG              "intraRefreshArg"
 /*@}*/
 
 #endif /* NETINT_LIBXCODER_H */
\ No newline at end of file
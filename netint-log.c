@@ -0,0 +1,339 @@
+/**
+ * @file netint-log.c
+ * @brief Level-filtered, asynchronous logging for libxcoder and the IO paths
+ *
+ * See netint-log.h. The ring is a bounded multi-producer queue: every slot
+ * carries a sequence number, a producer claims the slot at s_enqueue_pos by
+ * moving the position with a compare-and-swap, formats into it and then
+ * publishes it by advancing the slot's sequence. Only the drain thread reads,
+ * so the read position is a plain variable. Sequence arithmetic is done
+ * unsigned and compared as a difference, so the counters may wrap.
+ *
+ * Producers count themselves in s_producers before they look at s_running
+ * and leave after signalling, so netint_log_shutdown() can wait for those
+ * already past the check before its final drain and destroying s_wake.
+ *
+ * The repeat limiter is approximate on purpose: buckets are picked by a hash
+ * of the format pointer and updated without a lock, so a racing window
+ * change can let a message through once more than NETINT_LOG_BURST.
+ */
+
+#include "netint-log.h"
+
+#include <util/base.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NETINT_LOG_SLOTS 256          /* Power of two */
+#define NETINT_LOG_LINE 512           /* Longer messages are cut */
+#define NETINT_LOG_LIMIT_BUCKETS 64
+#define NETINT_LOG_DRAIN_MS 50
+
+/* NI_LOG_* from ni_log.h */
+#define NETINT_NI_LOG_ERROR 2
+#define NETINT_NI_LOG_DEBUG 4
+
+struct netint_log_record {
+    volatile long seq;
+    int level;
+    char text[NETINT_LOG_LINE];
+};
+
+struct netint_log_limit {
+    volatile long key;                /**< Hash of the format pointer, 0 = unused */
+    volatile long second;             /**< Window the count belongs to */
+    volatile long count;
+    volatile long suppressed;         /**< Copies held back in earlier windows */
+};
+
+static struct netint_log_record s_records[NETINT_LOG_SLOTS];
+static struct netint_log_limit s_limits[NETINT_LOG_LIMIT_BUCKETS];
+static volatile long s_enqueue_pos;
+static long s_dequeue_pos;
+static volatile long s_dropped;
+static int s_max_level = LOG_INFO;
+static volatile bool s_running;
+static volatile long s_producers;     /* netint_log_emit() calls in progress */
+static volatile bool s_stop;
+static os_event_t *s_wake;
+static pthread_t s_thread;
+
+static long netint_log_seq_diff(long a, long b)
+{
+    return (long)((unsigned long)a - (unsigned long)b);
+}
+
+static long netint_log_seq_next(long seq, long step)
+{
+    return (long)((unsigned long)seq + (unsigned long)step);
+}
+
+bool netint_log_enabled(int level)
+{
+    return level <= s_max_level;
+}
+
+int netint_log_libxcoder_level(void)
+{
+    /* libxcoder's INFO and below only ever reach LOG_DEBUG */
+    return s_max_level >= LOG_DEBUG ? NETINT_NI_LOG_DEBUG : NETINT_NI_LOG_ERROR;
+}
+
+static uint32_t netint_log_hash(const char *format)
+{
+    uint64_t p = (uint64_t)(uintptr_t)format;
+    p ^= p >> 29;
+    p *= 0xbf58476d1ce4e5b9ULL;
+    p ^= p >> 32;
+    return (uint32_t)p;
+}
+
+/**
+ * @brief Count one use of @p format against its bucket
+ *
+ * @param suppressed Set to the copies held back since the message last got
+ *                   through, when this call starts a new window
+ * @param evicted Set to the copies another message held back, when this call
+ *                takes its bucket
+ * @return false if the message is over its burst for this second
+ */
+static bool netint_log_admit(const char *format, long *suppressed, long *evicted)
+{
+    uint32_t hash = netint_log_hash(format);
+    struct netint_log_limit *limit = &s_limits[hash % NETINT_LOG_LIMIT_BUCKETS];
+    long key = (long)(hash >> 1) | 1;
+    long second = (long)(os_gettime_ns() / 1000000000ULL);
+
+    *suppressed = 0;
+    *evicted = 0;
+    if (os_atomic_load_long(&limit->key) != key) {
+        /* Another message had the bucket, hand its pending count back unattributed */
+        os_atomic_set_long(&limit->key, key);
+        os_atomic_set_long(&limit->second, second);
+        os_atomic_set_long(&limit->count, 0);
+        *evicted = os_atomic_set_long(&limit->suppressed, 0);
+    } else {
+        long window = os_atomic_load_long(&limit->second);
+        if (window != second && os_atomic_compare_swap_long(&limit->second, window, second)) {
+            os_atomic_set_long(&limit->count, 0);
+            *suppressed = os_atomic_set_long(&limit->suppressed, 0);
+        }
+    }
+
+    if (os_atomic_inc_long(&limit->count) <= NETINT_LOG_BURST) {
+        return true;
+    }
+    os_atomic_inc_long(&limit->suppressed);
+    return false;
+}
+
+static void netint_log_format(char *text, size_t size, const char *prefix, const char *format, va_list args)
+{
+    size_t len = 0;
+    if (prefix) {
+        int n = snprintf(text, size, "%s", prefix);
+        len = n > 0 ? ((size_t)n < size ? (size_t)n : size - 1) : 0;
+    }
+    vsnprintf(text + len, size - len, format, args);
+
+    /* blog() ends the line itself */
+    len = strlen(text);
+    if (len > 0 && text[len - 1] == '\n') {
+        text[len - 1] = '\0';
+    }
+}
+
+/**
+ * @brief Claim a free slot, or NULL if the ring is full
+ */
+static struct netint_log_record *netint_log_claim(long *pos_out)
+{
+    long pos = os_atomic_load_long(&s_enqueue_pos);
+    for (;;) {
+        struct netint_log_record *record = &s_records[(unsigned long)pos & (NETINT_LOG_SLOTS - 1)];
+        long diff = netint_log_seq_diff(os_atomic_load_long(&record->seq), pos);
+        if (diff == 0) {
+            if (os_atomic_compare_swap_long(&s_enqueue_pos, pos, netint_log_seq_next(pos, 1))) {
+                *pos_out = pos;
+                return record;
+            }
+            pos = os_atomic_load_long(&s_enqueue_pos);
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = os_atomic_load_long(&s_enqueue_pos);
+        }
+    }
+}
+
+static void netint_log_emit(int level, const char *prefix, const char *format, va_list args)
+{
+    os_atomic_inc_long(&s_producers);
+    if (!os_atomic_load_bool(&s_running)) {
+        char text[NETINT_LOG_LINE];
+        netint_log_format(text, sizeof(text), prefix, format, args);
+        blog(level, "%s", text);
+        goto done;
+    }
+
+    long pos;
+    struct netint_log_record *record = netint_log_claim(&pos);
+    if (!record) {
+        os_atomic_inc_long(&s_dropped);
+        goto done;
+    }
+    record->level = level;
+    netint_log_format(record->text, sizeof(record->text), prefix, format, args);
+    os_atomic_set_long(&record->seq, netint_log_seq_next(pos, 1));
+
+    if (level <= LOG_WARNING) {
+        os_event_signal(s_wake);
+    }
+
+done:
+    os_atomic_dec_long(&s_producers);
+}
+
+PRINTFATTR(2, 3) static void netint_log_emit_fmt(int level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    netint_log_emit(level, NULL, format, args);
+    va_end(args);
+}
+
+void netint_logva(int level, const char *prefix, const char *format, va_list args)
+{
+    if (!netint_log_enabled(level) || !format) {
+        return;
+    }
+
+    long suppressed;
+    long evicted;
+    bool admitted = netint_log_admit(format, &suppressed, &evicted);
+    if (evicted > 0) {
+        netint_log_emit_fmt(level, "[obs-netint-t4xx] %ld repeat(s) of an earlier message were suppressed", evicted);
+    }
+    if (!admitted) {
+        return;
+    }
+    if (suppressed > 0) {
+        netint_log_emit_fmt(level, "[obs-netint-t4xx] %ld repeat(s) of the next message were suppressed", suppressed);
+    }
+    netint_log_emit(level, prefix, format, args);
+}
+
+void netint_log(int level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    netint_logva(level, NULL, format, args);
+    va_end(args);
+}
+
+/* Drain thread only */
+static void netint_log_drain(void)
+{
+    for (;;) {
+        struct netint_log_record *record = &s_records[(unsigned long)s_dequeue_pos & (NETINT_LOG_SLOTS - 1)];
+        long seq = os_atomic_load_long(&record->seq);
+        if (netint_log_seq_diff(seq, netint_log_seq_next(s_dequeue_pos, 1)) != 0) {
+            break;
+        }
+        blog(record->level, "%s", record->text);
+        os_atomic_set_long(&record->seq, netint_log_seq_next(s_dequeue_pos, NETINT_LOG_SLOTS));
+        s_dequeue_pos = netint_log_seq_next(s_dequeue_pos, 1);
+    }
+
+    long dropped = os_atomic_set_long(&s_dropped, 0);
+    if (dropped > 0) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Log ring full, %ld message(s) dropped", dropped);
+    }
+}
+
+static void *netint_log_thread(void *param)
+{
+    UNUSED_PARAMETER(param);
+    os_set_thread_name("netint-log");
+
+    while (!os_atomic_load_bool(&s_stop)) {
+        os_event_timedwait(s_wake, NETINT_LOG_DRAIN_MS);
+        netint_log_drain();
+    }
+    netint_log_drain();
+    return NULL;
+}
+
+static int netint_log_parse_level(const char *value)
+{
+    if (!value || !*value) {
+        return LOG_INFO;
+    }
+    if (strcmp(value, "error") == 0) {
+        return LOG_ERROR;
+    }
+    if (strcmp(value, "warning") == 0) {
+        return LOG_WARNING;
+    }
+    if (strcmp(value, "debug") == 0) {
+        return LOG_DEBUG;
+    }
+    if (strcmp(value, "info") != 0) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Unknown NETINT_LOG_LEVEL '%s', using info", value);
+    }
+    return LOG_INFO;
+}
+
+void netint_log_init(void)
+{
+    if (os_atomic_load_bool(&s_running)) {
+        return;
+    }
+
+    s_max_level = netint_log_parse_level(getenv("NETINT_LOG_LEVEL"));
+
+    for (long i = 0; i < NETINT_LOG_SLOTS; i++) {
+        s_records[i].seq = i;
+    }
+    memset(s_limits, 0, sizeof(s_limits));
+    s_enqueue_pos = 0;
+    s_dequeue_pos = 0;
+    s_dropped = 0;
+    s_stop = false;
+
+    if (os_event_init(&s_wake, OS_EVENT_TYPE_AUTO) != 0) {
+        s_wake = NULL;
+        blog(LOG_WARNING, "[obs-netint-t4xx] Log thread unavailable, plugin messages are written synchronously");
+        return;
+    }
+    if (pthread_create(&s_thread, NULL, netint_log_thread, NULL) != 0) {
+        os_event_destroy(s_wake);
+        s_wake = NULL;
+        blog(LOG_WARNING, "[obs-netint-t4xx] Log thread unavailable, plugin messages are written synchronously");
+        return;
+    }
+    os_atomic_set_bool(&s_running, true);
+}
+
+void netint_log_shutdown(void)
+{
+    if (!os_atomic_load_bool(&s_running)) {
+        return;
+    }
+
+    /* Late messages go straight to blog() from here on; wait for those that
+     * were already on their way into the ring */
+    os_atomic_set_bool(&s_running, false);
+    while (os_atomic_load_long(&s_producers) > 0) {
+        os_sleep_ms(1);
+    }
+    os_atomic_set_bool(&s_stop, true);
+    os_event_signal(s_wake);
+    pthread_join(s_thread, NULL);
+    os_event_destroy(s_wake);
+    s_wake = NULL;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file netint-log.h
+ * @brief Level-filtered, asynchronous logging for libxcoder and the IO paths
+ *
+ * blog() formats, takes the OBS log mutex and writes the log file on the
+ * calling thread. That is fine for setup, but libxcoder logs from inside
+ * send/receive, and a card in trouble makes the IO threads report the same
+ * failure on every frame. netint_log() instead:
+ *
+ * - drops messages above the configured level before formatting them
+ *   (NETINT_LOG_LEVEL=error|warning|info|debug, default info; it also sets
+ *   libxcoder's own level so filtered messages are never produced)
+ * - lets each message (keyed by its format string) through at most
+ *   NETINT_LOG_BURST times a second, and reports how many copies it held
+ *   back the next time the message gets through
+ * - formats into a fixed-size record of a lock-free ring, which a background
+ *   thread hands to blog(). When the ring is full the record is dropped and
+ *   counted instead of blocking the caller.
+ *
+ * Errors and warnings wake the thread right away, everything else goes out
+ * within NETINT_LOG_DRAIN_MS. Before netint_log_init() and after
+ * netint_log_shutdown() messages are filtered and rate limited but written
+ * synchronously.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <util/c99defs.h>
+
+#define NETINT_LOG_BURST 10
+
+/**
+ * @brief Read NETINT_LOG_LEVEL and start the drain thread (first thing in obs_module_load)
+ */
+void netint_log_init(void);
+
+/**
+ * @brief Write out what is queued and stop the drain thread (last thing in obs_module_unload)
+ *
+ * Every other plugin thread must have stopped, and the library closed. A
+ * message racing the shutdown is still written: shutdown waits for callers
+ * already queueing before the final drain.
+ */
+void netint_log_shutdown(void);
+
+/**
+ * @brief true if messages of @p level (LOG_ERROR..LOG_DEBUG) pass the filter
+ *
+ * For callers that would do extra work just to build the arguments.
+ */
+bool netint_log_enabled(int level);
+
+/**
+ * @brief libxcoder level (NI_LOG_*) matching the configured OBS level
+ */
+int netint_log_libxcoder_level(void);
+
+/**
+ * @brief Queue a message, same arguments as blog()
+ */
+PRINTFATTR(2, 3) void netint_log(int level, const char *format, ...);
+
+/**
+ * @brief Queue a message from a va_list
+ *
+ * @param prefix Written before the message (e.g. "[libxcoder] "), or NULL
+ */
+void netint_logva(int level, const char *prefix, const char *format, va_list args);
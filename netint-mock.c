@@ -0,0 +1,945 @@
+/**
+ * @file netint-mock.c
+ * @brief Built-in stand-in for libxcoder, for running without a T4XX card
+ *
+ * See netint-mock.h. A session is one netint_mock_session, installed as the
+ * encoder context's p_session_ctx. Frames are held back per mini-GOP like the
+ * card's look-ahead, then queued in decode order with the time they become
+ * "ready"; encode_receive hands out the queue head once that time has passed.
+ *
+ * Like libxcoder, a session is only used from one thread at a time (create,
+ * then the IO thread, then destroy), so only the per-device session counts
+ * are shared.
+ */
+
+#include "netint-mock.h"
+#include "netint-libxcoder.h"
+
+#include <obs-module.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NETINT_MOCK_MAX_DEVICES 8
+#define NETINT_MOCK_MAX_MINI_GOP 8
+#define NETINT_MOCK_MAX_QUEUE 64     /**< Frames the mock card holds, like its input slots */
+#define NETINT_MOCK_PTS_HISTORY 128  /**< Input PTS kept for DTS generation (> queue + mini-GOP) */
+#define NETINT_MOCK_SESSION_LOAD 25  /**< Load in percent reported per open session */
+#define NETINT_MOCK_MIN_FRAME_BYTES 64
+
+#define NETINT_MOCK_ALIGN(x, a) (((x) + (a) - 1) / (a) * (a))
+
+static struct {
+    uint64_t latency_ns;
+    uint64_t jitter_ns;
+    uint64_t frame_bytes;            /**< 0 = derive from bitrate and fps */
+    int idr_scale;
+    long fail_send_every;
+    long hang_after;
+    bool fail_open;
+    int devices;
+} s_mock;
+
+static volatile long s_mock_device_sessions[NETINT_MOCK_MAX_DEVICES];
+static volatile bool s_mock_hang_used;
+
+/**
+ * @brief Settings written through encoder_params_set_value (p_encoder_params)
+ */
+struct netint_mock_params {
+    int intra_period;
+    int gop_preset;
+};
+
+struct netint_mock_frame {
+    int64_t pts;
+    int64_t dts;
+    uint64_t ready_ns;
+    uint32_t frame_type;             /**< NI_LOGAN_FRAME_TYPE_* */
+    size_t size;
+};
+
+struct netint_mock_session {
+    struct netint_mock_params params;
+    uint64_t input_fifo;             /**< Only its address is used, as enc.input_data_fifo */
+    ni_logan_session_data_io_t input_fme;
+
+    bool opened;
+    int device;
+    int codec_format;
+    uint32_t fps_num;
+    uint32_t fps_den;
+    uint64_t frame_bytes;
+    int mini_gop;
+    uint32_t rng;
+
+    long sends;
+    long gop_pos;                    /**< Frames since the last I-frame, including it */
+
+    /* Frames of the current mini-GOP, in display order */
+    struct netint_mock_frame held[NETINT_MOCK_MAX_MINI_GOP];
+    int held_count;
+
+    /* Frames in decode order, waiting for their ready time */
+    struct netint_mock_frame queue[NETINT_MOCK_MAX_QUEUE];
+    int queue_head;
+    int queue_count;
+
+    int64_t pts_history[NETINT_MOCK_PTS_HISTORY];
+    long frames_in;
+    long frames_out;
+
+    bool eos_pending;
+    bool hung;                       /**< Stopped producing packets (NETINT_MOCK_HANG_AFTER) */
+    bool headers_sent;
+    uint8_t *header;
+    int header_len;
+};
+
+static long netint_mock_env_long(const char *name, long default_value)
+{
+    const char *value = getenv(name);
+    if (!value || !*value) {
+        return default_value;
+    }
+
+    char *end = NULL;
+    long parsed = strtol(value, &end, 10);
+    return (end == value || parsed < 0) ? default_value : parsed;
+}
+
+static uint32_t netint_mock_rand(struct netint_mock_session *s)
+{
+    uint32_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->rng = x;
+    return x;
+}
+
+/* Mini-GOP length of each Logan GOP preset; presets without reordering map to 1 */
+static int netint_mock_mini_gop(int gop_preset)
+{
+    switch (gop_preset) {
+    case 4:
+        return 2;  /* IBPBP */
+    case 5:
+        return 4;  /* IBBBP */
+    case 8:
+        return 8;  /* IBBBBBBBB */
+    default:
+        return 1;
+    }
+}
+
+static void netint_mock_update_frame_bytes(struct netint_mock_session *s, int64_t bit_rate)
+{
+    if (s_mock.frame_bytes > 0) {
+        s->frame_bytes = s_mock.frame_bytes;
+        return;
+    }
+
+    uint64_t bytes = bit_rate > 0 ? (uint64_t)bit_rate / 8 * s->fps_den / s->fps_num : 0;
+    s->frame_bytes = bytes > NETINT_MOCK_MIN_FRAME_BYTES ? bytes : NETINT_MOCK_MIN_FRAME_BYTES;
+}
+
+static int netint_mock_find_device(const char *name)
+{
+    char device[NI_LOGAN_MAX_DEVICE_NAME_LEN];
+
+    for (int i = 0; name && i < s_mock.devices; i++) {
+        snprintf(device, sizeof(device), "/dev/netint-mock%d", i);
+        if (strcmp(device, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ---------------------------------------------------------------------------
+ * Bitstream
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Write one NAL unit: start code, header bytes, then filler up to @p size
+ *
+ * The filler never contains zero bytes, so it can't fake a start code.
+ */
+static size_t netint_mock_put_nal(uint8_t *dst, size_t size, const uint8_t *nal_header, size_t header_len)
+{
+    static const uint8_t start_code[4] = {0, 0, 0, 1};
+    size_t min_size = sizeof(start_code) + header_len;
+
+    if (size < min_size) {
+        size = min_size;
+    }
+    memcpy(dst, start_code, sizeof(start_code));
+    memcpy(dst + sizeof(start_code), nal_header, header_len);
+    memset(dst + min_size, 0xA5, size - min_size);
+    return size;
+}
+
+static void netint_mock_build_header(struct netint_mock_session *s)
+{
+    uint8_t buf[128];
+    size_t len = 0;
+
+    if (s->header) {
+        return;
+    }
+
+    if (s->codec_format == NI_LOGAN_CODEC_FORMAT_H265) {
+        static const uint8_t vps[2] = {0x40, 0x01};
+        static const uint8_t sps[2] = {0x42, 0x01};
+        static const uint8_t pps[2] = {0x44, 0x01};
+        len += netint_mock_put_nal(buf + len, 24, vps, sizeof(vps));
+        len += netint_mock_put_nal(buf + len, 40, sps, sizeof(sps));
+        len += netint_mock_put_nal(buf + len, 12, pps, sizeof(pps));
+    } else {
+        static const uint8_t sps[1] = {0x67};
+        static const uint8_t pps[1] = {0x68};
+        len += netint_mock_put_nal(buf + len, 24, sps, sizeof(sps));
+        len += netint_mock_put_nal(buf + len, 8, pps, sizeof(pps));
+    }
+
+    s->header = bmemdup(buf, len);
+    s->header_len = (int)len;
+}
+
+static size_t netint_mock_put_picture(struct netint_mock_session *s, uint8_t *dst, size_t room,
+                                      const struct netint_mock_frame *frame)
+{
+    uint8_t nal_header[2];
+    size_t header_len;
+
+    if (s->codec_format == NI_LOGAN_CODEC_FORMAT_H265) {
+        /* IDR_W_RADL, TRAIL_R, TRAIL_N */
+        nal_header[0] = frame->frame_type == NI_LOGAN_FRAME_TYPE_I ? 0x26
+                        : frame->frame_type == NI_LOGAN_FRAME_TYPE_P ? 0x02 : 0x00;
+        nal_header[1] = 0x01;
+        header_len = 2;
+    } else {
+        /* IDR, non-IDR referenced, non-IDR not referenced */
+        nal_header[0] = frame->frame_type == NI_LOGAN_FRAME_TYPE_I ? 0x65
+                        : frame->frame_type == NI_LOGAN_FRAME_TYPE_P ? 0x41 : 0x01;
+        header_len = 1;
+    }
+
+    size_t size = frame->size < room ? frame->size : room;
+    return netint_mock_put_nal(dst, size, nal_header, header_len);
+}
+
+/* ---------------------------------------------------------------------------
+ * Frame scheduling
+ * ------------------------------------------------------------------------- */
+
+static bool netint_mock_queue_push(struct netint_mock_session *s, struct netint_mock_frame *frame)
+{
+    if (s->queue_count >= NETINT_MOCK_MAX_QUEUE) {
+        return false;
+    }
+
+    /* Encoded size, +-12.5% around the frame type's average */
+    uint64_t size = s->frame_bytes;
+    if (frame->frame_type == NI_LOGAN_FRAME_TYPE_I) {
+        size *= (uint64_t)s_mock.idr_scale;
+    } else if (frame->frame_type == NI_LOGAN_FRAME_TYPE_B) {
+        size /= 2;
+    }
+    uint64_t spread = size / 4;
+    if (spread > 0) {
+        size = size - spread / 2 + netint_mock_rand(s) % spread;
+    }
+    frame->size = size > NETINT_MOCK_MIN_FRAME_BYTES ? (size_t)size : NETINT_MOCK_MIN_FRAME_BYTES;
+
+    /* Like the card: decode order runs mini_gop - 1 frames behind display
+     * order, and DTS is the input PTS that many frames earlier */
+    long delay = s->mini_gop - 1;
+    long k = s->frames_out++;
+    frame->dts = k < delay ? s->pts_history[0] - (delay - k)
+                           : s->pts_history[(k - delay) % NETINT_MOCK_PTS_HISTORY];
+
+    int tail = (s->queue_head + s->queue_count) % NETINT_MOCK_MAX_QUEUE;
+    s->queue[tail] = *frame;
+    s->queue_count++;
+    return true;
+}
+
+/* The last held frame becomes the mini-GOP's P-frame and goes first */
+static bool netint_mock_flush_held(struct netint_mock_session *s)
+{
+    bool ok = true;
+
+    if (s->held_count == 0) {
+        return true;
+    }
+
+    s->held[s->held_count - 1].frame_type = NI_LOGAN_FRAME_TYPE_P;
+    ok = netint_mock_queue_push(s, &s->held[s->held_count - 1]);
+    for (int i = 0; i < s->held_count - 1; i++) {
+        s->held[i].frame_type = NI_LOGAN_FRAME_TYPE_B;
+        ok = netint_mock_queue_push(s, &s->held[i]) && ok;
+    }
+    s->held_count = 0;
+    return ok;
+}
+
+/* ---------------------------------------------------------------------------
+ * Encode API
+ * ------------------------------------------------------------------------- */
+
+static int netint_mock_encode_init(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = bzalloc(sizeof(*s));
+    s->rng = ((uint32_t)(uintptr_t)s ^ 0x9E3779B9u) | 1;
+    s->device = -1;
+
+    enc->p_session_ctx = s;
+    enc->p_encoder_params = &s->params;
+    enc->input_data_fifo = (ni_logan_fifo_buffer_t *)&s->input_fifo;
+    enc->p_input_fme = NULL;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_params_parse(ni_logan_enc_context_t *enc)
+{
+    return enc->p_session_ctx ? NI_LOGAN_RETCODE_SUCCESS : NI_LOGAN_RETCODE_INVALID_PARAM;
+}
+
+static int netint_mock_packet_buffer_alloc(ni_logan_packet_t *pkt, int size)
+{
+    if (!pkt || size <= 0) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+
+    bfree(pkt->p_buffer);
+    pkt->p_buffer = bmalloc((size_t)size);
+    pkt->p_data = pkt->p_buffer;
+    pkt->buffer_size = (uint32_t)size;
+    pkt->data_len = 0;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_packet_buffer_free(ni_logan_packet_t *pkt)
+{
+    if (!pkt) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+
+    bfree(pkt->p_buffer);
+    pkt->p_buffer = NULL;
+    pkt->p_data = NULL;
+    pkt->buffer_size = 0;
+    pkt->data_len = 0;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_open(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+    if (s_mock.fail_open) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [MOCK] Failing encode_open (NETINT_MOCK_FAIL_OPEN)");
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    int device = netint_mock_find_device(enc->dev_enc_name);
+    s->device = device >= 0 ? device : 0;
+    s->codec_format = enc->codec_format;
+    s->fps_num = enc->fps_number > 0 ? (uint32_t)enc->fps_number : 30;
+    s->fps_den = enc->fps_denominator > 0 ? (uint32_t)enc->fps_denominator : 1;
+    s->mini_gop = netint_mock_mini_gop(s->params.gop_preset);
+    netint_mock_update_frame_bytes(s, enc->bit_rate);
+
+    if (netint_mock_packet_buffer_alloc(&enc->output_pkt.data.packet, NI_LOGAN_MAX_TX_SZ) != NI_LOGAN_RETCODE_SUCCESS) {
+        return NI_LOGAN_RETCODE_ERROR_MEM_ALOC;
+    }
+
+    os_atomic_inc_long(&s_mock_device_sessions[s->device]);
+    s->opened = true;
+
+    blog(LOG_INFO, "[obs-netint-t4xx] [MOCK] Session opened on /dev/netint-mock%d: %dx%d %s, mini-GOP %d, "
+                   "intraPeriod %d, ~%llu bytes/frame, latency %llu+%llu ms",
+         s->device, enc->width, enc->height, s->codec_format == NI_LOGAN_CODEC_FORMAT_H265 ? "H.265" : "H.264",
+         s->mini_gop, s->params.intra_period, (unsigned long long)s->frame_bytes,
+         (unsigned long long)(s_mock.latency_ns / 1000000), (unsigned long long)(s_mock.jitter_ns / 1000000));
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_close(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s) {
+        return NI_LOGAN_RETCODE_SUCCESS;
+    }
+
+    if (s->opened) {
+        os_atomic_dec_long(&s_mock_device_sessions[s->device]);
+    }
+    if (enc->output_pkt.data.packet.p_buffer) {
+        netint_mock_packet_buffer_free(&enc->output_pkt.data.packet);
+    }
+    if (enc->p_spsPpsHdr == s->header) {
+        enc->p_spsPpsHdr = NULL;
+        enc->spsPpsHdrLen = 0;
+    }
+    bfree(s->header);
+    bfree(s);
+
+    enc->p_session_ctx = NULL;
+    enc->p_encoder_params = NULL;
+    enc->input_data_fifo = NULL;
+    enc->p_input_fme = NULL;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_header(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s || !s->opened) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    netint_mock_build_header(s);
+    enc->p_spsPpsHdr = s->header;
+    enc->spsPpsHdrLen = s->header_len;
+    enc->spsPpsArrived = 1;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_get_frame(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s || !s->opened) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    enc->p_input_fme = &s->input_fme;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encode_send(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s || !s->opened) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    const ni_logan_frame_t *input = &s->input_fme.data.frame;
+    if (input->end_of_stream) {
+        netint_mock_flush_held(s);
+        s->eos_pending = true;
+        if (s->queue_count == 0) {
+            enc->encoder_eof = 1;
+        }
+        return NI_LOGAN_RETCODE_SUCCESS;
+    }
+
+    s->sends++;
+    if (s_mock.fail_send_every > 0 && s->sends % s_mock.fail_send_every == 0) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [MOCK] Failing encode_send %ld (NETINT_MOCK_FAIL_SEND_EVERY)", s->sends);
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    struct netint_mock_frame frame = {0};
+    frame.pts = input->pts;
+    frame.ready_ns = os_gettime_ns() + s_mock.latency_ns;
+    if (s_mock.jitter_ns > 0) {
+        frame.ready_ns += netint_mock_rand(s) % (s_mock.jitter_ns + 1);
+    }
+    s->pts_history[s->frames_in++ % NETINT_MOCK_PTS_HISTORY] = frame.pts;
+
+    bool idr = s->frames_in == 1 || input->start_of_stream || input->force_key_frame ||
+               input->ni_logan_pict_type == LOGAN_PIC_TYPE_IDR ||
+               (s->params.intra_period > 0 && s->gop_pos >= s->params.intra_period);
+
+    bool ok;
+    if (idr) {
+        /* An IDR closes the open mini-GOP early */
+        ok = netint_mock_flush_held(s);
+        frame.frame_type = NI_LOGAN_FRAME_TYPE_I;
+        ok = netint_mock_queue_push(s, &frame) && ok;
+        s->gop_pos = 1;
+    } else {
+        s->held[s->held_count++] = frame;
+        s->gop_pos++;
+        ok = s->held_count < s->mini_gop ? true : netint_mock_flush_held(s);
+    }
+
+    if (!ok) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [MOCK] Card queue full (%d frames), frame dropped", NETINT_MOCK_MAX_QUEUE);
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+/**
+ * @brief Hand out the next packet once it is ready
+ *
+ * Fills output_pkt like libxcoder: metadata header, then the bitstream.
+ * @return Bitstream bytes (without metadata), 0 if nothing is ready
+ */
+static int netint_mock_encode_receive(ni_logan_enc_context_t *enc)
+{
+    struct netint_mock_session *s = enc->p_session_ctx;
+    if (!s || !s->opened) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+    if (s->queue_count == 0 || s->hung) {
+        return 0;
+    }
+    if (s_mock.hang_after > 0 && s->frames_out >= s_mock.hang_after && !os_atomic_set_bool(&s_mock_hang_used, true)) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] [MOCK] Card stops answering after %ld packets (NETINT_MOCK_HANG_AFTER)",
+             s->frames_out);
+        s->hung = true;
+        return 0;
+    }
+
+    const struct netint_mock_frame *frame = &s->queue[s->queue_head];
+    if (os_gettime_ns() < frame->ready_ns) {
+        return 0;
+    }
+
+    ni_logan_packet_t *pkt = &enc->output_pkt.data.packet;
+    const size_t meta_size = NI_LOGAN_FW_ENC_BITSTREAM_META_DATA_SIZE;
+    if (!pkt->p_data || pkt->buffer_size < meta_size + NETINT_MOCK_MIN_FRAME_BYTES + 256) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    uint8_t *out = (uint8_t *)pkt->p_data + meta_size;
+    size_t room = pkt->buffer_size - meta_size;
+    size_t len = 0;
+
+    /* The card doesn't cut a picture to fit: it overruns the buffer, or
+     * libxcoder reallocates it. Fail loudly so an undersized output buffer
+     * shows up here instead of only on hardware. */
+    if (!s->headers_sent) {
+        netint_mock_build_header(s);
+    }
+    size_t needed = (s->headers_sent ? 0 : (size_t)s->header_len) + frame->size;
+    if (needed > room) {
+        blog(LOG_ERROR, "[obs-netint-t4xx] [MOCK] %zu-byte packet does not fit the %zu-byte output buffer, "
+                        "a card would overrun it; frame dropped",
+             needed, room);
+        s->queue_head = (s->queue_head + 1) % NETINT_MOCK_MAX_QUEUE;
+        s->queue_count--;
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    /* The stream's first packet carries the parameter sets, like the card's */
+    if (!s->headers_sent) {
+        memcpy(out, s->header, (size_t)s->header_len);
+        len = (size_t)s->header_len;
+        s->headers_sent = true;
+    }
+    len += netint_mock_put_picture(s, out + len, room - len, frame);
+
+    memset(pkt->p_data, 0, meta_size);
+    pkt->pts = frame->pts;
+    pkt->dts = frame->dts;
+    pkt->frame_type = frame->frame_type;
+    pkt->video_width = (uint32_t)enc->width;
+    pkt->video_height = (uint32_t)enc->height;
+    pkt->data_len = (uint32_t)(meta_size + len);
+    pkt->avg_frame_qp = 30;
+    pkt->p_all_custom_sei = NULL;
+    pkt->len_of_sei_after_vcl = 0;
+
+    s->queue_head = (s->queue_head + 1) % NETINT_MOCK_MAX_QUEUE;
+    s->queue_count--;
+    pkt->end_of_stream = (s->eos_pending && s->queue_count == 0) ? 1 : 0;
+
+    enc->latest_dts = pkt->dts;
+    enc->total_frames_received++;
+    return (int)len;
+}
+
+static int netint_mock_encode_copy_packet_data(ni_logan_enc_context_t *enc, uint8_t *dst, int first_packet,
+                                               int sps_pps_attach)
+{
+    const ni_logan_packet_t *pkt = &enc->output_pkt.data.packet;
+    const size_t meta_size = NI_LOGAN_FW_ENC_BITSTREAM_META_DATA_SIZE;
+    size_t offset = 0;
+
+    (void)first_packet;
+    if (!dst || !pkt->p_data || pkt->data_len < meta_size) {
+        return NI_LOGAN_RETCODE_FAILURE;
+    }
+
+    if (sps_pps_attach && enc->p_spsPpsHdr && enc->spsPpsHdrLen > 0) {
+        memcpy(dst, enc->p_spsPpsHdr, (size_t)enc->spsPpsHdrLen);
+        offset = (size_t)enc->spsPpsHdrLen;
+    }
+    memcpy(dst + offset, (const uint8_t *)pkt->p_data + meta_size, pkt->data_len - meta_size);
+    return (int)(offset + pkt->data_len - meta_size);
+}
+
+static void netint_mock_encode_reconfig_vfr(ni_logan_enc_context_t *enc, ni_logan_frame_t *frame, int64_t pts)
+{
+    (void)enc;
+    (void)frame;
+    (void)pts;
+}
+
+/* Not used by the plugin, which uploads into the frame buffer itself */
+static int netint_mock_encode_copy_frame_data(ni_logan_enc_context_t *enc, ni_logan_frame_t *frame,
+                                              uint8_t *data[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                              int linesize[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    (void)enc;
+    (void)frame;
+    (void)data;
+    (void)linesize;
+    return NI_LOGAN_RETCODE_FAILURE;
+}
+
+/* ---------------------------------------------------------------------------
+ * Frame buffers
+ * ------------------------------------------------------------------------- */
+
+static void netint_mock_get_hw_yuv420p_dim(int width, int height, int factor, int is_h264,
+                                           int plane_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                           int plane_height[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    memset(plane_stride, 0, sizeof(int) * NI_LOGAN_MAX_NUM_DATA_POINTERS);
+    memset(plane_height, 0, sizeof(int) * NI_LOGAN_MAX_NUM_DATA_POINTERS);
+
+    int height_aligned = is_h264 ? NETINT_MOCK_ALIGN(height, 16) : NETINT_MOCK_ALIGN(height, 8);
+    plane_stride[0] = NETINT_MOCK_ALIGN(width * factor, 32);
+    plane_stride[1] = NETINT_MOCK_ALIGN((width + 1) / 2 * factor, 32);
+    plane_stride[2] = plane_stride[1];
+    plane_height[0] = height_aligned;
+    plane_height[1] = height_aligned / 2;
+    plane_height[2] = height_aligned / 2;
+}
+
+static int netint_mock_encoder_frame_buffer_alloc(ni_logan_frame_t *frame, int video_width, int video_height,
+                                                  int linesize[NI_LOGAN_MAX_NUM_DATA_POINTERS], int alignment,
+                                                  int extra_len, int factor)
+{
+    (void)factor;
+    if (!frame || video_width <= 0 || video_height <= 0 || extra_len < 0) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+
+    /* Same layout as get_hw_yuv420p_dim: alignment is the H.264 flag */
+    int height_aligned = alignment ? NETINT_MOCK_ALIGN(video_height, 16) : NETINT_MOCK_ALIGN(video_height, 8);
+    size_t luma = (size_t)linesize[0] * (size_t)height_aligned;
+    size_t chroma_u = (size_t)linesize[1] * (size_t)(height_aligned / 2);
+    size_t chroma_v = (size_t)linesize[2] * (size_t)(height_aligned / 2);
+    size_t size = luma + chroma_u + chroma_v + (size_t)extra_len;
+
+    uint8_t *buffer = bzalloc(size);
+
+    frame->p_buffer = buffer;
+    frame->buffer_size = (uint32_t)size;
+    frame->p_data[0] = buffer;
+    frame->p_data[1] = buffer + luma;
+    frame->p_data[2] = buffer + luma + chroma_u;
+    frame->p_data[3] = NULL;
+    frame->data_len[0] = (uint32_t)luma;
+    frame->data_len[1] = (uint32_t)chroma_u;
+    frame->data_len[2] = (uint32_t)chroma_v;
+    frame->data_len[3] = 0;
+    frame->video_width = (uint32_t)video_width;
+    frame->video_height = (uint32_t)video_height;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_frame_buffer_free(ni_logan_frame_t *frame)
+{
+    if (!frame) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+
+    bfree(frame->p_buffer);
+    frame->p_buffer = NULL;
+    frame->buffer_size = 0;
+    memset(frame->p_data, 0, sizeof(frame->p_data));
+    memset(frame->data_len, 0, sizeof(frame->data_len));
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+/* Row-by-row copy with zeroed padding, like the vendor copy */
+static void netint_mock_copy_hw_yuv420p(uint8_t *dst[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                        uint8_t *src[NI_LOGAN_MAX_NUM_DATA_POINTERS], int width, int height,
+                                        int factor, int dst_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                        int dst_height[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                        int src_stride[NI_LOGAN_MAX_NUM_DATA_POINTERS],
+                                        int src_height[NI_LOGAN_MAX_NUM_DATA_POINTERS])
+{
+    for (int plane = 0; plane < 3; plane++) {
+        if (!dst[plane] || !src[plane]) {
+            continue;
+        }
+
+        int row_bytes = (plane ? (width + 1) / 2 : width) * factor;
+        int rows = plane ? (height + 1) / 2 : height;
+        if (row_bytes > dst_stride[plane]) {
+            row_bytes = dst_stride[plane];
+        }
+        if (rows > src_height[plane]) {
+            rows = src_height[plane];
+        }
+
+        for (int y = 0; y < rows; y++) {
+            uint8_t *d = dst[plane] + (size_t)y * (size_t)dst_stride[plane];
+            memcpy(d, src[plane] + (size_t)y * (size_t)src_stride[plane], (size_t)row_bytes);
+            memset(d + row_bytes, 0, (size_t)(dst_stride[plane] - row_bytes));
+        }
+        for (int y = rows; y < dst_height[plane]; y++) {
+            memset(dst[plane] + (size_t)y * (size_t)dst_stride[plane], 0, (size_t)dst_stride[plane]);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Device session API (not used by the plugin)
+ * ------------------------------------------------------------------------- */
+
+static void netint_mock_device_session_context_init(ni_logan_session_context_t *session)
+{
+    (void)session;
+}
+
+static int netint_mock_device_session_open(ni_logan_session_context_t *session, int device_type)
+{
+    (void)session;
+    (void)device_type;
+    return NI_LOGAN_RETCODE_FAILURE;
+}
+
+static int netint_mock_device_session_close(ni_logan_session_context_t *session, int eos_received, int device_type)
+{
+    (void)session;
+    (void)eos_received;
+    (void)device_type;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_device_session_io(ni_logan_session_context_t *session, ni_logan_session_data_io_t *data,
+                                         int device_type)
+{
+    (void)session;
+    (void)data;
+    (void)device_type;
+    return NI_LOGAN_RETCODE_FAILURE;
+}
+
+/* ---------------------------------------------------------------------------
+ * Parameters and auxiliary data
+ * ------------------------------------------------------------------------- */
+
+static int netint_mock_encoder_init_default_params(ni_logan_encoder_params_t *params, int fps_num, int fps_den,
+                                                   long bit_rate, int width, int height)
+{
+    (void)fps_num;
+    (void)fps_den;
+    (void)bit_rate;
+    (void)width;
+    (void)height;
+    return params ? NI_LOGAN_RETCODE_SUCCESS : NI_LOGAN_RETCODE_INVALID_PARAM;
+}
+
+static int netint_mock_encoder_params_set_value(ni_logan_encoder_params_t *params, const char *name,
+                                                const char *value, ni_logan_session_context_t *session)
+{
+    struct netint_mock_params *p = (struct netint_mock_params *)params;
+
+    (void)session;
+    if (!p || !name || !value) {
+        return NI_LOGAN_RETCODE_INVALID_PARAM;
+    }
+
+    if (strcmp(name, NI_LOGAN_ENC_PARAM_INTRA_PERIOD) == 0) {
+        p->intra_period = atoi(value);
+    } else if (strcmp(name, NI_LOGAN_ENC_PARAM_GOP_PRESET_IDX) == 0) {
+        p->gop_preset = atoi(value);
+    }
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_encoder_gop_params_set_value(ni_logan_encoder_params_t *params, const char *name,
+                                                    const char *value, void *session)
+{
+    (void)name;
+    (void)value;
+    (void)session;
+    return params ? NI_LOGAN_RETCODE_SUCCESS : NI_LOGAN_RETCODE_INVALID_PARAM;
+}
+
+static void netint_mock_set_vui(ni_logan_encoder_params_t *params, ni_logan_session_context_t *session,
+                                ni_color_primaries_t primaries, ni_color_transfer_characteristic_t trc,
+                                ni_color_space_t space, int full_range, int sar_num, int sar_den,
+                                ni_logan_codec_format_t codec)
+{
+    (void)params;
+    (void)session;
+    (void)primaries;
+    (void)trc;
+    (void)space;
+    (void)full_range;
+    (void)sar_num;
+    (void)sar_den;
+    (void)codec;
+}
+
+/* ROI maps are accepted and ignored; bitrate changes resize later packets */
+static void netint_mock_enc_prep_aux_data(ni_logan_session_context_t *session, ni_logan_frame_t *dst,
+                                          ni_logan_frame_t *src, ni_logan_codec_format_t codec,
+                                          int should_send_sei_with_frame, uint8_t *mdcv_data, uint8_t *cll_data,
+                                          uint8_t *cc_data, uint8_t *udu_data, uint8_t *hdrp_data)
+{
+    struct netint_mock_session *s = (struct netint_mock_session *)session;
+
+    (void)dst;
+    (void)codec;
+    (void)should_send_sei_with_frame;
+    (void)mdcv_data;
+    (void)cll_data;
+    (void)cc_data;
+    (void)udu_data;
+    (void)hdrp_data;
+    if (!s || !src) {
+        return;
+    }
+
+    for (int i = 0; i < src->nb_aux_data && i < NI_MAX_NUM_AUX_DATA_PER_FRAME; i++) {
+        const ni_aux_data_t *aux = src->aux_data[i];
+        if (aux && aux->type == NI_FRAME_AUX_DATA_BITRATE && aux->size >= (int)sizeof(int32_t)) {
+            int32_t bit_rate;
+            memcpy(&bit_rate, aux->data, sizeof(bit_rate));
+            netint_mock_update_frame_bytes(s, bit_rate);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Resource manager
+ * ------------------------------------------------------------------------- */
+
+static int netint_mock_rsrc_init(int should_match_rev, int timeout_seconds)
+{
+    (void)should_match_rev;
+    (void)timeout_seconds;
+    return NI_LOGAN_RETCODE_SUCCESS;
+}
+
+static int netint_mock_rsrc_get_local_device_list(char devices[][NI_LOGAN_MAX_DEVICE_NAME_LEN], int max_handles)
+{
+    int count = s_mock.devices < max_handles ? s_mock.devices : max_handles;
+    for (int i = 0; i < count; i++) {
+        snprintf(devices[i], NI_LOGAN_MAX_DEVICE_NAME_LEN, "/dev/netint-mock%d", i);
+    }
+    return count;
+}
+
+static int netint_mock_rsrc_get_device_by_block_name(const char *blk_name, ni_logan_device_type_t device_type)
+{
+    (void)device_type;
+    return netint_mock_find_device(blk_name);
+}
+
+/* Allocated with calloc(): callers release the record with free() */
+static ni_logan_device_info_t *netint_mock_rsrc_get_device_info(ni_logan_device_type_t device_type, int guid)
+{
+    (void)device_type;
+    if (guid < 0 || guid >= s_mock.devices) {
+        return NULL;
+    }
+
+    ni_logan_device_info_t *info = calloc(1, sizeof(*info));
+    if (!info) {
+        return NULL;
+    }
+
+    snprintf(info->dev_name, sizeof(info->dev_name), "/dev/netint-mock%d", guid);
+    snprintf(info->blk_name, sizeof(info->blk_name), "/dev/netint-mock%d", guid);
+    info->hw_id = guid;
+    info->module_id = guid;
+    long load = os_atomic_load_long(&s_mock_device_sessions[guid]) * NETINT_MOCK_SESSION_LOAD;
+    info->load = load < 100 ? (int)load : 100;
+    info->model_load = info->load;
+    return info;
+}
+
+/* ---------------------------------------------------------------------------
+ * Installation
+ * ------------------------------------------------------------------------- */
+
+bool netint_mock_requested(void)
+{
+    const char *value = getenv("NETINT_MOCK");
+    return value && *value && strcmp(value, "0") != 0;
+}
+
+void netint_mock_install(void)
+{
+    s_mock.latency_ns = (uint64_t)netint_mock_env_long("NETINT_MOCK_LATENCY_MS", 16) * 1000000ULL;
+    s_mock.jitter_ns = (uint64_t)netint_mock_env_long("NETINT_MOCK_JITTER_MS", 0) * 1000000ULL;
+    s_mock.frame_bytes = (uint64_t)netint_mock_env_long("NETINT_MOCK_FRAME_BYTES", 0);
+    s_mock.idr_scale = (int)netint_mock_env_long("NETINT_MOCK_IDR_SCALE", 4);
+    s_mock.fail_send_every = netint_mock_env_long("NETINT_MOCK_FAIL_SEND_EVERY", 0);
+    s_mock.fail_open = netint_mock_env_long("NETINT_MOCK_FAIL_OPEN", 0) != 0;
+    s_mock.hang_after = netint_mock_env_long("NETINT_MOCK_HANG_AFTER", 0);
+    s_mock.devices = (int)netint_mock_env_long("NETINT_MOCK_DEVICES", 1);
+    if (s_mock.idr_scale < 1) {
+        s_mock.idr_scale = 1;
+    }
+    if (s_mock.devices < 1) {
+        s_mock.devices = 1;
+    }
+    if (s_mock.devices > NETINT_MOCK_MAX_DEVICES) {
+        s_mock.devices = NETINT_MOCK_MAX_DEVICES;
+    }
+    /* Packets must fit the output buffer next to the headers */
+    if (s_mock.frame_bytes * (uint64_t)s_mock.idr_scale > NI_LOGAN_MAX_TX_SZ / 2) {
+        s_mock.frame_bytes = NI_LOGAN_MAX_TX_SZ / 2 / (uint64_t)s_mock.idr_scale;
+    }
+
+    p_ni_logan_encode_init = netint_mock_encode_init;
+    p_ni_logan_encode_params_parse = netint_mock_encode_params_parse;
+    p_ni_logan_encode_open = netint_mock_encode_open;
+    p_ni_logan_encode_close = netint_mock_encode_close;
+    p_ni_logan_encode_header = netint_mock_encode_header;
+    p_ni_logan_encode_get_frame = netint_mock_encode_get_frame;
+    p_ni_logan_encode_reconfig_vfr = netint_mock_encode_reconfig_vfr;
+    p_ni_logan_encode_copy_frame_data = netint_mock_encode_copy_frame_data;
+    p_ni_logan_encode_send = netint_mock_encode_send;
+    p_ni_logan_encode_copy_packet_data = netint_mock_encode_copy_packet_data;
+    p_ni_logan_encode_receive = netint_mock_encode_receive;
+
+    p_ni_logan_encoder_frame_buffer_alloc = netint_mock_encoder_frame_buffer_alloc;
+    p_ni_logan_frame_buffer_free = netint_mock_frame_buffer_free;
+    p_ni_logan_copy_hw_yuv420p = netint_mock_copy_hw_yuv420p;
+    p_ni_logan_get_hw_yuv420p_dim = netint_mock_get_hw_yuv420p_dim;
+    p_ni_logan_packet_buffer_alloc = netint_mock_packet_buffer_alloc;
+    p_ni_logan_packet_buffer_free = netint_mock_packet_buffer_free;
+    p_ni_logan_encoder_init_default_params = netint_mock_encoder_init_default_params;
+
+    p_ni_logan_device_session_context_init = netint_mock_device_session_context_init;
+    p_ni_logan_device_session_open = netint_mock_device_session_open;
+    p_ni_logan_device_session_close = netint_mock_device_session_close;
+    p_ni_logan_device_session_write = netint_mock_device_session_io;
+    p_ni_logan_device_session_read = netint_mock_device_session_io;
+
+    p_ni_logan_rsrc_init = netint_mock_rsrc_init;
+    p_ni_logan_rsrc_get_local_device_list = netint_mock_rsrc_get_local_device_list;
+    p_ni_logan_rsrc_get_device_by_block_name = netint_mock_rsrc_get_device_by_block_name;
+    p_ni_logan_rsrc_get_device_info = netint_mock_rsrc_get_device_info;
+
+    p_ni_logan_encoder_params_set_value = netint_mock_encoder_params_set_value;
+    p_ni_logan_encoder_gop_params_set_value = netint_mock_encoder_gop_params_set_value;
+    p_ni_logan_set_vui = netint_mock_set_vui;
+    p_ni_logan_enc_prep_aux_data = netint_mock_enc_prep_aux_data;
+
+    blog(LOG_WARNING, "[obs-netint-t4xx] NETINT_MOCK set: using the built-in mock libxcoder backend "
+                      "(%d device(s), latency %ld+%ld ms, no real encoding)",
+         s_mock.devices, (long)(s_mock.latency_ns / 1000000), (long)(s_mock.jitter_ns / 1000000));
+}
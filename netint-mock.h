@@ -0,0 +1,40 @@
+/**
+ * @file netint-mock.h
+ * @brief Built-in stand-in for libxcoder, for running without a T4XX card
+ *
+ * With NETINT_MOCK=1 in the environment, ni_libxcoder_open() installs this
+ * backend into the p_ni_logan_* pointers instead of loading the vendor
+ * library. The whole host pipeline then runs as usual (frame jobs, upload
+ * kernels, packet pools, rings, device placement), which makes it possible to
+ * profile and regression-test it on machines without the hardware.
+ *
+ * The mock "card" emits Annex-B packets made of real NAL headers and filler
+ * bytes, in decode order, with B-frame reordering that follows gopPresetIdx,
+ * IDRs every intraPeriod frames and timestamps like the hardware's. The
+ * bitstream is not decodable.
+ *
+ * Tuning (environment, read once when the backend is installed):
+ * - NETINT_MOCK_LATENCY_MS: send-to-packet latency (default 16)
+ * - NETINT_MOCK_JITTER_MS: extra random latency, 0..value (default 0)
+ * - NETINT_MOCK_FRAME_BYTES: average P-frame size (default from bitrate and fps)
+ * - NETINT_MOCK_IDR_SCALE: IDR size as a multiple of a P-frame (default 4)
+ * - NETINT_MOCK_FAIL_SEND_EVERY: fail every Nth encode_send (default 0 = never)
+ * - NETINT_MOCK_FAIL_OPEN: make encode_open fail (default 0)
+ * - NETINT_MOCK_HANG_AFTER: the first session to deliver this many packets
+ *   stops answering, like a stuck card (default 0 = never)
+ * - NETINT_MOCK_DEVICES: devices reported to the resource manager (default 1)
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Whether NETINT_MOCK asks for the mock backend
+ */
+bool netint_mock_requested(void);
+
+/**
+ * @brief Point every p_ni_logan_* function pointer at the mock backend
+ */
+void netint_mock_install(void);
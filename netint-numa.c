@@ -0,0 +1,246 @@
+/**
+ * @file netint-numa.c
+ * @brief Keep a session's IO thread and buffers on its device's NUMA node
+ *
+ * See netint-numa.h. Linux reads the node from sysfs and pins with
+ * pthread_setaffinity_np; Windows pins with the node's group affinity but
+ * needs NETINT_NUMA_NODE, since libxcoder only gives us a PhysicalDrive name.
+ * Both kernels place anonymous pages on the node of the CPU that first
+ * writes them.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "netint-numa.h"
+
+#include <util/base.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#define NETINT_NUMA_PAGE_SIZE 4096
+
+static bool netint_numa_disabled(void)
+{
+    const char *env = getenv("NETINT_NUMA_AFFINITY");
+    return env && strcmp(env, "0") == 0;
+}
+
+/* NETINT_NUMA_NODE, or -1 if unset */
+static int netint_numa_forced_node(void)
+{
+    const char *env = getenv("NETINT_NUMA_NODE");
+    if (!env || !*env) {
+        return -1;
+    }
+    int node = atoi(env);
+    return node >= 0 ? node : -1;
+}
+
+#if defined(__linux__)
+
+static int netint_numa_read_int(const char *path, int fallback)
+{
+    FILE *f = fopen(path, "r");
+    int value = fallback;
+    if (f) {
+        if (fscanf(f, "%d", &value) != 1) {
+            value = fallback;
+        }
+        fclose(f);
+    }
+    return value;
+}
+
+/**
+ * @brief Parse /sys/devices/system/node/node<n>/cpulist ("0-15,32-47")
+ */
+static bool netint_numa_node_cpus(int node, cpu_set_t *cpus)
+{
+    char path[96];
+    char list[1024];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    bool read = fgets(list, sizeof(list), f) != NULL;
+    fclose(f);
+    if (!read) {
+        return false;
+    }
+
+    CPU_ZERO(cpus);
+    char *p = list;
+    while (*p && *p != '\n') {
+        char *end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET((int)cpu, cpus);
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return CPU_COUNT(cpus) > 0;
+}
+
+int netint_numa_device_node(const char *device_name)
+{
+    if (netint_numa_disabled()) {
+        return -1;
+    }
+    int forced = netint_numa_forced_node();
+    if (forced >= 0) {
+        return forced;
+    }
+
+    /* Nothing to gain on a single-node host */
+    FILE *second_node = fopen("/sys/devices/system/node/node1/cpulist", "r");
+    if (!second_node) {
+        return -1;
+    }
+    fclose(second_node);
+    if (!device_name || !*device_name) {
+        return -1;
+    }
+
+    const char *base = strrchr(device_name, '/');
+    base = base ? base + 1 : device_name;
+
+    /* nvme0n1 -> controller -> PCIe function; nvme0 is the controller itself */
+    static const char *const patterns[] = {
+        "/sys/block/%s/device/numa_node",
+        "/sys/block/%s/device/device/numa_node",
+        "/sys/class/nvme/%s/device/numa_node",
+    };
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        char path[256];
+        snprintf(path, sizeof(path), patterns[i], base);
+        int node = netint_numa_read_int(path, -1);
+        if (node >= 0) {
+            return node;
+        }
+    }
+    return -1;
+}
+
+bool netint_numa_bind_thread(int node)
+{
+    cpu_set_t cpus;
+    if (node < 0 || !netint_numa_node_cpus(node, &cpus)) {
+        return false;
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Could not pin thread to NUMA node %d", node);
+        return false;
+    }
+    return true;
+}
+
+bool netint_numa_run_on_node(int node, bool (*fn)(void *param), void *param)
+{
+    cpu_set_t saved;
+    bool restore = node >= 0 && pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved) == 0 &&
+                   netint_numa_bind_thread(node);
+
+    bool ret = fn(param);
+
+    if (restore) {
+        pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+    }
+    return ret;
+}
+
+#elif defined(_WIN32)
+
+int netint_numa_device_node(const char *device_name)
+{
+    UNUSED_PARAMETER(device_name);
+    if (netint_numa_disabled()) {
+        return -1;
+    }
+    return netint_numa_forced_node();
+}
+
+bool netint_numa_bind_thread(int node)
+{
+    GROUP_AFFINITY affinity;
+    memset(&affinity, 0, sizeof(affinity));
+    if (node < 0 || !GetNumaNodeProcessorMaskEx((USHORT)node, &affinity) || affinity.Mask == 0) {
+        return false;
+    }
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &affinity, NULL)) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Could not pin thread to NUMA node %d (error %lu)", node,
+             (unsigned long)GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool netint_numa_run_on_node(int node, bool (*fn)(void *param), void *param)
+{
+    GROUP_AFFINITY saved;
+    memset(&saved, 0, sizeof(saved));
+    bool restore = node >= 0 && GetThreadGroupAffinity(GetCurrentThread(), &saved) && netint_numa_bind_thread(node);
+
+    bool ret = fn(param);
+
+    if (restore) {
+        SetThreadGroupAffinity(GetCurrentThread(), &saved, NULL);
+    }
+    return ret;
+}
+
+#else
+
+int netint_numa_device_node(const char *device_name)
+{
+    UNUSED_PARAMETER(device_name);
+    return -1;
+}
+
+bool netint_numa_bind_thread(int node)
+{
+    UNUSED_PARAMETER(node);
+    return false;
+}
+
+bool netint_numa_run_on_node(int node, bool (*fn)(void *param), void *param)
+{
+    UNUSED_PARAMETER(node);
+    return fn(param);
+}
+
+#endif
+
+void netint_numa_touch(void *buffer, size_t size)
+{
+    volatile uint8_t *bytes = buffer;
+    if (!bytes) {
+        return;
+    }
+    for (size_t offset = 0; offset < size; offset += NETINT_NUMA_PAGE_SIZE) {
+        bytes[offset] = bytes[offset];
+    }
+}
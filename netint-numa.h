@@ -0,0 +1,55 @@
+/**
+ * @file netint-numa.h
+ * @brief Keep a session's IO thread and buffers on its device's NUMA node
+ *
+ * On multi-socket hosts a T4XX card hangs off one socket. If the IO thread or
+ * the frame and packet buffers live on the other one, every frame crosses the
+ * inter-socket link twice. Each session looks up the node of its device,
+ * pins its IO thread there, and allocates and first-touches its preallocated
+ * buffers from a thread running on that node, so the kernel places the pages
+ * locally.
+ *
+ * - NETINT_NUMA_AFFINITY=0 turns all of this off
+ * - NETINT_NUMA_NODE=<n> forces the node, for hosts where it can't be looked
+ *   up (the automatic lookup reads sysfs and is Linux only)
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief NUMA node of a T4XX device
+ *
+ * @param device_name Block or character device name from the resource
+ *                    manager (e.g. /dev/nvme0n1)
+ * @return Node number, or -1 if unknown, single-node, or disabled
+ */
+int netint_numa_device_node(const char *device_name);
+
+/**
+ * @brief Restrict the calling thread to the CPUs of @p node
+ *
+ * Does nothing for node < 0.
+ *
+ * @return true if the thread was pinned
+ */
+bool netint_numa_bind_thread(int node);
+
+/**
+ * @brief Call @p fn on the calling thread temporarily pinned to @p node
+ *
+ * Memory first written inside @p fn is placed on @p node. The thread's
+ * previous affinity is restored afterwards. For node < 0 this is a plain call.
+ *
+ * @return What @p fn returned
+ */
+bool netint_numa_run_on_node(int node, bool (*fn)(void *param), void *param);
+
+/**
+ * @brief Fault in every page of a fresh buffer from the calling thread
+ *
+ * Contents are left as they are.
+ */
+void netint_numa_touch(void *buffer, size_t size);
@@ -0,0 +1,481 @@
+/**
+ * @file netint-reactor.c
+ * @brief Shared IO workers for NETINT T4XX encoder sessions
+ *
+ * See netint-reactor.h. Each run queue has a mutex that guards its list and
+ * the state of every client whose home it is; a worker never holds a queue
+ * mutex while it services a client. Workers steal with trylock only, so a
+ * busy queue never makes another worker wait.
+ *
+ * Lost wakeups: a worker sleeps on its own queue's condition, after checking
+ * under that mutex that its queue has nothing due and that s_kick_seq has not
+ * moved since its scan. Kicks that want a thief bump s_kick_seq before they
+ * signal, so any sleeper either sees the new value or gets the signal. The
+ * worker is the only waiter on that condition; detach waits on round_done,
+ * so it can never consume a signal meant for the worker.
+ *
+ * A client changes home queue (netint_reactor_move) only at the end of a
+ * round, under the old queue's mutex. Everything that locks a client's home
+ * from outside a round checks after locking that it still is the home.
+ */
+
+#include "netint-reactor.h"
+#include "netint-numa.h"
+
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+    NETINT_CLIENT_DETACHED,
+    NETINT_CLIENT_IDLE,
+    NETINT_CLIENT_QUEUED,
+    NETINT_CLIENT_RUNNING,
+};
+
+struct netint_reactor_queue {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;              /**< Home worker sleep; only the worker waits on it */
+    pthread_cond_t round_done;        /**< Detach waiting for a client's round to end */
+    struct netint_reactor_client *head;
+    struct netint_reactor_client *tail;
+    bool busy;                        /**< Home worker is running a client */
+    long clients;                     /**< Attached clients that call this home */
+    volatile long numa_node;          /**< Node the home worker should run on, -1 = any */
+};
+
+struct netint_reactor_worker {
+    pthread_t thread;
+    int index;
+    uint64_t rounds;
+    uint64_t stolen;
+    long numa_node;                   /**< Node the thread is pinned to, -1 = none */
+};
+
+static struct netint_reactor_queue s_queues[NETINT_REACTOR_MAX_WORKERS];
+static struct netint_reactor_worker s_workers[NETINT_REACTOR_MAX_WORKERS];
+static int s_worker_count;
+static bool s_running;
+static volatile bool s_stop;
+static volatile long s_kick_seq;
+static volatile long s_next_queue;
+
+/* Queue mutex held */
+static void netint_reactor_enqueue(struct netint_reactor_queue *queue, struct netint_reactor_client *client,
+                                   uint64_t due_ns)
+{
+    client->state = NETINT_CLIENT_QUEUED;
+    client->due_ns = due_ns;
+    client->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = client;
+    } else {
+        queue->head = client;
+    }
+    queue->tail = client;
+}
+
+/* Queue mutex held */
+static void netint_reactor_unlink(struct netint_reactor_queue *queue, struct netint_reactor_client *client)
+{
+    struct netint_reactor_client *prev = NULL;
+    for (struct netint_reactor_client *c = queue->head; c; prev = c, c = c->next) {
+        if (c == client) {
+            if (prev) {
+                prev->next = c->next;
+            } else {
+                queue->head = c->next;
+            }
+            if (queue->tail == c) {
+                queue->tail = prev;
+            }
+            c->next = NULL;
+            return;
+        }
+    }
+}
+
+/* Queue mutex held: earliest due_ns on the queue, UINT64_MAX if empty */
+static uint64_t netint_reactor_next_due(struct netint_reactor_queue *queue)
+{
+    uint64_t next_due = UINT64_MAX;
+    for (struct netint_reactor_client *c = queue->head; c; c = c->next) {
+        if (c->due_ns < next_due) {
+            next_due = c->due_ns;
+        }
+    }
+    return next_due;
+}
+
+/**
+ * @brief Take the first due client off @p queue and mark it running
+ *
+ * @param next_due Lowered to the earliest deadline still on the queue
+ * @param steal Only try the lock
+ */
+static struct netint_reactor_client *netint_reactor_take(struct netint_reactor_queue *queue, uint64_t now_ns,
+                                                         uint64_t *next_due, bool steal)
+{
+    struct netint_reactor_client *client = NULL;
+
+    if (steal) {
+        if (pthread_mutex_trylock(&queue->mutex) != 0) {
+            return NULL;
+        }
+    } else {
+        pthread_mutex_lock(&queue->mutex);
+    }
+
+    for (struct netint_reactor_client *c = queue->head; c; c = c->next) {
+        if (c->due_ns <= now_ns) {
+            client = c;
+            break;
+        }
+    }
+    if (client) {
+        netint_reactor_unlink(queue, client);
+        client->state = NETINT_CLIENT_RUNNING;
+        client->kicked = false;
+    }
+
+    uint64_t queue_due = netint_reactor_next_due(queue);
+    if (queue_due < *next_due) {
+        *next_due = queue_due;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return client;
+}
+
+/**
+ * @brief Lock the client's home queue, following a move that races the lock
+ */
+static struct netint_reactor_queue *netint_reactor_lock_home(struct netint_reactor_client *client)
+{
+    for (;;) {
+        long queue = os_atomic_load_long(&client->queue);
+        struct netint_reactor_queue *home = &s_queues[queue];
+        pthread_mutex_lock(&home->mutex);
+        if (os_atomic_load_long(&client->queue) == queue) {
+            return home;
+        }
+        pthread_mutex_unlock(&home->mutex);
+    }
+}
+
+/* Home mutex held, client running: switch to the queue netint_reactor_move() asked for */
+static struct netint_reactor_queue *netint_reactor_rehome(struct netint_reactor_queue *home,
+                                                          struct netint_reactor_client *client)
+{
+    long target = client->move_queue;
+    int numa_node = client->move_numa_node;
+    client->move_queue = -1;
+    if (target < 0 || target == client->queue) {
+        return home;
+    }
+
+    home->clients--;
+    os_atomic_set_long(&client->queue, target);
+    pthread_mutex_unlock(&home->mutex);
+
+    /* Kicks that come in between find the new home and see the client running */
+    home = &s_queues[target];
+    pthread_mutex_lock(&home->mutex);
+    home->clients++;
+    if (numa_node >= 0 && home->numa_node < 0) {
+        os_atomic_set_long(&home->numa_node, numa_node);
+    }
+    return home;
+}
+
+static void netint_reactor_run(struct netint_reactor_client *client)
+{
+    enum netint_reactor_next next = client->service(client->param);
+    struct netint_reactor_queue *home = &s_queues[client->queue];
+
+    pthread_mutex_lock(&home->mutex);
+    if (!client->detaching) {
+        home = netint_reactor_rehome(home, client);
+    }
+    /* Checked again: a detach may have found the new home while the move had it unlocked */
+    if (client->detaching) {
+        client->state = NETINT_CLIENT_IDLE;
+        pthread_cond_broadcast(&home->round_done);
+    } else if (client->kicked || next == NETINT_REACTOR_AGAIN) {
+        netint_reactor_enqueue(home, client, 0);
+        pthread_cond_signal(&home->cond);
+    } else if (next == NETINT_REACTOR_POLL) {
+        netint_reactor_enqueue(home, client, os_gettime_ns() + client->poll_ns);
+        pthread_cond_signal(&home->cond);
+    } else {
+        client->state = NETINT_CLIENT_IDLE;
+    }
+    pthread_mutex_unlock(&home->mutex);
+}
+
+static void netint_reactor_sleep(struct netint_reactor_queue *queue, uint64_t next_due, long seq)
+{
+    pthread_mutex_lock(&queue->mutex);
+    uint64_t own_due = netint_reactor_next_due(queue);
+    if (own_due < next_due) {
+        next_due = own_due;
+    }
+
+    uint64_t now_ns = os_gettime_ns();
+    if (!os_atomic_load_bool(&s_stop) && os_atomic_load_long(&s_kick_seq) == seq && next_due > now_ns) {
+        if (next_due == UINT64_MAX) {
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+        } else {
+            uint64_t wait_ns = next_due - now_ns;
+            struct timespec deadline;
+            timespec_get(&deadline, TIME_UTC);
+            deadline.tv_sec += (time_t)(wait_ns / 1000000000ULL);
+            deadline.tv_nsec += (long)(wait_ns % 1000000000ULL);
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&queue->cond, &queue->mutex, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+static void *netint_reactor_worker_thread(void *data)
+{
+    struct netint_reactor_worker *worker = data;
+    struct netint_reactor_queue *own = &s_queues[worker->index];
+    os_set_thread_name("netint-io-reactor");
+
+    while (!os_atomic_load_bool(&s_stop)) {
+        long numa_node = os_atomic_load_long(&own->numa_node);
+        if (numa_node != worker->numa_node) {
+            worker->numa_node = numa_node;
+            if (netint_numa_bind_thread((int)numa_node)) {
+                blog(LOG_INFO, "[obs-netint-t4xx] IO reactor worker %d pinned to NUMA node %ld", worker->index,
+                     numa_node);
+            }
+        }
+
+        long seq = os_atomic_load_long(&s_kick_seq);
+        uint64_t now_ns = os_gettime_ns();
+        uint64_t next_due = UINT64_MAX;
+
+        struct netint_reactor_client *client = netint_reactor_take(own, now_ns, &next_due, false);
+        for (int k = 1; !client && k < s_worker_count; k++) {
+            client = netint_reactor_take(&s_queues[(worker->index + k) % s_worker_count], now_ns, &next_due, true);
+            if (client) {
+                worker->stolen++;
+            }
+        }
+
+        if (client) {
+            pthread_mutex_lock(&own->mutex);
+            own->busy = true;
+            pthread_mutex_unlock(&own->mutex);
+
+            netint_reactor_run(client);
+            worker->rounds++;
+
+            pthread_mutex_lock(&own->mutex);
+            own->busy = false;
+            pthread_mutex_unlock(&own->mutex);
+            continue;
+        }
+
+        netint_reactor_sleep(own, next_due, seq);
+    }
+    return NULL;
+}
+
+void netint_reactor_init(int device_count)
+{
+    const char *env = getenv("NETINT_IO_REACTOR");
+    int workers;
+
+    if (!env || !*env || strcmp(env, "0") == 0) {
+        return;
+    }
+    workers = strcmp(env, "auto") == 0 ? device_count : atoi(env);
+    if (workers < 1) {
+        workers = 1;
+    } else if (workers > NETINT_REACTOR_MAX_WORKERS) {
+        workers = NETINT_REACTOR_MAX_WORKERS;
+    }
+
+    s_stop = false;
+    for (int i = 0; i < workers; i++) {
+        memset(&s_queues[i], 0, sizeof(s_queues[i]));
+        pthread_mutex_init(&s_queues[i].mutex, NULL);
+        pthread_cond_init(&s_queues[i].cond, NULL);
+        pthread_cond_init(&s_queues[i].round_done, NULL);
+        s_queues[i].numa_node = -1;
+    }
+
+    s_worker_count = 0;
+    for (int i = 0; i < workers; i++) {
+        memset(&s_workers[i], 0, sizeof(s_workers[i]));
+        s_workers[i].index = i;
+        s_workers[i].numa_node = -1;
+        if (pthread_create(&s_workers[i].thread, NULL, netint_reactor_worker_thread, &s_workers[i]) != 0) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] IO reactor: failed to start worker %d", i);
+            break;
+        }
+        s_worker_count++;
+    }
+
+    if (s_worker_count == 0) {
+        for (int i = 0; i < workers; i++) {
+            pthread_cond_destroy(&s_queues[i].cond);
+            pthread_cond_destroy(&s_queues[i].round_done);
+            pthread_mutex_destroy(&s_queues[i].mutex);
+        }
+        blog(LOG_WARNING, "[obs-netint-t4xx] IO reactor unavailable, sessions use their own IO threads");
+        return;
+    }
+
+    /* Queues past the last started worker were never given a thread */
+    for (int i = s_worker_count; i < workers; i++) {
+        pthread_cond_destroy(&s_queues[i].cond);
+        pthread_cond_destroy(&s_queues[i].round_done);
+        pthread_mutex_destroy(&s_queues[i].mutex);
+    }
+
+    s_running = true;
+    blog(LOG_INFO, "[obs-netint-t4xx] IO reactor: %d shared worker(s) for %d device(s)", s_worker_count,
+         device_count);
+}
+
+void netint_reactor_shutdown(void)
+{
+    if (!s_running) {
+        return;
+    }
+
+    os_atomic_set_bool(&s_stop, true);
+    for (int i = 0; i < s_worker_count; i++) {
+        pthread_mutex_lock(&s_queues[i].mutex);
+        pthread_cond_broadcast(&s_queues[i].cond);
+        pthread_mutex_unlock(&s_queues[i].mutex);
+    }
+
+    for (int i = 0; i < s_worker_count; i++) {
+        pthread_join(s_workers[i].thread, NULL);
+        if (s_queues[i].clients > 0) {
+            blog(LOG_WARNING, "[obs-netint-t4xx] IO reactor: %ld session(s) still attached to worker %d at unload",
+                 s_queues[i].clients, i);
+        }
+        blog(LOG_INFO, "[obs-netint-t4xx] IO reactor worker %d: %llu rounds, %llu stolen", i,
+             (unsigned long long)s_workers[i].rounds, (unsigned long long)s_workers[i].stolen);
+        pthread_cond_destroy(&s_queues[i].cond);
+        pthread_cond_destroy(&s_queues[i].round_done);
+        pthread_mutex_destroy(&s_queues[i].mutex);
+    }
+
+    s_worker_count = 0;
+    s_running = false;
+}
+
+bool netint_reactor_enabled(void)
+{
+    return s_running;
+}
+
+bool netint_reactor_attach(struct netint_reactor_client *client, int device_slot, int numa_node, long poll_ms,
+                           netint_reactor_service_fn service, void *param)
+{
+    if (!s_running) {
+        return false;
+    }
+
+    memset(client, 0, sizeof(*client));
+    client->move_queue = -1;
+    client->service = service;
+    client->param = param;
+    client->poll_ns = (uint64_t)(poll_ms > 0 ? poll_ms : 1) * 1000000ULL;
+    client->queue = device_slot >= 0 ? device_slot % s_worker_count
+                                     : os_atomic_inc_long(&s_next_queue) % s_worker_count;
+
+    struct netint_reactor_queue *home = &s_queues[client->queue];
+    pthread_mutex_lock(&home->mutex);
+    client->state = NETINT_CLIENT_IDLE;
+    home->clients++;
+    if (numa_node >= 0 && home->numa_node < 0) {
+        os_atomic_set_long(&home->numa_node, numa_node);
+    }
+    pthread_mutex_unlock(&home->mutex);
+    return true;
+}
+
+void netint_reactor_kick(struct netint_reactor_client *client)
+{
+    struct netint_reactor_queue *home = netint_reactor_lock_home(client);
+    long queue = client->queue;
+    bool busy;
+
+    if (client->state == NETINT_CLIENT_IDLE) {
+        netint_reactor_enqueue(home, client, 0);
+    } else if (client->state == NETINT_CLIENT_QUEUED) {
+        client->due_ns = 0;
+    } else if (client->state == NETINT_CLIENT_RUNNING) {
+        client->kicked = true;
+    }
+    busy = home->busy && client->state == NETINT_CLIENT_QUEUED;
+    pthread_cond_signal(&home->cond);
+    pthread_mutex_unlock(&home->mutex);
+
+    /* The home worker is occupied: let an idle one steal the client */
+    if (busy && s_worker_count > 1) {
+        os_atomic_inc_long(&s_kick_seq);
+        for (int i = 0; i < s_worker_count; i++) {
+            if (i == queue) {
+                continue;
+            }
+            pthread_mutex_lock(&s_queues[i].mutex);
+            pthread_cond_signal(&s_queues[i].cond);
+            pthread_mutex_unlock(&s_queues[i].mutex);
+        }
+    }
+}
+
+void netint_reactor_move(struct netint_reactor_client *client, int device_slot, int numa_node)
+{
+    if (!client->service || device_slot < 0) {
+        return;
+    }
+
+    struct netint_reactor_queue *home = netint_reactor_lock_home(client);
+    if (client->state != NETINT_CLIENT_DETACHED) {
+        client->move_queue = device_slot % s_worker_count;
+        client->move_numa_node = numa_node;
+    }
+    pthread_mutex_unlock(&home->mutex);
+}
+
+void netint_reactor_detach(struct netint_reactor_client *client)
+{
+    struct netint_reactor_queue *home;
+
+    if (!client->service) {
+        return;
+    }
+
+    /* A round moves the client only while detaching is unset, so the home
+     * stays put from here on */
+    home = netint_reactor_lock_home(client);
+    if (client->state == NETINT_CLIENT_QUEUED) {
+        netint_reactor_unlink(home, client);
+    }
+    client->detaching = true;
+    while (client->state == NETINT_CLIENT_RUNNING) {
+        pthread_cond_wait(&home->round_done, &home->mutex);
+    }
+    client->state = NETINT_CLIENT_DETACHED;
+    home->clients--;
+    pthread_mutex_unlock(&home->mutex);
+
+    client->service = NULL;
+}
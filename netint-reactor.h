@@ -0,0 +1,113 @@
+/**
+ * @file netint-reactor.h
+ * @brief Shared IO workers for NETINT T4XX encoder sessions
+ *
+ * By default every encoder session runs its own IO thread, which sleeps on
+ * its job ring and wakes every NETINT_IO_POLL_INTERVAL_MS while frames are in
+ * the card. With NETINT_IO_REACTOR set in the environment, sessions instead
+ * register with a small pool of workers:
+ *
+ * - NETINT_IO_REACTOR=auto: one worker per discovered device (die)
+ * - NETINT_IO_REACTOR=<n>: n workers
+ *
+ * Each worker owns a run queue, and a session is queued on the worker of
+ * its device. A session is queued when it is kicked (a frame job arrived) or
+ * when its poll deadline comes up, and a worker runs one non-blocking service
+ * round for it. An idle worker steals due sessions from the other queues, so
+ * one busy die doesn't hold back sessions whose worker is occupied.
+ * A worker runs on the NUMA node of the first session that names one for
+ * its queue (netint-numa.h).
+ *
+ * Service callbacks must never block: they send what is queued, collect what
+ * is ready and say when they want to run again.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NETINT_REACTOR_MAX_WORKERS 16
+
+/**
+ * @brief What a service round asks for next
+ */
+enum netint_reactor_next {
+    NETINT_REACTOR_IDLE,              /**< Nothing to do until the next kick */
+    NETINT_REACTOR_POLL,              /**< Run again after the poll interval */
+    NETINT_REACTOR_AGAIN,             /**< More work is ready, run again right away */
+};
+
+typedef enum netint_reactor_next (*netint_reactor_service_fn)(void *param);
+
+/**
+ * @brief A session registered with the reactor (embedded in the session)
+ *
+ * All fields are owned by the reactor once attached.
+ */
+struct netint_reactor_client {
+    netint_reactor_service_fn service;
+    void *param;
+    uint64_t poll_ns;                 /**< Delay for NETINT_REACTOR_POLL */
+    volatile long queue;              /**< Home run queue; changes only at the end of a round */
+    int state;                        /**< Guarded by the home queue's mutex */
+    long move_queue;                  /**< Home queue to switch to after the round, -1 = stay */
+    int move_numa_node;               /**< NUMA node that goes with move_queue */
+    bool kicked;                      /**< Kicked while running */
+    bool detaching;                   /**< netint_reactor_detach() is waiting for the round to end */
+    uint64_t due_ns;                  /**< When a queued client may run */
+    struct netint_reactor_client *next;
+};
+
+/**
+ * @brief Start the workers if NETINT_IO_REACTOR asks for them (obs_module_load)
+ *
+ * @param device_count Devices discovered, used for "auto"
+ */
+void netint_reactor_init(int device_count);
+
+/**
+ * @brief Stop the workers (obs_module_unload, after every session detached)
+ */
+void netint_reactor_shutdown(void);
+
+/**
+ * @brief true if sessions should attach instead of starting their own IO thread
+ */
+bool netint_reactor_enabled(void);
+
+/**
+ * @brief Register a session
+ *
+ * @param device_slot Device registry slot of the session (-1 = none); picks
+ *                    the home queue
+ * @param numa_node NUMA node of the device (-1 = unknown)
+ * @param poll_ms Poll interval for NETINT_REACTOR_POLL
+ * @return false if the reactor isn't running; the caller starts its own thread
+ */
+bool netint_reactor_attach(struct netint_reactor_client *client, int device_slot, int numa_node, long poll_ms,
+                           netint_reactor_service_fn service, void *param);
+
+/**
+ * @brief Have the client serviced as soon as a worker is free (any thread)
+ */
+void netint_reactor_kick(struct netint_reactor_client *client);
+
+/**
+ * @brief Give the client the home queue of another device (any thread)
+ *
+ * Takes effect when the client's current or next round ends, so a worker
+ * never loses a client it is servicing; kick the client afterwards if it
+ * may be idle.
+ *
+ * @param device_slot Device registry slot the session moved to
+ * @param numa_node NUMA node of that device (-1 = unknown)
+ */
+void netint_reactor_move(struct netint_reactor_client *client, int device_slot, int numa_node);
+
+/**
+ * @brief Unregister a session, waiting for a round that is running to finish
+ *
+ * The service callback is never called again afterwards.
+ */
+void netint_reactor_detach(struct netint_reactor_client *client);
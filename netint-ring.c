@@ -0,0 +1,150 @@
+/**
+ * @file netint-ring.c
+ * @brief Bounded single-producer/single-consumer ring for NETINT T4XX queues
+ *
+ * See netint-ring.h for the threading contract. Indices only ever grow; the
+ * slot is index & mask, and tail - head is the number of queued entries.
+ * os_atomic_* accesses are sequentially consistent, which is what orders the
+ * slot write before the tail store (and the slot read before the head store),
+ * and what makes the waiter handshake in netint_ring_wait() race-free.
+ */
+
+#include "netint-ring.h"
+
+#include <util/bmem.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+bool netint_ring_init(struct netint_ring *ring, long min_capacity)
+{
+    long capacity = 1;
+
+    if (!ring) {
+        return false;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+
+    while (capacity < min_capacity) {
+        capacity <<= 1;
+    }
+
+    ring->slots = bzalloc(sizeof(*ring->slots) * (size_t)capacity);
+    if (!ring->slots) {
+        return false;
+    }
+
+    if (pthread_mutex_init(&ring->wait_mutex, NULL) != 0) {
+        goto fail;
+    }
+    if (pthread_cond_init(&ring->wait_cond, NULL) != 0) {
+        pthread_mutex_destroy(&ring->wait_mutex);
+        goto fail;
+    }
+
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    ring->initialized = true;
+    return true;
+
+fail:
+    bfree(ring->slots);
+    ring->slots = NULL;
+    return false;
+}
+
+void netint_ring_free(struct netint_ring *ring)
+{
+    if (!ring || !ring->initialized) {
+        return;
+    }
+
+    pthread_cond_destroy(&ring->wait_cond);
+    pthread_mutex_destroy(&ring->wait_mutex);
+    bfree(ring->slots);
+    ring->slots = NULL;
+    ring->capacity = 0;
+    ring->mask = 0;
+    ring->initialized = false;
+}
+
+bool netint_ring_push(struct netint_ring *ring, void *item)
+{
+    long tail = os_atomic_load_long(&ring->tail);
+
+    if (tail - os_atomic_load_long(&ring->head) >= ring->capacity) {
+        return false;
+    }
+
+    ring->slots[tail & ring->mask] = item;
+    os_atomic_store_long(&ring->tail, tail + 1);
+    netint_ring_wake(ring);
+    return true;
+}
+
+void *netint_ring_pop(struct netint_ring *ring)
+{
+    long head = os_atomic_load_long(&ring->head);
+
+    if (head == os_atomic_load_long(&ring->tail)) {
+        return NULL;
+    }
+
+    void *item = ring->slots[head & ring->mask];
+    ring->slots[head & ring->mask] = NULL;
+    os_atomic_store_long(&ring->head, head + 1);
+    netint_ring_wake(ring);
+    return item;
+}
+
+long netint_ring_count(struct netint_ring *ring)
+{
+    return os_atomic_load_long(&ring->tail) - os_atomic_load_long(&ring->head);
+}
+
+bool netint_ring_wait(struct netint_ring *ring, netint_ring_ready_fn ready, void *param, long timeout_ms)
+{
+    struct timespec deadline;
+    bool is_ready = ready(param);
+
+    if (is_ready || timeout_ms == 0) {
+        return is_ready;
+    }
+
+    if (timeout_ms > 0) {
+        timespec_get(&deadline, TIME_UTC);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    /* Register before re-checking: a waker that misses the increment must
+     * have published its state change before our check below */
+    os_atomic_inc_long(&ring->waiters);
+    pthread_mutex_lock(&ring->wait_mutex);
+    while (!(is_ready = ready(param))) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&ring->wait_cond, &ring->wait_mutex);
+        } else if (pthread_cond_timedwait(&ring->wait_cond, &ring->wait_mutex, &deadline) == ETIMEDOUT) {
+            is_ready = ready(param);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&ring->wait_mutex);
+    os_atomic_dec_long(&ring->waiters);
+
+    return is_ready;
+}
+
+void netint_ring_wake(struct netint_ring *ring)
+{
+    if (os_atomic_load_long(&ring->waiters) > 0) {
+        pthread_mutex_lock(&ring->wait_mutex);
+        pthread_cond_broadcast(&ring->wait_cond);
+        pthread_mutex_unlock(&ring->wait_mutex);
+    }
+}
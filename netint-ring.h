@@ -0,0 +1,105 @@
+/**
+ * @file netint-ring.h
+ * @brief Bounded single-producer/single-consumer ring for NETINT T4XX queues
+ *
+ * Each encoder session moves work in two directions between exactly two
+ * threads: frame jobs go from the OBS encode thread to the IO thread, and
+ * encoded packets come back the other way. With one producer and one consumer
+ * per ring, push and pop only need atomic loads/stores of the head and tail
+ * indices, so neither side takes a lock on the hot path.
+ *
+ * Blocking is opt-in via netint_ring_wait(). A thread that has to wait (ring
+ * full or empty, or some condition owned by the caller) registers itself as a
+ * waiter and sleeps on a condition variable. Push, pop and netint_ring_wake()
+ * only touch that mutex when a waiter is registered, so a pipeline that keeps
+ * up makes no futex calls.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <util/threading.h>
+
+#define NETINT_RING_CACHELINE 64
+
+/**
+ * @brief SPSC ring of pointers
+ *
+ * head is written only by the consumer and tail only by the producer; they
+ * sit on separate cache lines so the two threads don't bounce one line.
+ */
+struct netint_ring {
+    void **slots;                 /**< capacity entries (power of two) */
+    long capacity;
+    long mask;                    /**< capacity - 1 */
+    bool initialized;
+
+    char pad0[NETINT_RING_CACHELINE];
+    volatile long head;           /**< Next slot to pop (consumer) */
+    char pad1[NETINT_RING_CACHELINE - sizeof(long)];
+    volatile long tail;           /**< Next slot to push (producer) */
+    char pad2[NETINT_RING_CACHELINE - sizeof(long)];
+
+    volatile long waiters;        /**< Threads sleeping in netint_ring_wait() */
+    pthread_mutex_t wait_mutex;
+    pthread_cond_t wait_cond;
+};
+
+/**
+ * @brief Condition checked by netint_ring_wait()
+ *
+ * Called without any lock held; must only read state published with atomics
+ * (the ring indices or caller-owned os_atomic_* fields).
+ */
+typedef bool (*netint_ring_ready_fn)(void *param);
+
+/**
+ * @brief Initialize a ring
+ *
+ * @param min_capacity Minimum number of entries (rounded up to a power of two)
+ * @return false on allocation or pthread init failure (ring left unusable)
+ */
+bool netint_ring_init(struct netint_ring *ring, long min_capacity);
+
+/**
+ * @brief Free the ring storage (entries still queued are NOT freed)
+ *
+ * Both threads must be done with the ring.
+ */
+void netint_ring_free(struct netint_ring *ring);
+
+/**
+ * @brief Append an entry (producer only, never blocks)
+ *
+ * @return false if the ring is full
+ */
+bool netint_ring_push(struct netint_ring *ring, void *item);
+
+/**
+ * @brief Take the oldest entry (consumer only, never blocks)
+ *
+ * @return Entry, or NULL if the ring is empty
+ */
+void *netint_ring_pop(struct netint_ring *ring);
+
+/**
+ * @brief Number of queued entries (exact for either endpoint, a snapshot otherwise)
+ */
+long netint_ring_count(struct netint_ring *ring);
+
+/**
+ * @brief Sleep until @p ready returns true, netint_ring_wake() or a push/pop
+ *        re-evaluates it, or the timeout expires
+ *
+ * @param timeout_ms 0 = check once, negative = no timeout
+ * @return Result of the last @p ready check
+ */
+bool netint_ring_wait(struct netint_ring *ring, netint_ring_ready_fn ready, void *param, long timeout_ms);
+
+/**
+ * @brief Wake threads sleeping in netint_ring_wait() so they re-check their condition
+ *
+ * Call after publishing a state change (with an atomic) that a waiter's
+ * @c ready function depends on. Costs one atomic load when nobody waits.
+ */
+void netint_ring_wake(struct netint_ring *ring);
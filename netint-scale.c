@@ -0,0 +1,206 @@
+/**
+ * @file netint-scale.c
+ * @brief Host-side downscaler for NETINT ladder renditions
+ *
+ * See netint-scale.h. Filters are built once when a ladder opens; scaling a
+ * frame allocates nothing.
+ */
+
+#include "netint-scale.h"
+
+#include <math.h>
+#include <string.h>
+#include <util/bmem.h>
+
+#define NETINT_SCALE_BITS 14
+#define NETINT_SCALE_ONE (1 << NETINT_SCALE_BITS)
+
+static void netint_scale_filter_free(struct netint_scale_filter *filter)
+{
+    bfree(filter->start);
+    bfree(filter->weights);
+    memset(filter, 0, sizeof(*filter));
+}
+
+/**
+ * @brief Triangle filter from @p src_size to @p dst_size samples
+ *
+ * The support is one source sample around each output centre, stretched by
+ * the ratio when downscaling so every source sample contributes.
+ */
+static bool netint_scale_filter_init(struct netint_scale_filter *filter, int src_size, int dst_size)
+{
+    double scale = (double)src_size / (double)dst_size;
+    double support = scale > 1.0 ? scale : 1.0;
+    int taps = (int)ceil(support) * 2 + 1;
+    double weights[64];
+
+    memset(filter, 0, sizeof(*filter));
+    if (src_size <= 0 || dst_size <= 0 || taps > (int)(sizeof(weights) / sizeof(weights[0]))) {
+        return false;
+    }
+
+    filter->src_size = src_size;
+    filter->dst_size = dst_size;
+    filter->taps = taps;
+    filter->start = bzalloc(sizeof(int) * (size_t)dst_size);
+    filter->weights = bzalloc(sizeof(int16_t) * (size_t)dst_size * (size_t)taps);
+
+    for (int i = 0; i < dst_size; i++) {
+        double center = ((double)i + 0.5) * scale;
+        int first = (int)floor(center - support);
+        if (first < 0) {
+            first = 0;
+        }
+        if (first > src_size - taps) {
+            first = src_size - taps > 0 ? src_size - taps : 0;
+        }
+
+        double total = 0.0;
+        for (int k = 0; k < taps; k++) {
+            double w = 0.0;
+            if (first + k < src_size) {
+                double d = fabs(((double)(first + k) + 0.5 - center) / support);
+                w = d < 1.0 ? 1.0 - d : 0.0;
+            }
+            weights[k] = w;
+            total += w;
+        }
+
+        /* Round to fixed point and put the rounding error on the largest tap,
+         * so every row sums to exactly one */
+        int16_t *out = &filter->weights[(size_t)i * (size_t)taps];
+        int sum = 0;
+        int largest = 0;
+        for (int k = 0; k < taps; k++) {
+            out[k] = (int16_t)lround(total > 0.0 ? weights[k] / total * NETINT_SCALE_ONE : 0.0);
+            sum += out[k];
+            if (out[k] > out[largest]) {
+                largest = k;
+            }
+        }
+        out[largest] = (int16_t)(out[largest] + NETINT_SCALE_ONE - sum);
+        filter->start[i] = first;
+    }
+    return true;
+}
+
+bool netint_scaler_init(struct netint_scaler *scaler, int src_width, int src_height, int dst_width, int dst_height,
+                        int bytes_per_sample)
+{
+    memset(scaler, 0, sizeof(*scaler));
+    if (bytes_per_sample != 1 && bytes_per_sample != 2) {
+        return false;
+    }
+
+    scaler->src_width = src_width;
+    scaler->src_height = src_height;
+    scaler->dst_width = dst_width;
+    scaler->dst_height = dst_height;
+    scaler->bytes_per_sample = bytes_per_sample;
+
+    if (!netint_scale_filter_init(&scaler->luma_x, src_width, dst_width) ||
+        !netint_scale_filter_init(&scaler->luma_y, src_height, dst_height) ||
+        !netint_scale_filter_init(&scaler->chroma_x, src_width / 2, dst_width / 2) ||
+        !netint_scale_filter_init(&scaler->chroma_y, src_height / 2, dst_height / 2)) {
+        netint_scaler_free(scaler);
+        return false;
+    }
+
+    scaler->acc = bmalloc(sizeof(int32_t) * (size_t)src_width);
+    scaler->row = bmalloc(sizeof(uint16_t) * (size_t)src_width);
+    return true;
+}
+
+void netint_scaler_free(struct netint_scaler *scaler)
+{
+    netint_scale_filter_free(&scaler->luma_x);
+    netint_scale_filter_free(&scaler->luma_y);
+    netint_scale_filter_free(&scaler->chroma_x);
+    netint_scale_filter_free(&scaler->chroma_y);
+    bfree(scaler->acc);
+    bfree(scaler->row);
+    scaler->acc = NULL;
+    scaler->row = NULL;
+}
+
+static void netint_scale_plane(struct netint_scaler *scaler, const struct netint_scale_filter *fx,
+                               const struct netint_scale_filter *fy, uint8_t *dst, int dst_stride, int dst_rows,
+                               const uint8_t *src, int src_stride)
+{
+    const int bps = scaler->bytes_per_sample;
+    const int src_width = fx->src_size;
+    const int max_value = bps == 1 ? 255 : 1023;
+    int32_t *restrict acc = scaler->acc;
+    uint16_t *restrict row = scaler->row;
+    int visible_rows = fy->dst_size < dst_rows ? fy->dst_size : dst_rows;
+    int visible_bytes = fx->dst_size * bps;
+
+    if (visible_bytes > dst_stride) {
+        visible_bytes = dst_stride;
+    }
+
+    for (int y = 0; y < visible_rows; y++) {
+        const int16_t *wy = &fy->weights[(size_t)y * (size_t)fy->taps];
+        const uint8_t *first = src + (size_t)fy->start[y] * (size_t)src_stride;
+
+        /* Vertical: whole source rows at a time, contiguous and branch-free */
+        memset(acc, 0, sizeof(int32_t) * (size_t)src_width);
+        for (int k = 0; k < fy->taps; k++) {
+            const int32_t w = wy[k];
+            if (w == 0) {
+                continue;
+            }
+            const uint8_t *line = first + (size_t)k * (size_t)src_stride;
+            if (bps == 1) {
+                for (int x = 0; x < src_width; x++) {
+                    acc[x] += w * line[x];
+                }
+            } else {
+                const uint16_t *line16 = (const uint16_t *)line;
+                for (int x = 0; x < src_width; x++) {
+                    acc[x] += w * line16[x];
+                }
+            }
+        }
+        for (int x = 0; x < src_width; x++) {
+            row[x] = (uint16_t)((acc[x] + NETINT_SCALE_ONE / 2) >> NETINT_SCALE_BITS);
+        }
+
+        /* Horizontal: a short window of the filtered row per output sample */
+        uint8_t *out = dst + (size_t)y * (size_t)dst_stride;
+        for (int x = 0; x < visible_bytes / bps; x++) {
+            const int16_t *wx = &fx->weights[(size_t)x * (size_t)fx->taps];
+            const uint16_t *in = &row[fx->start[x]];
+            int32_t sum = 0;
+            for (int k = 0; k < fx->taps; k++) {
+                sum += wx[k] * in[k];
+            }
+            int value = (sum + NETINT_SCALE_ONE / 2) >> NETINT_SCALE_BITS;
+            if (value > max_value) {
+                value = max_value;
+            }
+            if (bps == 1) {
+                out[x] = (uint8_t)value;
+            } else {
+                ((uint16_t *)out)[x] = (uint16_t)value;
+            }
+        }
+        memset(out + visible_bytes, 0, (size_t)(dst_stride - visible_bytes));
+    }
+
+    for (int y = visible_rows; y < dst_rows; y++) {
+        memset(dst + (size_t)y * (size_t)dst_stride, 0, (size_t)dst_stride);
+    }
+}
+
+void netint_scaler_run(struct netint_scaler *scaler, uint8_t *const dst[3], const int dst_stride[3],
+                       const int dst_height[3], const uint8_t *const src[3], const int src_stride[3])
+{
+    netint_scale_plane(scaler, &scaler->luma_x, &scaler->luma_y, dst[0], dst_stride[0], dst_height[0], src[0],
+                       src_stride[0]);
+    for (int i = 1; i < 3; i++) {
+        netint_scale_plane(scaler, &scaler->chroma_x, &scaler->chroma_y, dst[i], dst_stride[i], dst_height[i],
+                           src[i], src_stride[i]);
+    }
+}
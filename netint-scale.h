@@ -0,0 +1,80 @@
+/**
+ * @file netint-scale.h
+ * @brief Host-side downscaler for NETINT ladder renditions
+ *
+ * Scales a frame that is already in the T4XX hardware layout (planar YUV
+ * 4:2:0, 8-bit or LSB-aligned 16-bit samples) straight into the hardware
+ * layout of a smaller rendition, so ladder renditions need neither an OBS
+ * scale pass nor a second upload copy.
+ *
+ * The filter is a separable triangle whose support widens with the scale
+ * ratio (bilinear when upscaling, area-like when downscaling), with 14-bit
+ * fixed-point weights computed once per scaler. The vertical pass runs over
+ * whole contiguous rows so the compiler vectorises it; the horizontal pass
+ * reads a narrow window per output sample.
+ *
+ * Like the copy kernels, every byte of each destination plane is written,
+ * padding included.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Fixed-point filter for one dimension
+ */
+struct netint_scale_filter {
+    int src_size;
+    int dst_size;
+    int taps;                          /**< Weights per output sample */
+    int *start;                        /**< First source sample per output sample */
+    int16_t *weights;                  /**< dst_size * taps, each row sums to 1 << 14 */
+};
+
+/**
+ * @brief Scaler for one source/destination size pair
+ *
+ * Each scaler owns its scratch row, so one scaler must not run on two
+ * threads at once; separate scalers can run in parallel.
+ */
+struct netint_scaler {
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+    int bytes_per_sample;              /**< 1 (8-bit) or 2 (10-bit in 16-bit words) */
+    struct netint_scale_filter luma_x;
+    struct netint_scale_filter luma_y;
+    struct netint_scale_filter chroma_x;
+    struct netint_scale_filter chroma_y;
+    int32_t *acc;                      /**< Vertical pass accumulators, one per source column */
+    uint16_t *row;                     /**< Vertically filtered source row */
+};
+
+/**
+ * @brief Build the filters for scaling @p src_width x @p src_height to
+ *        @p dst_width x @p dst_height
+ *
+ * @return false on invalid sizes or allocation failure
+ */
+bool netint_scaler_init(struct netint_scaler *scaler, int src_width, int src_height, int dst_width, int dst_height,
+                        int bytes_per_sample);
+
+/**
+ * @brief Free a scaler (safe on a zeroed or already freed scaler)
+ */
+void netint_scaler_free(struct netint_scaler *scaler);
+
+/**
+ * @brief Scale the three planes of one frame
+ *
+ * @param dst Destination planes (hardware layout)
+ * @param dst_stride Destination strides in bytes (hw_stride)
+ * @param dst_height Destination plane heights in rows (hw_height)
+ * @param src Source planes (hardware layout of the full-size frame)
+ * @param src_stride Source strides in bytes
+ */
+void netint_scaler_run(struct netint_scaler *scaler, uint8_t *const dst[3], const int dst_stride[3],
+                       const int dst_height[3], const uint8_t *const src[3], const int src_stride[3]);
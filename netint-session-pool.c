@@ -0,0 +1,535 @@
+/**
+ * @file netint-session-pool.c
+ * @brief Pre-opened encoder sessions for near-instant encoder start
+ *
+ * See netint-session-pool.h. One mutex guards the configuration list and the
+ * ready sessions; sessions are opened and closed on the pool thread, outside
+ * the lock.
+ */
+
+#include "netint-session-pool.h"
+#include "netint-encoder.h"
+
+#include <obs.h>
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** How long the pool leaves a configuration alone after failing to open it */
+#define NETINT_SESSION_POOL_RETRY_SEC 30
+#define NETINT_SESSION_POOL_IDLE_MS 5000
+/** Recycled sessions nobody warms on purpose are closed after this long */
+#define NETINT_SESSION_RECYCLE_IDLE_SEC 30
+#define NETINT_SESSION_RECYCLE_MAX 4
+
+struct netint_pool_config {
+    struct netint_session_config config;
+    uint64_t retry_after_ns;          /**< Opening failed; don't retry before this */
+};
+
+struct netint_pool_session {
+    struct netint_session_config config;
+    void *session;
+    bool restart;                     /**< Recycled after EOS, needs a fresh stream before use */
+    uint64_t expire_ns;               /**< Close when idle past this, 0 = kept warm */
+    struct netint_pool_session *next;
+};
+
+static pthread_mutex_t s_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_pool_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t s_pool_thread;
+static bool s_pool_running;
+static bool s_pool_stop;
+static int s_per_config;
+static bool s_recycle;
+
+/* Most recently used first */
+static struct netint_pool_config s_configs[NETINT_SESSION_POOL_MAX_CONFIGS];
+static int s_config_count;
+static bool s_configs_dirty;
+static struct netint_pool_session *s_ready;
+static char *s_config_path;
+
+/* The target bitrate can change on a running session, so it is not part of the key */
+static bool netint_session_config_equal(const struct netint_session_config *a, const struct netint_session_config *b)
+{
+    struct netint_session_config ka = *a;
+    struct netint_session_config kb = *b;
+    ka.bit_rate = 0;
+    kb.bit_rate = 0;
+    return memcmp(&ka, &kb, sizeof(ka)) == 0;
+}
+
+static void netint_session_config_copy_str(char *dst, size_t size, const char *src)
+{
+    memset(dst, 0, size);
+    if (src) {
+        strncpy(dst, src, size - 1);
+    }
+}
+
+static void netint_session_config_save(obs_data_t *item, const struct netint_session_config *c)
+{
+    obs_data_set_int(item, "codec_type", c->codec_type);
+    obs_data_set_int(item, "width", c->width);
+    obs_data_set_int(item, "height", c->height);
+    obs_data_set_int(item, "fps_num", c->fps_num);
+    obs_data_set_int(item, "fps_den", c->fps_den);
+    obs_data_set_int(item, "bit_depth", c->bit_depth);
+    obs_data_set_int(item, "bit_rate", c->bit_rate);
+    obs_data_set_int(item, "vbv_buffer_ms", c->vbv_buffer_ms);
+    obs_data_set_int(item, "keyint_frames", c->keyint_frames);
+    obs_data_set_int(item, "qp", c->qp_value);
+    obs_data_set_int(item, "qp_min", c->qp_min);
+    obs_data_set_int(item, "qp_max", c->qp_max);
+    obs_data_set_int(item, "color_primaries", c->color_primaries);
+    obs_data_set_int(item, "color_trc", c->color_trc);
+    obs_data_set_int(item, "color_space", c->color_space);
+    obs_data_set_int(item, "color_range", c->color_range);
+    obs_data_set_bool(item, "roi_enabled", c->roi_enabled);
+    obs_data_set_bool(item, "roi_cache", c->roi_cache);
+    obs_data_set_bool(item, "lossless", c->lossless);
+    obs_data_set_bool(item, "repeat_headers", c->repeat_headers);
+    obs_data_set_string(item, "rc_mode", c->rc_mode);
+    obs_data_set_string(item, "profile", c->profile);
+    obs_data_set_string(item, "gop_preset", c->gop_preset);
+    obs_data_set_string(item, "device", c->device);
+}
+
+static bool netint_session_config_load(obs_data_t *item, struct netint_session_config *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->codec_type = (int)obs_data_get_int(item, "codec_type");
+    c->width = (int)obs_data_get_int(item, "width");
+    c->height = (int)obs_data_get_int(item, "height");
+    c->fps_num = (int)obs_data_get_int(item, "fps_num");
+    c->fps_den = (int)obs_data_get_int(item, "fps_den");
+    c->bit_depth = (int)obs_data_get_int(item, "bit_depth");
+    c->bit_rate = obs_data_get_int(item, "bit_rate");
+    c->vbv_buffer_ms = (int)obs_data_get_int(item, "vbv_buffer_ms");
+    c->keyint_frames = (int)obs_data_get_int(item, "keyint_frames");
+    c->qp_value = (int)obs_data_get_int(item, "qp");
+    c->qp_min = (int)obs_data_get_int(item, "qp_min");
+    c->qp_max = (int)obs_data_get_int(item, "qp_max");
+    c->color_primaries = (int)obs_data_get_int(item, "color_primaries");
+    c->color_trc = (int)obs_data_get_int(item, "color_trc");
+    c->color_space = (int)obs_data_get_int(item, "color_space");
+    c->color_range = (int)obs_data_get_int(item, "color_range");
+    c->roi_enabled = obs_data_get_bool(item, "roi_enabled");
+    c->roi_cache = obs_data_get_bool(item, "roi_cache");
+    c->lossless = obs_data_get_bool(item, "lossless");
+    c->repeat_headers = obs_data_get_bool(item, "repeat_headers");
+    netint_session_config_copy_str(c->rc_mode, sizeof(c->rc_mode), obs_data_get_string(item, "rc_mode"));
+    netint_session_config_copy_str(c->profile, sizeof(c->profile), obs_data_get_string(item, "profile"));
+    netint_session_config_copy_str(c->gop_preset, sizeof(c->gop_preset), obs_data_get_string(item, "gop_preset"));
+    netint_session_config_copy_str(c->device, sizeof(c->device), obs_data_get_string(item, "device"));
+
+    return (c->codec_type == 0 || c->codec_type == 1) && c->width > 0 && c->height > 0 && c->fps_num > 0 &&
+           c->fps_den > 0 && (c->bit_depth == 8 || c->bit_depth == 10);
+}
+
+static void netint_session_pool_load(void)
+{
+    if (!s_config_path) {
+        return;
+    }
+
+    obs_data_t *data = obs_data_create_from_json_file_safe(s_config_path, "bak");
+    if (!data) {
+        return;
+    }
+
+    obs_data_array_t *configs = obs_data_get_array(data, "configs");
+    size_t count = obs_data_array_count(configs);
+    for (size_t i = 0; i < count && s_config_count < NETINT_SESSION_POOL_MAX_CONFIGS; i++) {
+        obs_data_t *item = obs_data_array_item(configs, i);
+        struct netint_pool_config *slot = &s_configs[s_config_count];
+        memset(slot, 0, sizeof(*slot));
+        if (netint_session_config_load(item, &slot->config)) {
+            s_config_count++;
+        }
+        obs_data_release(item);
+    }
+    obs_data_array_release(configs);
+    obs_data_release(data);
+
+    blog(LOG_INFO, "[obs-netint-t4xx] Session pool: %d remembered configuration(s)", s_config_count);
+}
+
+/* Pool thread, called without the pool mutex */
+static void netint_session_pool_save(void)
+{
+    struct netint_session_config configs[NETINT_SESSION_POOL_MAX_CONFIGS];
+    int count;
+
+    pthread_mutex_lock(&s_pool_mutex);
+    count = s_config_count;
+    for (int i = 0; i < count; i++) {
+        configs[i] = s_configs[i].config;
+    }
+    s_configs_dirty = false;
+    pthread_mutex_unlock(&s_pool_mutex);
+
+    if (!s_config_path) {
+        return;
+    }
+
+    /* The module config directory doesn't exist until something is saved there */
+    char *dir = bstrdup(s_config_path);
+    char *slash = strrchr(dir, '/');
+    if (slash) {
+        *slash = '\0';
+        os_mkdirs(dir);
+    }
+    bfree(dir);
+
+    obs_data_t *data = obs_data_create();
+    obs_data_array_t *array = obs_data_array_create();
+    for (int i = 0; i < count; i++) {
+        obs_data_t *item = obs_data_create();
+        netint_session_config_save(item, &configs[i]);
+        obs_data_array_push_back(array, item);
+        obs_data_release(item);
+    }
+    obs_data_set_array(data, "configs", array);
+    if (!obs_data_save_json_safe(data, s_config_path, "tmp", "bak")) {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Session pool: failed to save '%s'", s_config_path);
+    }
+    obs_data_array_release(array);
+    obs_data_release(data);
+}
+
+/**
+ * @brief Pick the next thing for the pool thread to do (pool mutex held)
+ *
+ * @param stale Receives a ready session to close: its configuration was
+ *              dropped, or it was recycled and sat idle too long
+ * @param restart Receives a recycled session that needs a fresh stream
+ * @param wanted Receives a configuration that needs another warm session
+ * @return true if any was set
+ */
+static bool netint_session_pool_next(struct netint_pool_session **stale, struct netint_pool_session **restart,
+                                     struct netint_session_config *wanted)
+{
+    uint64_t now_ns = os_gettime_ns();
+
+    for (struct netint_pool_session **link = &s_ready; *link; link = &(*link)->next) {
+        bool drop;
+        if ((*link)->expire_ns) {
+            drop = now_ns >= (*link)->expire_ns;
+        } else {
+            drop = true;
+            for (int i = 0; i < s_config_count && drop; i++) {
+                drop = !netint_session_config_equal(&(*link)->config, &s_configs[i].config);
+            }
+        }
+        if (drop) {
+            *stale = *link;
+            *link = (*link)->next;
+            return true;
+        }
+    }
+
+    for (struct netint_pool_session **link = &s_ready; *link; link = &(*link)->next) {
+        if ((*link)->restart) {
+            *restart = *link;
+            *link = (*link)->next;
+            return true;
+        }
+    }
+
+    for (int i = 0; i < s_config_count; i++) {
+        if (now_ns < s_configs[i].retry_after_ns) {
+            continue;
+        }
+        int warm = 0;
+        for (struct netint_pool_session *s = s_ready; s; s = s->next) {
+            warm += netint_session_config_equal(&s->config, &s_configs[i].config) ? 1 : 0;
+        }
+        if (warm < s_per_config) {
+            *wanted = s_configs[i].config;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void *netint_session_pool_thread(void *data)
+{
+    (void)data;
+    os_set_thread_name("netint-session-pool");
+
+    pthread_mutex_lock(&s_pool_mutex);
+    while (!s_pool_stop) {
+        struct netint_pool_session *stale = NULL;
+        struct netint_pool_session *restart = NULL;
+        struct netint_session_config wanted;
+        bool dirty = s_configs_dirty;
+        bool work = netint_session_pool_next(&stale, &restart, &wanted);
+
+        if (!work && !dirty) {
+            struct timespec deadline;
+            timespec_get(&deadline, TIME_UTC);
+            deadline.tv_sec += NETINT_SESSION_POOL_IDLE_MS / 1000;
+            deadline.tv_nsec += (NETINT_SESSION_POOL_IDLE_MS % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&s_pool_cond, &s_pool_mutex, &deadline);
+            continue;
+        }
+        pthread_mutex_unlock(&s_pool_mutex);
+
+        if (dirty) {
+            netint_session_pool_save();
+        }
+
+        if (stale) {
+            netint_warm_session_close(stale->session);
+            bfree(stale);
+        } else if (restart) {
+            if (netint_warm_session_restart(restart->session, &restart->config)) {
+                pthread_mutex_lock(&s_pool_mutex);
+                restart->restart = false;
+                restart->next = s_ready;
+                s_ready = restart;
+                pthread_mutex_unlock(&s_pool_mutex);
+            } else {
+                blog(LOG_WARNING, "[obs-netint-t4xx] Session pool: recycled %dx%d session failed to restart, closing it",
+                     restart->config.width, restart->config.height);
+                netint_warm_session_close(restart->session);
+                bfree(restart);
+            }
+        } else if (work) {
+            uint64_t start_ns = os_gettime_ns();
+            void *session = netint_warm_session_open(&wanted);
+
+            pthread_mutex_lock(&s_pool_mutex);
+            if (session) {
+                struct netint_pool_session *entry = bzalloc(sizeof(*entry));
+                entry->config = wanted;
+                entry->session = session;
+                entry->next = s_ready;
+                s_ready = entry;
+                blog(LOG_INFO, "[obs-netint-t4xx] Session pool: warmed %s %dx%d session in %llu ms",
+                     wanted.codec_type == 1 ? "H.265" : "H.264", wanted.width, wanted.height,
+                     (unsigned long long)((os_gettime_ns() - start_ns) / 1000000ULL));
+            } else {
+                for (int i = 0; i < s_config_count; i++) {
+                    if (netint_session_config_equal(&s_configs[i].config, &wanted)) {
+                        s_configs[i].retry_after_ns = os_gettime_ns() + NETINT_SESSION_POOL_RETRY_SEC * 1000000000ULL;
+                    }
+                }
+                blog(LOG_WARNING, "[obs-netint-t4xx] Session pool: failed to warm %dx%d session, retrying in %d s",
+                     wanted.width, wanted.height, NETINT_SESSION_POOL_RETRY_SEC);
+            }
+            pthread_mutex_unlock(&s_pool_mutex);
+        }
+
+        pthread_mutex_lock(&s_pool_mutex);
+    }
+    pthread_mutex_unlock(&s_pool_mutex);
+    return NULL;
+}
+
+void netint_session_pool_init(const char *config_path)
+{
+    const char *env = getenv("NETINT_SESSION_POOL");
+    const char *recycle_env = getenv("NETINT_SESSION_RECYCLE");
+    int per_config = env ? atoi(env) : 0;
+    bool recycle = recycle_env && strcmp(recycle_env, "1") == 0;
+    if (per_config < 0) {
+        per_config = 0;
+    } else if (per_config > NETINT_SESSION_POOL_MAX_PER_CONFIG) {
+        per_config = NETINT_SESSION_POOL_MAX_PER_CONFIG;
+    }
+    if (per_config == 0 && !recycle) {
+        return;
+    }
+
+    s_per_config = per_config;
+    s_recycle = recycle;
+    if (per_config > 0) {
+        s_config_path = config_path ? bstrdup(config_path) : NULL;
+        netint_session_pool_load();
+    }
+
+    s_pool_stop = false;
+    if (pthread_create(&s_pool_thread, NULL, netint_session_pool_thread, NULL) == 0) {
+        s_pool_running = true;
+        if (per_config > 0) {
+            blog(LOG_INFO, "[obs-netint-t4xx] Session pool: keeping %d session(s) warm per configuration", per_config);
+        }
+    } else {
+        blog(LOG_WARNING, "[obs-netint-t4xx] Failed to start session pool thread, sessions will open on demand");
+        s_per_config = 0;
+        s_recycle = false;
+    }
+}
+
+void netint_session_pool_shutdown(void)
+{
+    if (!s_pool_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_pool_mutex);
+    s_pool_stop = true;
+    pthread_cond_signal(&s_pool_cond);
+    pthread_mutex_unlock(&s_pool_mutex);
+
+    pthread_join(s_pool_thread, NULL);
+    pthread_mutex_lock(&s_pool_mutex);
+    s_pool_running = false;
+    s_per_config = 0;
+    s_recycle = false;
+    pthread_mutex_unlock(&s_pool_mutex);
+
+    if (s_configs_dirty) {
+        netint_session_pool_save();
+    }
+
+    while (s_ready) {
+        struct netint_pool_session *entry = s_ready;
+        s_ready = entry->next;
+        netint_warm_session_close(entry->session);
+        bfree(entry);
+    }
+    s_config_count = 0;
+    bfree(s_config_path);
+    s_config_path = NULL;
+}
+
+/* Two sessions could land on the same card unless both name different devices */
+static bool netint_session_config_same_device(const struct netint_session_config *a,
+                                              const struct netint_session_config *b)
+{
+    return !a->device[0] || !b->device[0] || strcmp(a->device, b->device) == 0;
+}
+
+void *netint_session_pool_take(const struct netint_session_config *config, bool exact_bitrate)
+{
+    void *session = NULL;
+    struct netint_pool_session *evicted = NULL;
+
+    pthread_mutex_lock(&s_pool_mutex);
+    if (!s_pool_running) {
+        pthread_mutex_unlock(&s_pool_mutex);
+        return NULL;
+    }
+
+    for (struct netint_pool_session **link = &s_ready; *link; link = &(*link)->next) {
+        struct netint_pool_session *entry = *link;
+        if (!entry->restart && netint_session_config_equal(&entry->config, config) &&
+            (!exact_bitrate || entry->config.bit_rate == config->bit_rate)) {
+            *link = entry->next;
+            session = entry->session;
+            bfree(entry);
+            break;
+        }
+    }
+
+    /* Missed: recycled sessions that might share the card with the session
+     * the caller is about to open give their hardware instance up first */
+    if (!session) {
+        for (struct netint_pool_session **link = &s_ready; *link;) {
+            struct netint_pool_session *entry = *link;
+            if (entry->expire_ns && netint_session_config_same_device(&entry->config, config)) {
+                *link = entry->next;
+                entry->next = evicted;
+                evicted = entry;
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+
+    if (s_per_config > 0) {
+        /* Move the configuration to the front; the oldest one drops off when full */
+        int found = s_config_count;
+        for (int i = 0; i < s_config_count; i++) {
+            if (netint_session_config_equal(&s_configs[i].config, config)) {
+                found = i;
+                break;
+            }
+        }
+        if (found == s_config_count && s_config_count < NETINT_SESSION_POOL_MAX_CONFIGS) {
+            s_config_count++;
+        } else if (found == s_config_count) {
+            found = s_config_count - 1;
+        }
+        if (found != 0 || memcmp(&s_configs[0].config, config, sizeof(*config)) != 0) {
+            memmove(&s_configs[1], &s_configs[0], sizeof(s_configs[0]) * (size_t)found);
+            memset(&s_configs[0], 0, sizeof(s_configs[0]));
+            s_configs[0].config = *config;
+            s_configs_dirty = true;
+        }
+    }
+
+    pthread_cond_signal(&s_pool_cond);
+    pthread_mutex_unlock(&s_pool_mutex);
+
+    /* Closed here rather than on the pool thread, so the instance is free
+     * before the caller's own open */
+    while (evicted) {
+        struct netint_pool_session *entry = evicted;
+        evicted = entry->next;
+        blog(LOG_INFO, "[obs-netint-t4xx] Session pool: closing recycled %dx%d session for a different configuration",
+             entry->config.width, entry->config.height);
+        netint_warm_session_close(entry->session);
+        bfree(entry);
+    }
+    return session;
+}
+
+bool netint_session_pool_recycle(const struct netint_session_config *config, void *session)
+{
+    bool accepted = false;
+
+    pthread_mutex_lock(&s_pool_mutex);
+    if (!s_pool_running || !s_recycle) {
+        pthread_mutex_unlock(&s_pool_mutex);
+        return false;
+    }
+
+    int matching = 0;
+    int recycled = 0;
+    for (struct netint_pool_session *s = s_ready; s; s = s->next) {
+        matching += netint_session_config_equal(&s->config, config) ? 1 : 0;
+        recycled += s->expire_ns ? 1 : 0;
+    }
+
+    bool warmed = false;
+    for (int i = 0; i < s_config_count && !warmed; i++) {
+        warmed = netint_session_config_equal(&s_configs[i].config, config);
+    }
+
+    /* A configuration the pool keeps warm takes the session as one of its
+     * own; otherwise it waits a while for an output restart or settings change */
+    uint64_t expire_ns = 0;
+    if (warmed && matching < s_per_config) {
+        accepted = true;
+    } else if (recycled < NETINT_SESSION_RECYCLE_MAX) {
+        expire_ns = os_gettime_ns() + NETINT_SESSION_RECYCLE_IDLE_SEC * 1000000000ULL;
+        accepted = true;
+    }
+
+    if (accepted) {
+        struct netint_pool_session *entry = bzalloc(sizeof(*entry));
+        entry->config = *config;
+        entry->session = session;
+        entry->restart = true;
+        entry->expire_ns = expire_ns;
+        entry->next = s_ready;
+        s_ready = entry;
+        pthread_cond_signal(&s_pool_cond);
+    }
+    pthread_mutex_unlock(&s_pool_mutex);
+    return accepted;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file netint-session-pool.h
+ * @brief Pre-opened encoder sessions for near-instant encoder start
+ *
+ * Opening a T4XX session (encode_init, params_parse, encode_open, header
+ * query) takes hundreds of milliseconds, and OBS creates the encoder every
+ * time an output starts. With NETINT_SESSION_POOL=<n> in the environment, a
+ * background thread keeps up to n sessions open for each of the most
+ * recently used configurations. netint_create adopts a matching one instead
+ * of opening its own, and the pool opens a replacement in the background.
+ *
+ * The configurations are remembered in the module config directory
+ * (session-pool.json), so sessions are ready right after OBS starts, not
+ * only from the second start on.
+ *
+ * With NETINT_SESSION_RECYCLE=1, destroyed encoders feed the same pool: a
+ * session that finished its EOS handshake cleanly is recycled instead of
+ * closed, so output restarts and scene-collection switches find a session
+ * for their settings without waiting on the card. Recycled sessions nobody
+ * keeps warm are closed after a short idle period, or as soon as an encoder
+ * that might share their device misses the pool and opens its own.
+ *
+ * The target bitrate is not part of the key: it is the one parameter a
+ * running session can change, and an adopting encoder queues its own.
+ *
+ * Pooled sessions hold hardware resources and count as load for device
+ * placement, like any other open session.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "netint-libxcoder-shim.h"
+
+#define NETINT_SESSION_POOL_MAX_CONFIGS 4
+#define NETINT_SESSION_POOL_MAX_PER_CONFIG 4
+
+/**
+ * @brief Everything that is fixed when a session opens
+ *
+ * Compared with memcmp: always zero the whole struct before filling it.
+ */
+struct netint_session_config {
+    int codec_type;                   /**< 0 = H.264, 1 = H.265 */
+    int width;
+    int height;
+    int fps_num;
+    int fps_den;
+    int bit_depth;
+    int64_t bit_rate;                 /**< bps */
+    int vbv_buffer_ms;
+    int keyint_frames;
+    int qp_value;
+    int qp_min;
+    int qp_max;
+    int color_primaries;
+    int color_trc;
+    int color_space;
+    int color_range;
+    bool roi_enabled;
+    bool roi_cache;
+    bool lossless;
+    bool repeat_headers;
+    char rc_mode[16];
+    char profile[16];
+    char gop_preset[16];
+    char device[NI_LOGAN_MAX_DEVICE_NAME_LEN]; /**< Device the user picked, "" = automatic */
+};
+
+/**
+ * @brief Load the remembered configurations and start warming (obs_module_load)
+ *
+ * Starts the pool thread when NETINT_SESSION_POOL is set or recycling is on.
+ * Call after the library is loaded and devices are discovered.
+ *
+ * @param config_path session-pool.json in the module config directory, or NULL
+ */
+void netint_session_pool_init(const char *config_path);
+
+/**
+ * @brief Close every warm session and save the configurations (obs_module_unload)
+ *
+ * Call before device shutdown and before the library is closed.
+ */
+void netint_session_pool_shutdown(void);
+
+/**
+ * @brief Take a warm or recycled session for @p config, if one is ready
+ *
+ * Also records @p config as recently used, so the pool keeps (or starts
+ * keeping) sessions warm for it. On a miss, recycled sessions that could be
+ * on the same device are closed before returning, so they don't hold a
+ * hardware instance the caller's open needs.
+ *
+ * @param exact_bitrate Only match sessions opened at config->bit_rate (when
+ *                      the caller can't change the bitrate live)
+ * @return A session from netint_warm_session_open(), or NULL
+ */
+void *netint_session_pool_take(const struct netint_session_config *config, bool exact_bitrate);
+
+/**
+ * @brief Give a drained session to the pool instead of closing it
+ *
+ * The pool restarts it with netint_warm_session_restart() on its own thread.
+ *
+ * @return false if the pool doesn't want it; the caller still owns it then
+ */
+bool netint_session_pool_recycle(const struct netint_session_config *config, void *session);
@@ -0,0 +1,207 @@
+/**
+ * @file netint-telemetry.c
+ * @brief Per-session performance counters for NETINT T4XX encoders
+ *
+ * See netint-telemetry.h. Only registration, the proc handler and the
+ * periodic summary take the registry mutex; recording never does.
+ */
+
+#include "netint-telemetry.h"
+
+#include <obs.h>
+#include <util/base.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <string.h>
+
+static pthread_mutex_t s_telemetry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct netint_telemetry *s_sessions;
+
+static const char *const s_metric_names[NETINT_METRIC_COUNT] = {
+    "copy_us",
+    "queue_wait_us",
+    "hw_latency_us",
+    "pkt_queue_depth",
+};
+
+struct netint_hist_summary {
+    long count;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+};
+
+/* Percentiles resolve to the upper bound of the bucket they fall in */
+static void netint_hist_summarize(const struct netint_histogram *hist, long buckets[NETINT_HIST_BUCKETS],
+                                  struct netint_hist_summary *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    for (int i = 0; i < NETINT_HIST_BUCKETS; i++) {
+        buckets[i] = os_atomic_load_long(&hist->buckets[i]);
+        out->count += buckets[i];
+    }
+    out->max = hist->max;
+    if (out->count == 0) {
+        return;
+    }
+    out->mean = hist->sum / (uint64_t)out->count;
+
+    long p50_rank = (out->count + 1) / 2;
+    long p99_rank = out->count - out->count / 100;
+    long seen = 0;
+    bool have_p50 = false;
+    for (int i = 0; i < NETINT_HIST_BUCKETS; i++) {
+        seen += buckets[i];
+        uint64_t upper = i == 0 ? 0 : ((1ULL << i) - 1);
+        if (upper > out->max) {
+            upper = out->max;
+        }
+        if (!have_p50 && seen >= p50_rank) {
+            out->p50 = upper;
+            have_p50 = true;
+        }
+        if (seen >= p99_rank) {
+            out->p99 = upper;
+            break;
+        }
+    }
+}
+
+static void netint_telemetry_append_json(struct dstr *json, struct netint_telemetry *telemetry)
+{
+    long buckets[NETINT_HIST_BUCKETS];
+    struct netint_hist_summary summary;
+    uint64_t uptime_ns = os_gettime_ns() - telemetry->created_ns;
+
+    dstr_catf(json, "{\"name\":\"%s\",\"uptime_ms\":%llu,\"frames_in\":%ld,\"packets_out\":%ld,"
+                    "\"bytes_out\":%llu,\"errors\":%ld,\"stalls\":%ld,\"frames_dropped\":%ld,"
+                    "\"frames_skipped\":%ld,\"recoveries\":%ld",
+              telemetry->name, (unsigned long long)(uptime_ns / 1000000ULL),
+              os_atomic_load_long(&telemetry->frames_in), os_atomic_load_long(&telemetry->packets_out),
+              (unsigned long long)telemetry->bytes_out, os_atomic_load_long(&telemetry->errors),
+              os_atomic_load_long(&telemetry->stalls), os_atomic_load_long(&telemetry->frames_dropped),
+              os_atomic_load_long(&telemetry->frames_skipped), os_atomic_load_long(&telemetry->recoveries));
+
+    for (int m = 0; m < NETINT_METRIC_COUNT; m++) {
+        netint_hist_summarize(&telemetry->hist[m], buckets, &summary);
+        dstr_catf(json, ",\"%s\":{\"count\":%ld,\"mean\":%llu,\"p50\":%llu,\"p99\":%llu,\"max\":%llu,\"buckets\":[",
+                  s_metric_names[m], summary.count, (unsigned long long)summary.mean,
+                  (unsigned long long)summary.p50, (unsigned long long)summary.p99,
+                  (unsigned long long)summary.max);
+        for (int i = 0; i < NETINT_HIST_BUCKETS; i++) {
+            dstr_catf(json, i ? ",%ld" : "%ld", buckets[i]);
+        }
+        dstr_cat(json, "]}");
+    }
+
+    dstr_cat(json, "}");
+}
+
+static void netint_telemetry_proc_stats(void *data, calldata_t *cd)
+{
+    struct dstr json;
+    bool first = true;
+
+    (void)data;
+    dstr_init(&json);
+    dstr_copy(&json, "{\"sessions\":[");
+
+    pthread_mutex_lock(&s_telemetry_mutex);
+    for (struct netint_telemetry *t = s_sessions; t; t = t->next) {
+        if (!first) {
+            dstr_cat(&json, ",");
+        }
+        netint_telemetry_append_json(&json, t);
+        first = false;
+    }
+    pthread_mutex_unlock(&s_telemetry_mutex);
+
+    dstr_cat(&json, "]}");
+    calldata_set_string(cd, "json", json.array);
+    dstr_free(&json);
+}
+
+void netint_telemetry_module_init(void)
+{
+    proc_handler_t *ph = obs_get_proc_handler();
+    if (ph) {
+        proc_handler_add(ph, "void netint_t4xx_stats(out string json)", netint_telemetry_proc_stats, NULL);
+    }
+}
+
+void netint_telemetry_register(struct netint_telemetry *telemetry, const char *name)
+{
+    memset(telemetry, 0, sizeof(*telemetry));
+    strncpy(telemetry->name, name ? name : "", NETINT_TELEMETRY_NAME_LEN - 1);
+    /* Keep the name safe to embed in JSON without escaping */
+    for (char *c = telemetry->name; *c; c++) {
+        if (*c == '"' || *c == '\\' || (unsigned char)*c < 0x20) {
+            *c = '_';
+        }
+    }
+    telemetry->created_ns = os_gettime_ns();
+    telemetry->last_log_ns = telemetry->created_ns;
+    telemetry->next_log_ns = telemetry->created_ns + NETINT_TELEMETRY_LOG_INTERVAL_SEC * 1000000000ULL;
+
+    pthread_mutex_lock(&s_telemetry_mutex);
+    telemetry->next = s_sessions;
+    s_sessions = telemetry;
+    telemetry->registered = true;
+    pthread_mutex_unlock(&s_telemetry_mutex);
+}
+
+void netint_telemetry_unregister(struct netint_telemetry *telemetry)
+{
+    if (!telemetry->registered) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_telemetry_mutex);
+    for (struct netint_telemetry **link = &s_sessions; *link; link = &(*link)->next) {
+        if (*link == telemetry) {
+            *link = telemetry->next;
+            break;
+        }
+    }
+    telemetry->registered = false;
+    telemetry->next = NULL;
+    pthread_mutex_unlock(&s_telemetry_mutex);
+}
+
+void netint_telemetry_tick(struct netint_telemetry *telemetry, uint64_t now_ns)
+{
+    long buckets[NETINT_HIST_BUCKETS];
+    struct netint_hist_summary hist[NETINT_METRIC_COUNT];
+
+    if (now_ns < telemetry->next_log_ns) {
+        return;
+    }
+    telemetry->next_log_ns = now_ns + NETINT_TELEMETRY_LOG_INTERVAL_SEC * 1000000000ULL;
+
+    for (int m = 0; m < NETINT_METRIC_COUNT; m++) {
+        netint_hist_summarize(&telemetry->hist[m], buckets, &hist[m]);
+    }
+
+    long frames = os_atomic_load_long(&telemetry->frames_in);
+    uint64_t bytes = telemetry->bytes_out;
+    double elapsed_s = (double)(now_ns - telemetry->last_log_ns) / 1e9;
+    double fps = elapsed_s > 0.0 ? (double)(frames - telemetry->last_log_frames) / elapsed_s : 0.0;
+    double mbps = elapsed_s > 0.0 ? (double)(bytes - telemetry->last_log_bytes) * 8.0 / elapsed_s / 1e6 : 0.0;
+    telemetry->last_log_ns = now_ns;
+    telemetry->last_log_frames = frames;
+    telemetry->last_log_bytes = bytes;
+
+    /* Cumulative percentiles, interval rates; microseconds shown as ms */
+    blog(LOG_INFO, "[obs-netint-t4xx] Stats '%s': %.1f fps, %.2f Mbps | copy p50/p99 %.2f/%.2f ms | "
+                   "queue wait p99 %.2f ms | hw latency p50/p99 %.2f/%.2f ms | pkt queue p99 %llu | errors %ld | "
+                   "stalls %ld, dropped %ld, skipped %ld | recoveries %ld",
+         telemetry->name, fps, mbps,
+         hist[NETINT_METRIC_COPY_US].p50 / 1000.0, hist[NETINT_METRIC_COPY_US].p99 / 1000.0,
+         hist[NETINT_METRIC_QUEUE_WAIT_US].p99 / 1000.0,
+         hist[NETINT_METRIC_HW_LATENCY_US].p50 / 1000.0, hist[NETINT_METRIC_HW_LATENCY_US].p99 / 1000.0,
+         (unsigned long long)hist[NETINT_METRIC_PKT_QUEUE_DEPTH].p99, os_atomic_load_long(&telemetry->errors),
+         os_atomic_load_long(&telemetry->stalls), os_atomic_load_long(&telemetry->frames_dropped),
+         os_atomic_load_long(&telemetry->frames_skipped), os_atomic_load_long(&telemetry->recoveries));
+}
@@ -0,0 +1,114 @@
+/**
+ * @file netint-telemetry.h
+ * @brief Per-session performance counters for NETINT T4XX encoders
+ *
+ * Every encoder session carries a small block of counters and fixed-bucket
+ * histograms that tell apart the three places a frame can be held up:
+ * - the host copy into the hardware frame (OBS thread)
+ * - back-pressure while the pipeline is full (OBS thread)
+ * - the card itself, send to packet matched by PTS (IO thread)
+ * plus the depth of the packet queue waiting for OBS.
+ *
+ * Each histogram has exactly one writer thread, so recording is an atomic
+ * increment of one bucket plus plain stores to the sum and max. Readers take
+ * a snapshot without stopping the writer and may see a sample half-recorded,
+ * which monitoring tolerates.
+ *
+ * Sessions are listed in a module-wide registry that backs:
+ * - the "netint_t4xx_stats" procedure on the global proc handler, which
+ *   returns all live sessions as JSON
+ * - a summary line per session in the log every NETINT_TELEMETRY_LOG_INTERVAL_SEC
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <util/threading.h>
+
+/** Buckets per histogram: 0, then [2^(i-1), 2^i) for i >= 1, last one open-ended */
+#define NETINT_HIST_BUCKETS 24
+
+#define NETINT_TELEMETRY_NAME_LEN 64
+#define NETINT_TELEMETRY_LOG_INTERVAL_SEC 60
+
+enum netint_metric {
+    NETINT_METRIC_COPY_US,        /**< Host copy into the hardware frame */
+    NETINT_METRIC_QUEUE_WAIT_US,  /**< Time blocked on a full pipeline */
+    NETINT_METRIC_HW_LATENCY_US,  /**< encode_send to packet, matched by PTS */
+    NETINT_METRIC_PKT_QUEUE_DEPTH, /**< Packets waiting for OBS after each push */
+    NETINT_METRIC_COUNT,
+};
+
+struct netint_histogram {
+    volatile long buckets[NETINT_HIST_BUCKETS];
+    uint64_t sum;                 /**< Written by the owning thread only */
+    uint64_t max;
+};
+
+struct netint_telemetry {
+    char name[NETINT_TELEMETRY_NAME_LEN];
+    struct netint_histogram hist[NETINT_METRIC_COUNT];
+
+    volatile long frames_in;      /**< Frames handed to the IO thread */
+    volatile long packets_out;    /**< Packets delivered to OBS */
+    uint64_t bytes_out;           /**< Written by the OBS thread only */
+    volatile long errors;
+    volatile long stalls;         /**< Times the OBS thread blocked on a full pipeline */
+    volatile long frames_dropped; /**< Queued frames discarded to make room (drop_oldest) */
+    volatile long frames_skipped; /**< New frames refused on a full pipeline (skip) */
+    volatile long recoveries;     /**< Sessions reopened by the watchdog */
+
+    uint64_t created_ns;
+    uint64_t next_log_ns;         /**< IO thread */
+    uint64_t last_log_ns;
+    long last_log_frames;
+    uint64_t last_log_bytes;
+
+    bool registered;
+    struct netint_telemetry *next;
+};
+
+static inline int netint_hist_bucket(uint64_t value)
+{
+    int bucket = 0;
+    while (value && bucket < NETINT_HIST_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Record one sample (only from the histogram's writer thread)
+ */
+static inline void netint_hist_record(struct netint_histogram *hist, uint64_t value)
+{
+    os_atomic_inc_long(&hist->buckets[netint_hist_bucket(value)]);
+    hist->sum += value;
+    if (value > hist->max) {
+        hist->max = value;
+    }
+}
+
+/**
+ * @brief Register the "netint_t4xx_stats" procedure (obs_module_load)
+ */
+void netint_telemetry_module_init(void);
+
+/**
+ * @brief Reset the counters and list the session in the registry
+ */
+void netint_telemetry_register(struct netint_telemetry *telemetry, const char *name);
+
+/**
+ * @brief Remove the session from the registry (safe if never registered)
+ *
+ * After this returns, no reader touches @p telemetry any more.
+ */
+void netint_telemetry_unregister(struct netint_telemetry *telemetry);
+
+/**
+ * @brief Log the periodic summary line if it is due (IO thread)
+ */
+void netint_telemetry_tick(struct netint_telemetry *telemetry, uint64_t now_ns);
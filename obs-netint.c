@@ -21,6 +21,12 @@
 #include <obs-module.h>
 #include "netint-encoder.h"
 #include "netint-libxcoder.h"
+#include "netint-devices.h"
+#include "netint-telemetry.h"
+#include "netint-frame-cache.h"
+#include "netint-session-pool.h"
+#include "netint-reactor.h"
+#include "netint-log.h"
 
 /**
  * @brief OBS module declaration macro
@@ -110,6 +116,9 @@ bool obs_module_load(void)
         blog(LOG_INFO, "[obs-netint-t4xx] Plugin version 1.0.0 loading (OBS version unknown)");
     #endif
 
+    /* Before the library: libxcoder's log callback goes through it */
+    netint_log_init();
+
     /* Try to initialize library, but don't fail if it's not available */
     /* This allows the plugin to load even on systems without NETINT hardware/drivers */
     if (!netint_loader_init()) {
@@ -139,12 +148,26 @@ bool obs_module_load(void)
         } else {
             blog(LOG_WARNING, "[obs-netint-t4xx] ni_logan_rsrc_init function not found in library - device auto-selection disabled");
         }
+
+        /* Discover devices once here; a background thread keeps the list
+         * and loads fresh so encoders and properties never query them */
+        netint_devices_init();
     }
 
     /* Always register encoders so they can be selected even if library is missing */
     /* This ensures the encoder options appear in OBS Studio's encoder selection UI */
     /* Actual encoder creation will fail gracefully with error messages if library is missing */
+    netint_telemetry_module_init();
     netint_register_encoders();
+
+    /* NETINT_SESSION_POOL: start opening sessions for recently used settings */
+    char *pool_path = obs_module_config_path("session-pool.json");
+    netint_session_pool_init(pool_path);
+    bfree(pool_path);
+
+    /* NETINT_IO_REACTOR: shared IO workers, "auto" sizes them by device */
+    char names[NETINT_REACTOR_MAX_WORKERS][NI_LOGAN_MAX_DEVICE_NAME_LEN];
+    netint_reactor_init(netint_device_list(names, NETINT_REACTOR_MAX_WORKERS));
     return true;
 }
 
@@ -159,9 +182,24 @@ bool obs_module_load(void)
  */
 void obs_module_unload(void)
 {
+    /* Warm sessions hold device leases and libxcoder contexts */
+    netint_session_pool_shutdown();
+
+    /* Every encoder has detached by now */
+    netint_reactor_shutdown();
+
+    /* Stop the device refresh before the library it calls goes away */
+    netint_devices_shutdown();
+
+    /* Cached frame buffers were allocated by libxcoder, free them while it is loaded */
+    netint_frame_cache_shutdown();
+
     /* Close the dynamically loaded libxcoder library if it was opened */
     /* This releases the os_dlopen() handle and any associated resources */
     netint_loader_deinit();
+
+    /* Write out whatever is still queued */
+    netint_log_shutdown();
 }
 
 
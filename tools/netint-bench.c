@@ -0,0 +1,580 @@
+/**
+ * @file netint-bench.c
+ * @brief Throughput/latency benchmark for the NETINT T4XX encoder pipeline
+ *
+ * Builds the encoder sources in (ENABLE_NETINT_BENCHMARK) and drives them
+ * through the same obs_encoder_info create/encode/destroy callbacks OBS uses,
+ * without a running OBS session: libobs is started headless, each session gets
+ * its own video output for the format/size/rate, and a thread per session
+ * feeds synthetic frames at the frame rate (or as fast as the encoder takes
+ * them with --unpaced).
+ *
+ * Reports per session and in total:
+ * - frames per second and bitrate
+ * - latency from the encode call that submitted a frame to the one that
+ *   returned its packet (p50/p99/max)
+ * - process CPU time per frame and peak resident memory
+ *
+ * Runs against whatever libxcoder the loader finds, or the mock backend with
+ * --mock (same as NETINT_MOCK=1).
+ */
+
+#include <obs.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "netint-encoder.h"
+#include "netint-devices.h"
+#include "netint-telemetry.h"
+#include "netint-frame-cache.h"
+#include "netint-session-pool.h"
+#include "netint-reactor.h"
+#include "netint-log.h"
+
+#define BENCH_SOURCE_FRAMES 8           /**< Synthetic frames cycled per session */
+#define BENCH_PTS_SLOTS 1024           /**< Submit times kept for latency matching (> frames in flight) */
+#define BENCH_FLUSH_TIMEOUT_NS 3000000000ULL
+#define BENCH_RSS_SAMPLE_MS 100
+
+struct bench_options {
+    const char *codec;
+    enum video_format format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t fps_num;
+    uint32_t fps_den;
+    long long bitrate_kbps;
+    const char *gop_preset;
+    const char *device;
+    int sessions;
+    double seconds;
+    bool unpaced;
+    bool mock;
+    bool verbose;
+};
+
+struct bench_session {
+    int index;
+    const struct bench_options *opts;
+    const struct obs_encoder_info *info;
+    video_t *video;
+    obs_encoder_t *encoder;
+    void *data;
+    pthread_t thread;
+    bool thread_created;
+
+    uint8_t *planes[BENCH_SOURCE_FRAMES][MAX_AV_PLANES];
+    uint32_t linesize[MAX_AV_PLANES];
+
+    uint64_t submit_ns[BENCH_PTS_SLOTS];
+    uint32_t *latency_us;
+    size_t latency_count;
+    size_t latency_capacity;
+
+    long frames_in;
+    long packets_out;
+    long keyframes;
+    uint64_t bytes_out;
+    uint64_t elapsed_ns;
+    bool failed;
+};
+
+static volatile long s_sessions_running;
+
+/* ---------------------------------------------------------------------------
+ * Helpers
+ * ------------------------------------------------------------------------- */
+
+static void bench_log_handler(int level, const char *msg, va_list args, void *param)
+{
+    const struct bench_options *opts = param;
+    if (level > LOG_WARNING && !opts->verbose) {
+        return;
+    }
+
+    vfprintf(stderr, msg, args);
+    fputc('\n', stderr);
+}
+
+static uint64_t bench_cpu_time_ns(void)
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k = {.LowPart = kernel.dwLowDateTime, .HighPart = kernel.dwHighDateTime};
+    ULARGE_INTEGER u = {.LowPart = user.dwLowDateTime, .HighPart = user.dwHighDateTime};
+    return (k.QuadPart + u.QuadPart) * 100ULL;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+           (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+#endif
+}
+
+static int bench_compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* @p samples must be sorted */
+static uint32_t bench_percentile(uint32_t *samples, size_t count, double fraction)
+{
+    if (count == 0) {
+        return 0;
+    }
+    size_t rank = (size_t)(fraction * (double)(count - 1) + 0.5);
+    return samples[rank];
+}
+
+/* ---------------------------------------------------------------------------
+ * Sessions
+ * ------------------------------------------------------------------------- */
+
+/* A shifted diagonal gradient per frame, so the encoder sees motion */
+static void bench_make_frames(struct bench_session *s)
+{
+    const struct bench_options *o = s->opts;
+    uint32_t w = o->width;
+    uint32_t h = o->height;
+    bool nv12 = o->format == VIDEO_FORMAT_NV12;
+
+    s->linesize[0] = w;
+    s->linesize[1] = nv12 ? w : w / 2;
+    s->linesize[2] = nv12 ? 0 : w / 2;
+
+    for (int f = 0; f < BENCH_SOURCE_FRAMES; f++) {
+        uint8_t *y = bmalloc((size_t)w * h);
+        for (uint32_t row = 0; row < h; row++) {
+            for (uint32_t col = 0; col < w; col++) {
+                y[(size_t)row * w + col] = (uint8_t)(row + col + (uint32_t)f * 8);
+            }
+        }
+        s->planes[f][0] = y;
+
+        for (int p = 1; p <= (nv12 ? 1 : 2); p++) {
+            size_t size = (size_t)s->linesize[p] * (h / 2);
+            s->planes[f][p] = bmalloc(size);
+            memset(s->planes[f][p], 112 + 16 * p + f, size);
+        }
+    }
+}
+
+static void bench_free_frames(struct bench_session *s)
+{
+    for (int f = 0; f < BENCH_SOURCE_FRAMES; f++) {
+        for (int p = 0; p < MAX_AV_PLANES; p++) {
+            bfree(s->planes[f][p]);
+            s->planes[f][p] = NULL;
+        }
+    }
+}
+
+static void bench_record_packet(struct bench_session *s, const struct encoder_packet *packet)
+{
+    uint64_t now = os_gettime_ns();
+    uint64_t submitted = s->submit_ns[(uint64_t)packet->pts % BENCH_PTS_SLOTS];
+
+    s->packets_out++;
+    s->bytes_out += packet->size;
+    if (packet->keyframe) {
+        s->keyframes++;
+    }
+    if (!submitted) {
+        return;
+    }
+
+    if (s->latency_count == s->latency_capacity) {
+        s->latency_capacity = s->latency_capacity ? s->latency_capacity * 2 : 1024;
+        s->latency_us = brealloc(s->latency_us, s->latency_capacity * sizeof(*s->latency_us));
+    }
+    s->latency_us[s->latency_count++] = (uint32_t)((now - submitted) / 1000);
+}
+
+static void *bench_session_thread(void *param)
+{
+    struct bench_session *s = param;
+    const struct bench_options *o = s->opts;
+    uint64_t interval_ns = 1000000000ULL * o->fps_den / o->fps_num;
+    uint64_t start = os_gettime_ns();
+    uint64_t end = start + (uint64_t)(o->seconds * 1e9);
+    uint64_t next = start;
+    struct encoder_frame frame;
+    struct encoder_packet packet;
+    bool received;
+
+    os_set_thread_name("netint-bench");
+
+    for (int64_t pts = 0; os_gettime_ns() < end; pts++) {
+        memset(&frame, 0, sizeof(frame));
+        for (int p = 0; p < MAX_AV_PLANES; p++) {
+            frame.data[p] = s->planes[pts % BENCH_SOURCE_FRAMES][p];
+            frame.linesize[p] = s->linesize[p];
+        }
+        frame.frames = 1;
+        frame.pts = pts;
+
+        s->submit_ns[(uint64_t)pts % BENCH_PTS_SLOTS] = os_gettime_ns();
+        memset(&packet, 0, sizeof(packet));
+        received = false;
+        if (!s->info->encode(s->data, &frame, &packet, &received)) {
+            fprintf(stderr, "session %d: encode failed at frame %lld\n", s->index, (long long)pts);
+            s->failed = true;
+            break;
+        }
+        s->frames_in++;
+        if (received) {
+            bench_record_packet(s, &packet);
+        }
+
+        if (!o->unpaced) {
+            next += interval_ns;
+            os_sleepto_ns(next);
+        }
+    }
+
+    /* Drain: OBS flushes by calling encode without a frame */
+    uint64_t deadline = os_gettime_ns() + BENCH_FLUSH_TIMEOUT_NS;
+    while (!s->failed && s->packets_out < s->frames_in && os_gettime_ns() < deadline) {
+        memset(&packet, 0, sizeof(packet));
+        received = false;
+        if (!s->info->encode(s->data, NULL, &packet, &received)) {
+            break;
+        }
+        if (received) {
+            bench_record_packet(s, &packet);
+        } else {
+            os_sleep_ms(1);
+        }
+    }
+
+    s->elapsed_ns = os_gettime_ns() - start;
+    os_atomic_dec_long(&s_sessions_running);
+    return NULL;
+}
+
+static bool bench_session_create(struct bench_session *s)
+{
+    const struct bench_options *o = s->opts;
+    char name[64];
+
+    struct video_output_info voi = {
+        .name = "netint-bench",
+        .format = o->format,
+        .fps_num = o->fps_num,
+        .fps_den = o->fps_den,
+        .width = o->width,
+        .height = o->height,
+        .cache_size = 16,
+        .colorspace = VIDEO_CS_709,
+        .range = VIDEO_RANGE_PARTIAL,
+    };
+    if (video_output_open(&s->video, &voi) != VIDEO_OUTPUT_SUCCESS) {
+        fprintf(stderr, "session %d: failed to open video output\n", s->index);
+        return false;
+    }
+
+    obs_data_t *settings = obs_data_create();
+    obs_data_set_int(settings, "bitrate", o->bitrate_kbps);
+    if (o->gop_preset) {
+        obs_data_set_string(settings, "gop_preset", o->gop_preset);
+    }
+    if (o->device) {
+        obs_data_set_string(settings, "device", o->device);
+    }
+
+    snprintf(name, sizeof(name), "bench-%d", s->index);
+    s->encoder = obs_video_encoder_create(s->info->id, name, settings, NULL);
+    obs_data_release(settings);
+    if (!s->encoder) {
+        fprintf(stderr, "session %d: failed to create encoder '%s'\n", s->index, s->info->id);
+        return false;
+    }
+    obs_encoder_set_video(s->encoder, s->video);
+
+    /* Encoder settings now include the plugin's defaults */
+    settings = obs_encoder_get_settings(s->encoder);
+    s->data = s->info->create(settings, s->encoder);
+    obs_data_release(settings);
+    if (!s->data) {
+        fprintf(stderr, "session %d: encoder create failed (see log)\n", s->index);
+        return false;
+    }
+
+    bench_make_frames(s);
+    return true;
+}
+
+static void bench_session_destroy(struct bench_session *s)
+{
+    if (s->data) {
+        s->info->destroy(s->data);
+    }
+    if (s->encoder) {
+        obs_encoder_release(s->encoder);
+    }
+    if (s->video) {
+        video_output_close(s->video);
+    }
+    bench_free_frames(s);
+    bfree(s->latency_us);
+}
+
+/* ---------------------------------------------------------------------------
+ * Main
+ * ------------------------------------------------------------------------- */
+
+static void bench_usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --codec h264|hevc       (default h264)\n"
+            "  --format i420|nv12      (default nv12)\n"
+            "  --size WxH              (default 1920x1080)\n"
+            "  --fps N[/D]             (default 60)\n"
+            "  --bitrate KBPS          (default 6000)\n"
+            "  --gop simple|default    GOP preset (default: plugin default)\n"
+            "  --device NAME           device to open (default: automatic placement)\n"
+            "  --sessions N            concurrent encoders (default 1)\n"
+            "  --seconds S             run time (default 10)\n"
+            "  --unpaced               feed frames as fast as the encoder takes them\n"
+            "  --mock                  use the built-in mock backend (NETINT_MOCK=1)\n"
+            "  --verbose               show plugin info/debug logs\n",
+            argv0);
+}
+
+static bool bench_parse_args(int argc, char **argv, struct bench_options *o)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        bool takes_value = true;
+
+        if (strcmp(arg, "--unpaced") == 0) {
+            o->unpaced = true;
+            takes_value = false;
+        } else if (strcmp(arg, "--mock") == 0) {
+            o->mock = true;
+            takes_value = false;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            o->verbose = true;
+            takes_value = false;
+        } else if (!value) {
+            return false;
+        } else if (strcmp(arg, "--codec") == 0) {
+            if (strcmp(value, "h264") != 0 && strcmp(value, "hevc") != 0) {
+                return false;
+            }
+            o->codec = value;
+        } else if (strcmp(arg, "--format") == 0) {
+            if (strcmp(value, "i420") == 0) {
+                o->format = VIDEO_FORMAT_I420;
+            } else if (strcmp(value, "nv12") == 0) {
+                o->format = VIDEO_FORMAT_NV12;
+            } else {
+                return false;
+            }
+        } else if (strcmp(arg, "--size") == 0) {
+            if (sscanf(value, "%ux%u", &o->width, &o->height) != 2) {
+                return false;
+            }
+        } else if (strcmp(arg, "--fps") == 0) {
+            o->fps_den = 1;
+            if (sscanf(value, "%u/%u", &o->fps_num, &o->fps_den) < 1) {
+                return false;
+            }
+        } else if (strcmp(arg, "--bitrate") == 0) {
+            o->bitrate_kbps = atoll(value);
+        } else if (strcmp(arg, "--gop") == 0) {
+            o->gop_preset = value;
+        } else if (strcmp(arg, "--device") == 0) {
+            o->device = value;
+        } else if (strcmp(arg, "--sessions") == 0) {
+            o->sessions = atoi(value);
+        } else if (strcmp(arg, "--seconds") == 0) {
+            o->seconds = atof(value);
+        } else {
+            return false;
+        }
+
+        if (takes_value) {
+            i++;
+        }
+    }
+
+    /* 4:2:0 needs even dimensions */
+    return o->width >= 64 && o->height >= 64 && !(o->width & 1) && !(o->height & 1) && o->fps_num > 0 &&
+           o->fps_den > 0 && o->bitrate_kbps > 0 && o->sessions > 0 && o->seconds > 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    struct bench_options opts = {
+        .codec = "h264",
+        .format = VIDEO_FORMAT_NV12,
+        .width = 1920,
+        .height = 1080,
+        .fps_num = 60,
+        .fps_den = 1,
+        .bitrate_kbps = 6000,
+        .sessions = 1,
+        .seconds = 10.0,
+    };
+    int ret = 1;
+
+    if (!bench_parse_args(argc, argv, &opts)) {
+        bench_usage(argv[0]);
+        return 2;
+    }
+
+    if (opts.mock) {
+#ifdef _WIN32
+        _putenv_s("NETINT_MOCK", "1");
+#else
+        setenv("NETINT_MOCK", "1", 1);
+#endif
+    }
+
+    base_set_log_handler(bench_log_handler, &opts);
+    if (!obs_startup("en-US", NULL, NULL)) {
+        fprintf(stderr, "libobs startup failed\n");
+        return 1;
+    }
+
+    netint_log_init();
+    if (!netint_loader_init()) {
+        fprintf(stderr, "libxcoder not available (set NETINT_LIBXCODER_PATH, or use --mock)\n");
+        netint_log_shutdown();
+        obs_shutdown();
+        return 1;
+    }
+    netint_devices_init();
+    netint_telemetry_module_init();
+    netint_register_encoders();
+
+    const char *id = strcmp(opts.codec, "hevc") == 0 ? "obs_netint_t4xx_h265" : "obs_netint_t4xx_h264";
+    const struct obs_encoder_info *info = netint_find_encoder_info(id);
+    if (!info) {
+        fprintf(stderr, "encoder '%s' not registered\n", id);
+        netint_devices_shutdown();
+        netint_loader_deinit();
+        netint_log_shutdown();
+        obs_shutdown();
+        return 1;
+    }
+    netint_session_pool_init(NULL);
+    char device_names[NETINT_REACTOR_MAX_WORKERS][NI_LOGAN_MAX_DEVICE_NAME_LEN];
+    netint_reactor_init(netint_device_list(device_names, NETINT_REACTOR_MAX_WORKERS));
+    struct bench_session *sessions = bzalloc(sizeof(*sessions) * (size_t)opts.sessions);
+
+    for (int i = 0; i < opts.sessions; i++) {
+        sessions[i].index = i;
+        sessions[i].opts = &opts;
+        sessions[i].info = info;
+        if (!bench_session_create(&sessions[i])) {
+            goto fail;
+        }
+    }
+
+    printf("%d x %s %ux%u %s @ %.2f fps, %lld kbps, %.1f s%s%s\n", opts.sessions, opts.codec, opts.width,
+           opts.height, opts.format == VIDEO_FORMAT_NV12 ? "NV12" : "I420", (double)opts.fps_num / opts.fps_den,
+           opts.bitrate_kbps, opts.seconds, opts.unpaced ? ", unpaced" : "", opts.mock ? ", mock backend" : "");
+
+    uint64_t cpu_start = bench_cpu_time_ns();
+    uint64_t rss_peak = os_get_proc_resident_size();
+
+    s_sessions_running = opts.sessions;
+    for (int i = 0; i < opts.sessions; i++) {
+        if (pthread_create(&sessions[i].thread, NULL, bench_session_thread, &sessions[i]) != 0) {
+            fprintf(stderr, "session %d: failed to start thread\n", i);
+            os_atomic_dec_long(&s_sessions_running);
+            continue;
+        }
+        sessions[i].thread_created = true;
+    }
+
+    while (os_atomic_load_long(&s_sessions_running) > 0) {
+        os_sleep_ms(BENCH_RSS_SAMPLE_MS);
+        uint64_t rss = os_get_proc_resident_size();
+        if (rss > rss_peak) {
+            rss_peak = rss;
+        }
+    }
+    for (int i = 0; i < opts.sessions; i++) {
+        if (sessions[i].thread_created) {
+            pthread_join(sessions[i].thread, NULL);
+        }
+    }
+    uint64_t cpu_ns = bench_cpu_time_ns() - cpu_start;
+
+    long total_frames = 0;
+    double total_fps = 0.0;
+    double total_mbps = 0.0;
+    uint32_t worst_p99 = 0;
+    bool all_ok = true;
+
+    printf("%-8s %9s %9s %9s %9s %9s %9s %7s\n", "session", "frames", "fps", "Mbps", "p50 ms", "p99 ms", "max ms",
+           "idr");
+    for (int i = 0; i < opts.sessions; i++) {
+        struct bench_session *s = &sessions[i];
+        double elapsed_s = (double)s->elapsed_ns / 1e9;
+        double fps = elapsed_s > 0.0 ? (double)s->packets_out / elapsed_s : 0.0;
+        double mbps = elapsed_s > 0.0 ? (double)s->bytes_out * 8.0 / elapsed_s / 1e6 : 0.0;
+
+        qsort(s->latency_us, s->latency_count, sizeof(*s->latency_us), bench_compare_u32);
+        uint32_t p50 = bench_percentile(s->latency_us, s->latency_count, 0.50);
+        uint32_t p99 = bench_percentile(s->latency_us, s->latency_count, 0.99);
+        uint32_t max = s->latency_count ? s->latency_us[s->latency_count - 1] : 0;
+
+        printf("%-8d %9ld %9.1f %9.2f %9.2f %9.2f %9.2f %7ld%s\n", i, s->packets_out, fps, mbps, p50 / 1000.0,
+               p99 / 1000.0, max / 1000.0, s->keyframes, s->failed ? "  FAILED" : "");
+
+        if (s->packets_out < s->frames_in) {
+            printf("         %ld of %ld frames never came back\n", s->frames_in - s->packets_out, s->frames_in);
+        }
+        total_frames += s->packets_out;
+        total_fps += fps;
+        total_mbps += mbps;
+        if (p99 > worst_p99) {
+            worst_p99 = p99;
+        }
+        all_ok = all_ok && !s->failed && s->packets_out > 0;
+    }
+
+    printf("total: %.1f fps, %.2f Mbps, worst p99 %.2f ms, CPU %.1f us/frame, peak RSS %.1f MB\n", total_fps,
+           total_mbps, worst_p99 / 1000.0, total_frames ? (double)cpu_ns / 1000.0 / (double)total_frames : 0.0,
+           (double)rss_peak / (1024.0 * 1024.0));
+    ret = all_ok ? 0 : 1;
+
+fail:
+    for (int i = 0; i < opts.sessions; i++) {
+        bench_session_destroy(&sessions[i]);
+    }
+    bfree(sessions);
+
+    netint_session_pool_shutdown();
+    netint_reactor_shutdown();
+    netint_devices_shutdown();
+    netint_frame_cache_shutdown();
+    netint_loader_deinit();
+    netint_log_shutdown();
+    obs_shutdown();
+    return ret;
+}